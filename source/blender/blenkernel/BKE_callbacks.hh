@@ -120,6 +120,11 @@ struct bCallbackFuncStore {
   void (*func)(Main *, PointerRNA **, int num_pointers, void *arg);
   void *arg;
   short alloc;
+  /**
+   * Optional, returns false when calling #func currently has no effect, e.g. when there are no
+   * Python handlers registered for the event.
+   */
+  bool (*is_used)(void *arg) = nullptr;
 };
 
 void BKE_callback_exec(Main *bmain, PointerRNA **pointers, int num_pointers, eCbEvent evt);
@@ -129,6 +134,10 @@ void BKE_callback_exec_id_depsgraph(Main *bmain, ID *id, Depsgraph *depsgraph, e
 void BKE_callback_exec_string(Main *bmain, eCbEvent evt, const char *str);
 void BKE_callback_add(bCallbackFuncStore *funcstore, eCbEvent evt);
 void BKE_callback_remove(bCallbackFuncStore *funcstore, eCbEvent evt);
+/**
+ * Check whether executing the callbacks of the event may have any effect.
+ */
+bool BKE_callback_is_used(eCbEvent evt);
 
 void BKE_callback_global_init();
 /**
@@ -129,6 +129,22 @@ struct TrianglesCache {
   void tag_dirty();
 };
 
+/**
+ * The last triangle BVH tree built by #Mesh::bvh_corner_tris(). When only positions change, its
+ * bounds are refit instead of building the tree again. Unlike the caches, this isn't "un-shared"
+ * when positions change, so that the tree of an evaluated copy of a mesh can be reused by the
+ * next evaluated copy.
+ */
+struct CornerTrisBVHReuse {
+  Mutex mutex;
+  /** Also referenced by the cache of the mesh it was built for, if that still exists. */
+  std::shared_ptr<BVHTree> tree;
+  /** Hash of the face offsets and corner vertices the tree was built for. */
+  uint64_t topology_hash = 0;
+  /** Cost of the tree right after building it, see #BLI_bvhtree_get_surface_area_cost. */
+  float build_cost = 0.0f;
+};
+
 struct MeshGroup {
   /** Range of unique vertices in reordered mesh. */
   IndexRange unique_verts;
@@ -198,7 +214,10 @@ struct MeshRuntime {
   SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_verts;
   SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_edges;
   SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_faces;
-  SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_corner_tris;
+  SharedCache<std::shared_ptr<BVHTree>> bvh_cache_corner_tris;
+  /** Shared with copies of the mesh, replaced when the topology changes. */
+  std::shared_ptr<CornerTrisBVHReuse> bvh_corner_tris_reuse =
+      std::make_shared<CornerTrisBVHReuse>();
   SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_corner_tris_no_hidden;
   SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_loose_verts;
   SharedCache<std::unique_ptr<BVHTree, BVHTreeDeleter>> bvh_cache_loose_verts_no_hidden;
@@ -411,11 +411,19 @@ static void read_shared_array(BlendDataReader &reader,
 {
   const char *func = __func__;
   *sharing_info = BLO_read_shared(&reader, data, [&]() -> const ImplicitSharingInfo * {
+    const CPPType &cpp_type = attribute_type_to_cpp_type(AttrType(dna_attr_type));
+    if (dna_attr_type != int8_t(AttrType::String)) {
+      /* Share trivial arrays with the memory-mapped blend-file if possible. */
+      if (const ImplicitSharingInfo *mapped_sharing_info = BLO_read_data_address_mapped(
+              &reader, const_cast<const void **>(data), cpp_type.size * size))
+      {
+        return mapped_sharing_info;
+      }
+    }
     read_array_data(reader, dna_attr_type, size, data);
     if (*data == nullptr) {
       return nullptr;
     }
-    const CPPType &cpp_type = attribute_type_to_cpp_type(AttrType(dna_attr_type));
     return MEM_new<ArrayDataImplicitSharing>(func, *data, size, cpp_type);
   });
 }
@@ -9,7 +9,9 @@
 #include "DNA_meshdata_types.h"
 #include "DNA_pointcloud_types.h"
 
+#include "BLI_hash.hh"
 #include "BLI_math_geom.h"
+#include "BLI_task.hh"
 
 #include "BKE_attribute.hh"
 #include "BKE_bvhutils.hh"
@@ -17,6 +19,8 @@
 #include "BKE_mesh.hh"
 #include "BKE_pointcloud.hh"
 
+#include <xxhash.h>
+
 namespace blender::bke {
 
 /* -------------------------------------------------------------------- */
@@ -637,6 +641,88 @@ static BitVector<> loose_edges_no_hidden_mask_get(const Mesh &mesh)
   return edge_mask;
 }
 
+/**
+ * Refitting a tree is much cheaper than building it, but the bounds of its nodes can grow a lot
+ * when the mesh deforms. Rebuild once the tree is estimated to be this much slower to traverse.
+ */
+static constexpr float max_refit_cost_factor = 2.0f;
+
+static uint64_t corner_tris_topology_hash(const Mesh &mesh)
+{
+  const Span<int> face_offsets = mesh.face_offsets();
+  const Span<int> corner_verts = mesh.corner_verts();
+  return get_default_hash(XXH3_64bits(face_offsets.data(), size_t(face_offsets.size_in_bytes())),
+                          XXH3_64bits(corner_verts.data(), size_t(corner_verts.size_in_bytes())),
+                          mesh.verts_num);
+}
+
+/**
+ * Update the bounds of a tree built by #create_tree_from_tris for new positions of the same
+ * topology. The triangulation of faces may still have changed, but every triangle is in the same
+ * face as before, so the tree stays usable.
+ *
+ * \return False if the tree has to be built again instead.
+ */
+static bool refit_tris_tree(BVHTree &tree,
+                            const float build_cost,
+                            const Span<float3> positions,
+                            const Span<int> corner_verts,
+                            const Span<int3> corner_tris)
+{
+  if (BLI_bvhtree_get_len(&tree) != corner_tris.size()) {
+    return false;
+  }
+  /* Leaf nodes are only written by the update of their own triangle. */
+  threading::parallel_for(corner_tris.index_range(), 2048, [&](const IndexRange range) {
+    for (const int64_t tri : range) {
+      float co[3][3];
+      copy_v3_v3(co[0], positions[corner_verts[corner_tris[tri][0]]]);
+      copy_v3_v3(co[1], positions[corner_verts[corner_tris[tri][1]]]);
+      copy_v3_v3(co[2], positions[corner_verts[corner_tris[tri][2]]]);
+      BLI_bvhtree_update_node(&tree, int(tri), co[0], nullptr, 3);
+    }
+  });
+  BLI_bvhtree_update_tree(&tree);
+  return BLI_bvhtree_get_surface_area_cost(&tree) <= build_cost * max_refit_cost_factor;
+}
+
+/**
+ * Refit the last tree built for a mesh with the same topology, or build a new one. The last tree
+ * is only modified in place when nothing else references it anymore, otherwise it's copied first.
+ */
+static std::shared_ptr<BVHTree> reuse_or_create_tris_tree(CornerTrisBVHReuse &reuse,
+                                                          const Mesh &mesh,
+                                                          const Span<float3> positions,
+                                                          const Span<int> corner_verts,
+                                                          const Span<int3> corner_tris)
+{
+  const uint64_t topology_hash = corner_tris_topology_hash(mesh);
+  std::shared_ptr<BVHTree> tree;
+  float build_cost = 0.0f;
+  {
+    std::lock_guard lock{reuse.mutex};
+    if (reuse.topology_hash == topology_hash) {
+      tree = std::move(reuse.tree);
+      build_cost = reuse.build_cost;
+    }
+  }
+  if (tree && tree.use_count() > 1) {
+    /* Still used by another mesh, e.g. the original mesh or the previous evaluated copy. */
+    tree = std::shared_ptr<BVHTree>(BLI_bvhtree_copy(tree.get()), BVHTreeDeleter());
+  }
+  if (!tree || !refit_tris_tree(*tree, build_cost, positions, corner_verts, corner_tris)) {
+    tree = create_tree_from_tris(positions, corner_verts, corner_tris);
+    build_cost = tree ? BLI_bvhtree_get_surface_area_cost(tree.get()) : 0.0f;
+  }
+  {
+    std::lock_guard lock{reuse.mutex};
+    reuse.tree = tree;
+    reuse.topology_hash = topology_hash;
+    reuse.build_cost = build_cost;
+  }
+  return tree;
+}
+
 }  // namespace blender::bke
 
 blender::bke::BVHTreeFromMesh Mesh::bvh_loose_verts() const
@@ -772,8 +858,11 @@ blender::bke::BVHTreeFromMesh Mesh::bvh_corner_tris() const
   const Span<float3> positions = this->vert_positions();
   const Span<int> corner_verts = this->corner_verts();
   const Span<int3> corner_tris = this->corner_tris();
-  this->runtime->bvh_cache_corner_tris.ensure([&](std::unique_ptr<BVHTree, BVHTreeDeleter> &data) {
-    data = create_tree_from_tris(positions, corner_verts, corner_tris);
+  this->runtime->bvh_cache_corner_tris.ensure([&](std::shared_ptr<BVHTree> &data) {
+    /* Release the outdated tree, so that it can be refit in place if this was the last user. */
+    data.reset();
+    data = reuse_or_create_tris_tree(
+        *this->runtime->bvh_corner_tris_reuse, *this, positions, corner_verts, corner_tris);
   });
   return create_tris_tree_data(
       this->runtime->bvh_cache_corner_tris.data().get(), positions, corner_verts, corner_tris);
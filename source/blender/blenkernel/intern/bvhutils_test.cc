@@ -0,0 +1,114 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "BKE_bvhutils.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+
+#include "CLG_log.h"
+
+#include "DNA_mesh_types.h"
+
+#include "testing/testing.h"
+
+namespace blender::bke::tests {
+
+class BVHUtilsTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+};
+
+/** Grid of quads in the XY plane with one unit large faces. */
+static Mesh *create_grid_mesh(const int size)
+{
+  const int verts_x = size + 1;
+  Mesh *mesh = BKE_mesh_new_nomain(verts_x * verts_x, 0, size * size, size * size * 4);
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  for (const int y : IndexRange(verts_x)) {
+    for (const int x : IndexRange(verts_x)) {
+      positions[y * verts_x + x] = float3(x, y, 0.0f);
+    }
+  }
+  offset_indices::fill_constant_group_size(4, 0, mesh->face_offsets_for_write());
+  MutableSpan<int> corner_verts = mesh->corner_verts_for_write();
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size)) {
+      const int face = y * size + x;
+      corner_verts[face * 4 + 0] = y * verts_x + x;
+      corner_verts[face * 4 + 1] = y * verts_x + x + 1;
+      corner_verts[face * 4 + 2] = (y + 1) * verts_x + x + 1;
+      corner_verts[face * 4 + 3] = (y + 1) * verts_x + x;
+    }
+  }
+  mesh_calc_edges(*mesh, false, false);
+  return mesh;
+}
+
+/** Deform the grid into a slope, like a modifier on an evaluated copy would. */
+static void deform_grid_mesh(Mesh &mesh, const float height)
+{
+  for (float3 &position : mesh.vert_positions_for_write()) {
+    position.z = height + position.x * 0.5f;
+  }
+  mesh.tag_positions_changed();
+}
+
+static void expect_grid_hit(const Mesh &mesh, const float height)
+{
+  const BVHTreeFromMesh tree_data = mesh.bvh_corner_tris();
+  for (const float2 co : {float2(0.5f, 0.5f), float2(3.25f, 7.75f), float2(15.5f, 15.5f)}) {
+    const float3 start(co.x, co.y, 100.0f);
+    const float3 dir(0.0f, 0.0f, -1.0f);
+    BVHTreeRayHit hit;
+    hit.index = -1;
+    hit.dist = FLT_MAX;
+    BLI_bvhtree_ray_cast(
+        tree_data.tree, start, dir, 0.0f, &hit, tree_data.raycast_callback, (void *)&tree_data);
+    EXPECT_NE(hit.index, -1);
+    EXPECT_NEAR(hit.co[2], height + co.x * 0.5f, 1e-4f);
+  }
+}
+
+TEST_F(BVHUtilsTest, CornerTrisRefitEvaluatedCopies)
+{
+  Mesh *mesh = create_grid_mesh(16);
+  deform_grid_mesh(*mesh, 0.0f);
+  const BVHTree *original_tree = mesh->bvh_corner_tris().tree;
+
+  Mesh *copy_1 = BKE_mesh_copy_for_eval(*mesh);
+  deform_grid_mesh(*copy_1, 1.0f);
+  const BVHTree *tree_1 = copy_1->bvh_corner_tris().tree;
+  /* The tree of the original mesh is still in use, so it's copied before it's refit. */
+  EXPECT_NE(tree_1, original_tree);
+  expect_grid_hit(*copy_1, 1.0f);
+  expect_grid_hit(*mesh, 0.0f);
+  BKE_id_free(nullptr, copy_1);
+
+  /* Nothing else uses the tree of the previous copy anymore, so it's refit in place. */
+  Mesh *copy_2 = BKE_mesh_copy_for_eval(*mesh);
+  deform_grid_mesh(*copy_2, 2.0f);
+  EXPECT_EQ(copy_2->bvh_corner_tris().tree, tree_1);
+  expect_grid_hit(*copy_2, 2.0f);
+  expect_grid_hit(*mesh, 0.0f);
+
+  /* Changing positions of the same mesh again refits its own tree. */
+  deform_grid_mesh(*copy_2, 3.0f);
+  EXPECT_EQ(copy_2->bvh_corner_tris().tree, tree_1);
+  expect_grid_hit(*copy_2, 3.0f);
+  BKE_id_free(nullptr, copy_2);
+
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::bke::tests
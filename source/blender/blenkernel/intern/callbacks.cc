@@ -99,6 +99,19 @@ void BKE_callback_remove(bCallbackFuncStore *funcstore, eCbEvent evt)
   }
 }
 
+bool BKE_callback_is_used(const eCbEvent evt)
+{
+  ASSERT_CALLBACKS_INITIALIZED();
+
+  const ListBase *lb = &callback_slots[evt];
+  LISTBASE_FOREACH (const bCallbackFuncStore *, funcstore, lb) {
+    if (funcstore->is_used == nullptr || funcstore->is_used(funcstore->arg)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void BKE_callback_global_init()
 {
   callbacks_initialized = true;
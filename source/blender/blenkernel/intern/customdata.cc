@@ -5187,6 +5187,22 @@ static void blend_read_layer_data(BlendDataReader *reader, CustomDataLayer &laye
   }
 }
 
+/**
+ * Share the data of layers of trivial types with the memory-mapped blend-file instead of copying
+ * it, if possible. See #BLO_read_data_address_mapped.
+ */
+static const ImplicitSharingInfo *blend_read_layer_data_mapped(BlendDataReader *reader,
+                                                               CustomDataLayer &layer,
+                                                               const int count)
+{
+  const LayerTypeInfo *type_info = layerType_getInfo(eCustomDataType(layer.type));
+  if (type_info == nullptr || type_info->copy != nullptr || type_info->free != nullptr) {
+    return nullptr;
+  }
+  return BLO_read_data_address_mapped(
+      reader, const_cast<const void **>(&layer.data), int64_t(type_info->size) * count);
+}
+
 void CustomData_blend_read(BlendDataReader *reader, CustomData *data, const int count)
 {
   BLO_read_struct_array(reader, CustomDataLayer, data->totlayer, &data->layers);
@@ -5219,6 +5235,11 @@ void CustomData_blend_read(BlendDataReader *reader, CustomData *data, const int
     if (CustomData_verify_versions(data, i)) {
       layer->sharing_info = BLO_read_shared(
           reader, &layer->data, [&]() -> const ImplicitSharingInfo * {
+            if (const ImplicitSharingInfo *sharing_info = blend_read_layer_data_mapped(
+                    reader, *layer, count))
+            {
+              return sharing_info;
+            }
             blend_read_layer_data(reader, *layer, count);
             if (layer->data == nullptr) {
               return nullptr;
@@ -169,6 +169,7 @@ static void mesh_copy_data(Main *bmain,
   mesh_dst->runtime->bvh_cache_edges = mesh_src->runtime->bvh_cache_edges;
   mesh_dst->runtime->bvh_cache_faces = mesh_src->runtime->bvh_cache_faces;
   mesh_dst->runtime->bvh_cache_corner_tris = mesh_src->runtime->bvh_cache_corner_tris;
+  mesh_dst->runtime->bvh_corner_tris_reuse = mesh_src->runtime->bvh_corner_tris_reuse;
   mesh_dst->runtime->bvh_cache_corner_tris_no_hidden =
       mesh_src->runtime->bvh_cache_corner_tris_no_hidden;
   mesh_dst->runtime->bvh_cache_loose_verts = mesh_src->runtime->bvh_cache_loose_verts;
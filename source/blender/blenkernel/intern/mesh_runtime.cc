@@ -46,7 +46,11 @@ static void free_batch_cache(MeshRuntime &mesh_runtime)
   }
 }
 
-static void free_bvh_caches(MeshRuntime &mesh_runtime)
+/**
+ * Tag the BVH trees dirty after positions changed. The last triangle tree is kept, so that it can
+ * be refit (see #Mesh::bvh_corner_tris()).
+ */
+static void tag_bvh_caches_positions_changed(MeshRuntime &mesh_runtime)
 {
   mesh_runtime.bvh_cache_verts.tag_dirty();
   mesh_runtime.bvh_cache_edges.tag_dirty();
@@ -59,6 +63,14 @@ static void free_bvh_caches(MeshRuntime &mesh_runtime)
   mesh_runtime.bvh_cache_loose_edges_no_hidden.tag_dirty();
 }
 
+static void free_bvh_caches(MeshRuntime &mesh_runtime)
+{
+  tag_bvh_caches_positions_changed(mesh_runtime);
+  /* The triangle tree can't be refit after topology changes. Other meshes sharing it may still
+   * have the old topology though. */
+  mesh_runtime.bvh_corner_tris_reuse = std::make_shared<CornerTrisBVHReuse>();
+}
+
 MeshRuntime::MeshRuntime() = default;
 
 MeshRuntime::~MeshRuntime()
@@ -406,7 +418,7 @@ void Mesh::tag_positions_changed()
 
 void Mesh::tag_positions_changed_no_normals()
 {
-  free_bvh_caches(*this->runtime);
+  tag_bvh_caches_positions_changed(*this->runtime);
   this->runtime->corner_tris_cache.tag_dirty();
   this->runtime->bounds_cache.tag_dirty();
   this->runtime->shrinkwrap_boundary_cache.tag_dirty();
@@ -415,7 +427,7 @@ void Mesh::tag_positions_changed_no_normals()
 void Mesh::tag_positions_changed_uniformly()
 {
   /* The normals and triangulation didn't change, since all verts moved by the same amount. */
-  free_bvh_caches(*this->runtime);
+  tag_bvh_caches_positions_changed(*this->runtime);
   this->runtime->bounds_cache.tag_dirty();
 }
 
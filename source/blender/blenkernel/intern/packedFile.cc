@@ -989,7 +989,12 @@ void BKE_packedfile_blend_read(BlendDataReader *reader, PackedFile **pf_p, Strin
   }
   /* NOTE: this is endianness-sensitive. */
   /* NOTE: there is no way to handle endianness switch here. */
-  pf->sharing_info = BLO_read_shared(reader, &pf->data, [&]() {
+  pf->sharing_info = BLO_read_shared(reader, &pf->data, [&]() -> const ImplicitSharingInfo * {
+    if (const ImplicitSharingInfo *sharing_info = BLO_read_data_address_mapped(
+            reader, &pf->data, pf->size))
+    {
+      return sharing_info;
+    }
     BLO_read_data_address(reader, &pf->data);
     /* Do not create an implicit sharing if read data pointer is `nullptr`. */
     return pf->data ? blender::implicit_sharing::info_for_mem_free(const_cast<void *>(pf->data)) :
@@ -19,11 +19,14 @@
 #include "DNA_modifier_types.h"
 #include "DNA_object_types.h"
 
+#include "BLI_array.hh"
+#include "BLI_index_mask.hh"
 #include "BLI_math_geom.h"
 #include "BLI_math_matrix.h"
 #include "BLI_math_solvers.h"
 #include "BLI_math_vector.h"
 #include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "BKE_attribute.hh"
@@ -298,89 +301,82 @@ const ShrinkwrapBoundaryData &boundary_cache_ensure(const Mesh &mesh)
 
 }  // namespace blender::bke::shrinkwrap
 
+/**
+ * Transform the vertices with a non-zero weight to the target space, to find their nearest
+ * elements on the target in one batch.
+ *
+ * \return The vertices with a non-zero weight.
+ */
+static blender::IndexMask shrinkwrap_calc_target_positions(
+    const ShrinkwrapCalcData *calc,
+    blender::IndexMaskMemory &memory,
+    blender::MutableSpan<blender::float3> r_positions,
+    blender::MutableSpan<float> r_weights)
+{
+  using namespace blender;
+  threading::parallel_for(IndexRange(calc->numVerts), 1024, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      r_weights[i] = BKE_defvert_array_find_weight_safe(
+          calc->dvert, int(i), calc->vgroup, calc->invert_vgroup);
+      if (r_weights[i] == 0.0f) {
+        continue;
+      }
+      r_positions[i] = calc->vert_positions ? float3(calc->vert_positions[i]) :
+                                              float3(calc->vertexCos[i]);
+      BLI_space_transform_apply(&calc->local2target, r_positions[i]);
+    }
+  });
+  return IndexMask::from_predicate(IndexRange(calc->numVerts),
+                                   GrainSize(4096),
+                                   memory,
+                                   [&](const int i) { return r_weights[i] != 0.0f; });
+}
+
 /**
  * Shrink-wrap to the nearest vertex
  *
  * it builds a BVH-tree of vertices we can attach to and then
  * for each vertex performs a nearest vertex search on the tree.
  */
-static void shrinkwrap_calc_nearest_vertex_cb_ex(void *__restrict userdata,
-                                                 const int i,
-                                                 const TaskParallelTLS *__restrict tls)
+static void shrinkwrap_calc_nearest_vertex(ShrinkwrapCalcData *calc)
 {
-  ShrinkwrapCalcCBData *data = static_cast<ShrinkwrapCalcCBData *>(userdata);
-
-  ShrinkwrapCalcData *calc = data->calc;
-  blender::bke::BVHTreeFromMesh *treeData = &data->tree->treeData;
-  BVHTreeNearest *nearest = static_cast<BVHTreeNearest *>(tls->userdata_chunk);
-
-  float *co = calc->vertexCos[i];
-  float tmp_co[3];
-  float weight = BKE_defvert_array_find_weight_safe(
-      calc->dvert, i, calc->vgroup, calc->invert_vgroup);
-
-  if (weight == 0.0f) {
-    return;
-  }
-
-  /* Convert the vertex to tree coordinates */
-  if (calc->vert_positions) {
-    copy_v3_v3(tmp_co, calc->vert_positions[i]);
-  }
-  else {
-    copy_v3_v3(tmp_co, co);
-  }
-  BLI_space_transform_apply(&calc->local2target, tmp_co);
-
-  /* Use local proximity heuristics (to reduce the nearest search)
-   *
-   * If we already had an hit before.. we assume this vertex is going to have a close hit to that
-   * other vertex so we can initiate the "nearest.dist" with the expected value to that last hit.
-   * This will lead in pruning of the search tree. */
-  if (nearest->index != -1) {
-    nearest->dist_sq = len_squared_v3v3(tmp_co, nearest->co);
-  }
-  else {
-    nearest->dist_sq = FLT_MAX;
-  }
-
-  BLI_bvhtree_find_nearest(treeData->tree, tmp_co, nearest, treeData->nearest_callback, treeData);
-
-  /* Found the nearest vertex */
-  if (nearest->index != -1) {
+  using namespace blender;
+  bke::BVHTreeFromMesh *treeData = &calc->tree->treeData;
+
+  Array<float3> positions(calc->numVerts);
+  Array<float> weights(calc->numVerts);
+  IndexMaskMemory memory;
+  const IndexMask mask = shrinkwrap_calc_target_positions(calc, memory, positions, weights);
+
+  Array<BVHTreeNearest> nearest(calc->numVerts);
+  mask.foreach_index([&](const int i) {
+    nearest[i].index = -1;
+    nearest[i].dist_sq = FLT_MAX;
+  });
+  BLI_bvhtree_find_nearest_batch(
+      *treeData->tree, mask, positions, nearest, treeData->nearest_callback, treeData, true);
+
+  mask.foreach_index(GrainSize(1024), [&](const int i) {
+    /* Found the nearest vertex */
+    if (nearest[i].index == -1) {
+      return;
+    }
+    float weight = weights[i];
     /* Adjusting the vertex weight,
      * so that after interpolating it keeps a certain distance from the nearest position */
-    if (nearest->dist_sq > FLT_EPSILON) {
-      const float dist = sqrtf(nearest->dist_sq);
+    if (nearest[i].dist_sq > FLT_EPSILON) {
+      const float dist = sqrtf(nearest[i].dist_sq);
       weight *= (dist - calc->keepDist) / dist;
     }
 
     /* Convert the coordinates back to mesh coordinates */
-    copy_v3_v3(tmp_co, nearest->co);
+    float tmp_co[3];
+    copy_v3_v3(tmp_co, nearest[i].co);
     BLI_space_transform_invert(&calc->local2target, tmp_co);
 
+    float *co = calc->vertexCos[i];
     interp_v3_v3v3(co, co, tmp_co, weight); /* linear interpolation */
-  }
-}
-
-static void shrinkwrap_calc_nearest_vertex(ShrinkwrapCalcData *calc)
-{
-  BVHTreeNearest nearest = NULL_BVHTreeNearest;
-
-  /* Setup nearest */
-  nearest.index = -1;
-  nearest.dist_sq = FLT_MAX;
-
-  ShrinkwrapCalcCBData data{};
-  data.calc = calc;
-  data.tree = calc->tree;
-  TaskParallelSettings settings;
-  BLI_parallel_range_settings_defaults(&settings);
-  settings.use_threading = (calc->numVerts > 10000);
-  settings.userdata_chunk = &nearest;
-  settings.userdata_chunk_size = sizeof(nearest);
-  BLI_task_parallel_range(
-      0, calc->numVerts, &data, shrinkwrap_calc_nearest_vertex_cb_ex, &settings);
+  });
 }
 
 bool BKE_shrinkwrap_project_normal(char options,
@@ -1102,24 +1098,10 @@ static void shrinkwrap_calc_nearest_surface_point_cb_ex(void *__restrict userdat
   }
   BLI_space_transform_apply(&calc->local2target, tmp_co);
 
-  /* Use local proximity heuristics (to reduce the nearest search)
-   *
-   * If we already had an hit before.. we assume this vertex is going to have a close hit to that
-   * other vertex so we can initiate the "nearest.dist" with the expected value to that last hit.
-   * This will lead in pruning of the search tree. */
-  if (nearest->index != -1) {
-    if (calc->smd->shrinkType == MOD_SHRINKWRAP_TARGET_PROJECT) {
-      /* Heuristic doesn't work because of additional restrictions. */
-      nearest->index = -1;
-      nearest->dist_sq = FLT_MAX;
-    }
-    else {
-      nearest->dist_sq = len_squared_v3v3(tmp_co, nearest->co);
-    }
-  }
-  else {
-    nearest->dist_sq = FLT_MAX;
-  }
+  /* The distance to the previous hit can't be used to limit the search, as done by
+   * #BLI_bvhtree_find_nearest_batch for other types, because of additional restrictions. */
+  nearest->index = -1;
+  nearest->dist_sq = FLT_MAX;
 
   BKE_shrinkwrap_find_nearest_surface(data->tree, nearest, tmp_co, calc->smd->shrinkType);
 
@@ -1322,6 +1304,48 @@ void BKE_shrinkwrap_snap_point_to_surface(const ShrinkwrapTreeData *tree,
 
 static void shrinkwrap_calc_nearest_surface_point(ShrinkwrapCalcData *calc)
 {
+  using namespace blender;
+  if (calc->smd->shrinkType != MOD_SHRINKWRAP_TARGET_PROJECT) {
+    ShrinkwrapTreeData *tree = calc->tree;
+    bke::BVHTreeFromMesh *treeData = &tree->treeData;
+
+    Array<float3> positions(calc->numVerts);
+    Array<float> weights(calc->numVerts);
+    IndexMaskMemory memory;
+    const IndexMask mask = shrinkwrap_calc_target_positions(calc, memory, positions, weights);
+
+    Array<BVHTreeNearest> nearest(calc->numVerts);
+    mask.foreach_index([&](const int i) {
+      nearest[i].index = -1;
+      nearest[i].dist_sq = FLT_MAX;
+    });
+    BLI_bvhtree_find_nearest_batch(
+        *tree->bvh, mask, positions, nearest, treeData->nearest_callback, treeData, true);
+
+    mask.foreach_index(GrainSize(1024), [&](const int i) {
+      /* Found the nearest vertex */
+      if (nearest[i].index == -1) {
+        return;
+      }
+      float tmp_co[3];
+      BKE_shrinkwrap_snap_point_to_surface(tree,
+                                           nullptr,
+                                           calc->smd->shrinkMode,
+                                           nearest[i].index,
+                                           nearest[i].co,
+                                           nearest[i].no,
+                                           calc->keepDist,
+                                           positions[i],
+                                           tmp_co);
+
+      /* Convert the coordinates back to mesh coordinates */
+      BLI_space_transform_invert(&calc->local2target, tmp_co);
+      float *co = calc->vertexCos[i];
+      interp_v3_v3v3(co, co, tmp_co, weights[i]); /* linear interpolation */
+    });
+    return;
+  }
+
   BVHTreeNearest nearest = NULL_BVHTreeNearest;
 
   /* Setup nearest */
@@ -31,6 +31,8 @@
 #include "BKE_main.hh"
 #include "BKE_undo_system.hh"
 
+#include "BLO_undofile.hh"
+
 #include "RNA_access.hh"
 
 #include "MEM_guardedalloc.h"
@@ -441,6 +443,14 @@ void BKE_undosys_stack_limit_steps_and_memory(UndoStack *ustack, int steps, size
   }
 
   CLOG_DEBUG(&LOG, "Total steps %zu: data_size_all=%zu", us_count, data_size_all);
+  if (CLOG_CHECK(&LOG, CLG_LEVEL_DEBUG)) {
+    const MemFileChunkStoreStats stats = BLO_memfile_chunk_store_stats();
+    CLOG_DEBUG(&LOG,
+               "Memfile chunks: buffers=%lld, size=%zu, size_shared=%zu",
+               (long long)stats.buffers_num,
+               stats.size,
+               stats.size_shared);
+  }
 
   if (us) {
 #ifdef WITH_GLOBAL_UNDO_KEEP_ONE
@@ -1005,6 +1015,11 @@ void BKE_undosys_print(UndoStack *ustack)
            us->name);
     index++;
   }
+  const MemFileChunkStoreStats stats = BLO_memfile_chunk_store_stats();
+  printf("Memfile chunks: %lld buffers, %zu bytes, %zu bytes shared\n",
+         (long long)stats.buffers_num,
+         stats.size,
+         stats.size_shared);
 }
 
 /** \} */
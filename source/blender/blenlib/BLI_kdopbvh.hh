@@ -10,7 +10,9 @@
 
 #include "BLI_function_ref.hh"
 #include "BLI_hash.hh"
+#include "BLI_index_mask_fwd.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_struct_equality_utils.hh"
 #include "BLI_sys_types.h"
 
@@ -148,6 +150,11 @@ class BVHTreeDeleter {
  * \note many callers don't check for `NULL` return.
  */
 BVHTree *BLI_bvhtree_new(int maxsize, float epsilon, char tree_type, char axis);
+/**
+ * Duplicate a tree including its bounds, e.g. to refit it with #BLI_bvhtree_update_node without
+ * affecting users of the original tree.
+ */
+BVHTree *BLI_bvhtree_copy(const BVHTree *tree);
 
 /**
  * Construct: first insert points, then call balance.
@@ -219,6 +226,13 @@ float BLI_bvhtree_get_epsilon(const BVHTree *tree);
  * This function returns the bounding box of the BVH tree.
  */
 void BLI_bvhtree_get_bounding_box(const BVHTree *tree, float r_bb_min[3], float r_bb_max[3]);
+/**
+ * Sum of the surface areas of all branch bounds relative to the area of the root bounds. This
+ * estimates the cost of traversing the tree independent of its scale, e.g. to decide whether a
+ * tree that was refit with #BLI_bvhtree_update_tree should be rebuilt instead.
+ * Only the x, y and z axes are used, zero is returned for k-DOPs without them.
+ */
+float BLI_bvhtree_get_surface_area_cost(const BVHTree *tree);
 
 /**
  * Find nearest node to the given coordinates
@@ -342,6 +356,49 @@ inline void BLI_bvhtree_ray_cast_all_cpp(const BVHTree &tree,
       &fn);
 }
 
+/**
+ * Cast many rays, like calling #BLI_bvhtree_ray_cast_ex for every index in the mask.
+ *
+ * Rays are processed in parallel, sorted by the Morton code of their origin, so that rays which
+ * are processed after each other by a thread tend to traverse the same nodes while they are still
+ * in the cache. The callback has to be thread-safe.
+ *
+ * \param r_hits: Initialized by the caller like for a single ray, i.e. with the index set to -1
+ * and the distance set to the maximum ray length.
+ */
+void BLI_bvhtree_ray_cast_batch(const BVHTree &tree,
+                                const IndexMask &mask,
+                                Span<float3> origins,
+                                Span<float3> directions,
+                                float radius,
+                                MutableSpan<BVHTreeRayHit> r_hits,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                int flag = BVH_RAYCAST_DEFAULT);
+
+/**
+ * Find the nearest elements of many positions, like calling #BLI_bvhtree_find_nearest for every
+ * index in the mask.
+ *
+ * Positions are processed in parallel, sorted by their Morton code like in
+ * #BLI_bvhtree_ray_cast_batch. The callback has to be thread-safe.
+ *
+ * \param r_nearest: Initialized by the caller like for a single position, i.e. with the index set
+ * to -1 and the squared distance set to the maximum search distance.
+ * \param use_previous_nearest: Start the search of every position with the nearest point of the
+ * previously processed position, which prunes most of the tree when positions are close to each
+ * other. The callback then has to report the Euclidean `co` and `dist_sq` of the nearest point.
+ * When several elements are equally close, the found element may differ from the one found by
+ * #BLI_bvhtree_find_nearest, though the result is still deterministic.
+ */
+void BLI_bvhtree_find_nearest_batch(const BVHTree &tree,
+                                    const IndexMask &mask,
+                                    Span<float3> positions,
+                                    MutableSpan<BVHTreeNearest> r_nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    bool use_previous_nearest = false);
+
 using BVHTree_RangeQuery_CPP = FunctionRef<void(int index, const float3 &co, float dist_sq)>;
 
 inline void BLI_bvhtree_range_query_cpp(const BVHTree &tree,
@@ -8,6 +8,10 @@
  */
 
 #include "BLI_compiler_attrs.h"
+#include "BLI_function_ref.hh"
+#include "BLI_index_mask_fwd.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_sys_types.h"
 
 #define _BLI_CONCAT_AUX(MACRO_ARG1, MACRO_ARG2) MACRO_ARG1##MACRO_ARG2
@@ -167,6 +171,35 @@ int BLI_kdtree_nd_(range_search_with_len_squared_cb)(
                        const void *user_data),
     const void *user_data) ATTR_NONNULL(1, 2) ATTR_WARN_UNUSED_RESULT;
 
+/**
+ * Batched version of #BLI_kdtree_3d_find_nearest_n, which finds the nearest points of every
+ * position in \a mask in parallel.
+ *
+ * \param r_nearest: Receives the nearest points of every index in \a mask sorted by distance,
+ * \a nearest_len_capacity elements starting at `index * nearest_len_capacity`.
+ * \param r_nearest_len: Receives the number of nearest points found for every index in \a mask.
+ */
+void BLI_kdtree_nd_(find_nearest_n_batch)(const KDTree *tree,
+                                          const IndexMask &mask,
+                                          Span<VecBase<float, KD_DIMS>> positions,
+                                          int nearest_len_capacity,
+                                          MutableSpan<KDTreeNearest> r_nearest,
+                                          MutableSpan<int> r_nearest_len);
+
+/**
+ * Batched version of #BLI_kdtree_3d_range_search, which finds the points in \a range of every
+ * position in \a mask in parallel. Instead of allocating an array for every query, \a fn receives
+ * the points sorted by distance in memory that is reused for the following queries.
+ *
+ * \note \a fn is called from multiple threads.
+ */
+void BLI_kdtree_nd_(range_search_batch)(
+    const KDTree *tree,
+    const IndexMask &mask,
+    Span<VecBase<float, KD_DIMS>> positions,
+    float range,
+    FunctionRef<void(int64_t index, Span<KDTreeNearest> nearest)> fn);
+
 template<typename Fn>
 inline void BLI_kdtree_nd_(range_search_cb_cpp)(const KDTree *tree,
                                                 const float co[KD_DIMS],
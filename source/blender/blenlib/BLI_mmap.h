@@ -22,6 +22,10 @@ typedef struct BLI_mmap_file BLI_mmap_file;
  * Note that this seeks to the end of the file to determine its length. */
 BLI_mmap_file *BLI_mmap_open(int fd) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
 
+/* Same as #BLI_mmap_open, but the mapped memory can also be written to. Changes are private to
+ * the process and are never written back to the file, the OS copies modified pages on write. */
+BLI_mmap_file *BLI_mmap_open_copy_on_write(int fd) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+
 /* Reads length bytes from file at the given offset into dest.
  * Returns whether the operation was successful (may fail when reading beyond the file
  * end or when IO errors occur). */
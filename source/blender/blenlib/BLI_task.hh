@@ -32,6 +32,8 @@
 #  endif
 #endif
 
+#include <typeinfo>
+
 #include "BLI_function_ref.hh"
 #include "BLI_index_range.hh"
 #include "BLI_lazy_threading.hh"
@@ -65,10 +67,16 @@ inline void parallel_for_each(Range &&range, const Function &function)
 }
 
 namespace detail {
+/**
+ * \param call_site: Identifies the caller in the task statistics, see #BLI_task_statistics.hh.
+ * This is the type of the callback, which is unique for every lambda. Its name is only looked up
+ * when the statistics are retrieved.
+ */
 void parallel_for_impl(IndexRange range,
                        int64_t grain_size,
                        FunctionRef<void(IndexRange)> function,
-                       const TaskSizeHints &size_hints);
+                       const TaskSizeHints &size_hints,
+                       const std::type_info *call_site);
 void memory_bandwidth_bound_task_impl(FunctionRef<void()> function);
 }  // namespace detail
 
@@ -103,7 +111,7 @@ inline void parallel_for(const IndexRange range,
     function(range);
     return;
   }
-  detail::parallel_for_impl(range, grain_size, function, size_hints);
+  detail::parallel_for_impl(range, grain_size, function, size_hints, &typeid(Function));
 }
 
 /**
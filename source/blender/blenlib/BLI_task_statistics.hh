@@ -0,0 +1,130 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ *
+ * Statistics about how #threading::parallel_for and task pools split up their work, to help with
+ * choosing grain sizes. For every call site, the number of tasks, their sizes and how much of the
+ * available thread time was actually spent in them is accumulated.
+ *
+ * Recording is only available when building with `WITH_TASK_STATISTICS` and has to be enabled at
+ * run-time, e.g. with the `--debug-threads-stats` command line argument or from Python with
+ * `bpy.app.use_task_statistics`. While it's disabled, the only overhead is checking a flag
+ * whenever work is actually sent to the task scheduler.
+ */
+
+#include <atomic>
+#include <string>
+
+#include "BLI_timeit.hh"
+#include "BLI_vector.hh"
+
+namespace blender::threading::statistics {
+
+enum class CallSiteType {
+  ParallelFor,
+  TaskPool,
+};
+
+/** Statistics accumulated over all recorded calls from the same call site. */
+struct CallSiteStatistics {
+  /**
+   * For #parallel_for this is the type name of the callback, which contains the name of the
+   * function it is defined in. For task pools, it's the name of the function run by the first
+   * task that was pushed.
+   */
+  std::string name;
+  CallSiteType type = CallSiteType::ParallelFor;
+  /** Number of #parallel_for calls or of task pool work and wait cycles. */
+  int64_t calls = 0;
+  /** Number of tasks the work has been split into. */
+  int64_t tasks = 0;
+  /** Total size of the ranges passed to #parallel_for. */
+  int64_t elements = 0;
+  /** Range of the grain sizes passed to #parallel_for. */
+  int64_t grain_size_min = 0;
+  int64_t grain_size_max = 0;
+  /**
+   * Number of calls that started from within a task of another recorded call. Those compete with
+   * the outer call for the same threads, so their idle time is usually not actually wasted.
+   */
+  int64_t nested_calls = 0;
+  /** Maximum number of tasks of a single call that ran at the same time. */
+  int peak_concurrency = 0;
+  /** Time from the start of the calls until all their tasks were done. */
+  timeit::Nanoseconds wall_time{0};
+  /** Time spent in the tasks, summed over all threads. */
+  timeit::Nanoseconds busy_time{0};
+  /**
+   * Time the threads that could have worked on the calls did not spend on their tasks, i.e. the
+   * wall time multiplied by the number of threads minus the busy time. A large idle time compared
+   * to the busy time means that the work is split into too few tasks, or that the calls are too
+   * small to be worth the overhead of multi-threading.
+   */
+  timeit::Nanoseconds idle_time{0};
+};
+
+/** True when Blender was built with support for recording task statistics. */
+bool is_available();
+/** Start or stop recording, has no effect when statistics are not available. */
+void set_enabled(bool enable);
+bool is_enabled();
+/** Remove all recorded statistics. */
+void reset();
+/** Get the recorded statistics of all call sites, sorted by decreasing wall time. */
+Vector<CallSiteStatistics> get_all();
+/** Print the recorded statistics of all call sites to `stdout`. */
+void print();
+
+namespace detail {
+
+/**
+ * Records the tasks of a single #parallel_for call or task pool. The statistics are added to the
+ * totals of its call site by #finish.
+ */
+class CallRecorder {
+ private:
+  CallSiteType type_;
+  std::atomic<const void *> call_site_;
+  int64_t grain_size_;
+  int64_t elements_;
+  int threads_num_;
+  bool is_nested_;
+  timeit::TimePoint start_;
+  std::atomic<int64_t> tasks_num_{0};
+  std::atomic<int64_t> busy_time_ns_{0};
+  std::atomic<int> running_tasks_num_{0};
+  std::atomic<int> peak_concurrency_{0};
+
+ public:
+  /**
+   * \param call_site: Identifies the call site, either the `std::type_info` of a #parallel_for
+   * callback or the address of a task pool run function. May be set later with
+   * #set_call_site_if_unknown.
+   */
+  CallRecorder(CallSiteType type, const void *call_site, int64_t grain_size, int64_t elements);
+
+  void set_call_site_if_unknown(const void *call_site);
+
+  template<typename Fn> void run_task(const Fn &fn)
+  {
+    const timeit::TimePoint start = this->task_begin();
+    fn();
+    this->task_end(start);
+  }
+
+  /** Add the statistics to the totals of the call site and start recording the next call. */
+  void finish();
+
+ private:
+  timeit::TimePoint task_begin();
+  void task_end(timeit::TimePoint start);
+};
+
+}  // namespace detail
+
+}  // namespace blender::threading::statistics
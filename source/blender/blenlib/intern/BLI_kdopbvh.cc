@@ -28,12 +28,18 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_alloca.h"
+#include "BLI_array.hh"
+#include "BLI_bounds.hh"
 #include "BLI_heap_simple.h"
+#include "BLI_index_mask.hh"
 #include "BLI_kdopbvh.hh"
 #include "BLI_math_geom.h"
+#include "BLI_math_vector.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_sort.hh"
 #include "BLI_stack.h"
 #include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "BLI_strict_flags.h" /* IWYU pragma: keep. Keep last. */
@@ -918,6 +924,36 @@ fail:
   return nullptr;
 }
 
+BVHTree *BLI_bvhtree_copy(const BVHTree *tree)
+{
+  BVHTree *copy = MEM_dupallocN<BVHTree>(__func__, *tree);
+  copy->nodes = static_cast<BVHNode **>(MEM_dupallocN(tree->nodes));
+  copy->nodearray = static_cast<BVHNode *>(MEM_dupallocN(tree->nodearray));
+  copy->nodechild = static_cast<BVHNode **>(MEM_dupallocN(tree->nodechild));
+  copy->nodebv = static_cast<float *>(MEM_dupallocN(tree->nodebv));
+
+  /* All node pointers point into the pre-allocated arrays, so they only have to be offset. */
+  const size_t numnodes = MEM_allocN_len(tree->nodearray) / sizeof(BVHNode);
+  auto remap = [&](const BVHNode *node) -> BVHNode * {
+    return node ? copy->nodearray + (node - tree->nodearray) : nullptr;
+  };
+  for (size_t i = 0; i < numnodes; i++) {
+    BVHNode &node = copy->nodearray[i];
+    node.bv = copy->nodebv + (tree->nodearray[i].bv - tree->nodebv);
+    node.children = copy->nodechild + (tree->nodearray[i].children - tree->nodechild);
+    node.parent = remap(node.parent);
+#ifdef USE_SKIP_LINKS
+    node.skip[0] = remap(node.skip[0]);
+    node.skip[1] = remap(node.skip[1]);
+#endif
+    copy->nodes[i] = remap(copy->nodes[i]);
+  }
+  for (size_t i = 0; i < numnodes * size_t(tree->tree_type); i++) {
+    copy->nodechild[i] = remap(copy->nodechild[i]);
+  }
+  return copy;
+}
+
 void BLI_bvhtree_free(BVHTree *tree)
 {
   if (tree) {
@@ -1057,6 +1093,28 @@ void BLI_bvhtree_get_bounding_box(const BVHTree *tree, float r_bb_min[3], float
   }
 }
 
+float BLI_bvhtree_get_surface_area_cost(const BVHTree *tree)
+{
+  if (tree->branch_num == 0 || tree->start_axis != 0) {
+    return 0.0f;
+  }
+  /* Half of the surface area of the x, y and z bounds, which is enough to compare costs. */
+  auto half_area = [](const BVHNode *node) {
+    const blender::float3 size(
+        node->bv[1] - node->bv[0], node->bv[3] - node->bv[2], node->bv[5] - node->bv[4]);
+    if (size.x < 0.0f) {
+      /* Empty bounds. */
+      return 0.0f;
+    }
+    return size.x * size.y + size.y * size.z + size.z * size.x;
+  };
+  float branches_area = 0.0f;
+  for (int i = 0; i < tree->branch_num; i++) {
+    branches_area += half_area(tree->nodes[tree->leaf_num + i]);
+  }
+  return blender::math::safe_divide(branches_area, half_area(tree->nodes[tree->leaf_num]));
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -2380,3 +2438,146 @@ int BLI_bvhtree_find_nearest_projected(const BVHTree *tree,
 }
 
 /** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Batched Queries
+ * \{ */
+
+namespace blender {
+
+/** Below this number of queries, sorting them costs more than it saves. */
+static constexpr int64_t BVH_BATCH_SORT_THRESHOLD = 4096;
+static constexpr int64_t BVH_BATCH_GRAIN_SIZE = 256;
+
+/** Move the lowest 10 bits of the value to every third bit. */
+static uint32_t morton_spread_bits(uint32_t x)
+{
+  x &= 0x3ff;
+  x = (x | (x << 16)) & 0x030000ff;
+  x = (x | (x << 8)) & 0x0300f00f;
+  x = (x | (x << 4)) & 0x030c30c3;
+  x = (x | (x << 2)) & 0x09249249;
+  return x;
+}
+
+static uint32_t morton_code(const float3 &co_normalized)
+{
+  uint32_t code = 0;
+  for (int axis = 0; axis < 3; axis++) {
+    /* Also maps NaN to zero. */
+    const float co = std::max(0.0f, std::min(co_normalized[axis] * 1023.0f, 1023.0f));
+    code |= morton_spread_bits(uint32_t(co)) << axis;
+  }
+  return code;
+}
+
+/**
+ * Order in which to process the indices of the mask, so that positions which are close to each
+ * other come after each other.
+ */
+static Array<int> sort_indices_spatially(const IndexMask &mask, const Span<float3> positions)
+{
+  const Bounds<float3> bounds = *bounds::min_max(mask, positions);
+  const float3 scale = math::safe_divide(float3(1.0f), bounds.max - bounds.min);
+
+  /* Sort the Morton codes together with the indices, which is faster than sorting the indices
+   * with a comparison function that looks up the codes. */
+  Array<uint64_t> keys(mask.size());
+  mask.foreach_index(GrainSize(4096), [&](const int64_t i, const int64_t pos) {
+    const uint32_t code = morton_code((positions[i] - bounds.min) * scale);
+    keys[pos] = (uint64_t(code) << 32) | uint64_t(i);
+  });
+  parallel_sort(keys.begin(), keys.end());
+
+  Array<int> indices(mask.size());
+  threading::parallel_for(indices.index_range(), 4096, [&](const IndexRange range) {
+    for (const int64_t pos : range) {
+      indices[pos] = int(keys[pos] & 0xffffffff);
+    }
+  });
+  return indices;
+}
+
+/**
+ * Call the function in parallel for chunks of the indices in the mask. Within the chunks, the
+ * indices are sorted spatially by their position, see #sort_indices_spatially.
+ *
+ * The chunks have a fixed size instead of depending on how the work is split up between threads,
+ * so that results which depend on the previously processed index in the chunk are deterministic.
+ */
+template<typename Fn>
+static void foreach_chunk_sorted_spatially(const IndexMask &mask,
+                                           const Span<float3> positions,
+                                           const Fn &fn)
+{
+  const int64_t chunks_num = (mask.size() + BVH_BATCH_GRAIN_SIZE - 1) / BVH_BATCH_GRAIN_SIZE;
+  const auto chunk_range = [&](const int64_t chunk) {
+    const int64_t start = chunk * BVH_BATCH_GRAIN_SIZE;
+    return IndexRange(start, std::min(BVH_BATCH_GRAIN_SIZE, mask.size() - start));
+  };
+  if (mask.size() < BVH_BATCH_SORT_THRESHOLD) {
+    threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange chunks) {
+      for (const int64_t chunk : chunks) {
+        mask.slice(chunk_range(chunk)).foreach_segment([&](const IndexMaskSegment segment) {
+          fn(segment);
+        });
+      }
+    });
+    return;
+  }
+  const Array<int> indices = sort_indices_spatially(mask, positions);
+  threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange chunks) {
+    for (const int64_t chunk : chunks) {
+      fn(indices.as_span().slice(chunk_range(chunk)));
+    }
+  });
+}
+
+void BLI_bvhtree_ray_cast_batch(const BVHTree &tree,
+                                const IndexMask &mask,
+                                const Span<float3> origins,
+                                const Span<float3> directions,
+                                const float radius,
+                                MutableSpan<BVHTreeRayHit> r_hits,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                const int flag)
+{
+  foreach_chunk_sorted_spatially(mask, origins, [&](const auto &indices) {
+    for (const int64_t i : indices) {
+      BLI_bvhtree_ray_cast_ex(
+          &tree, origins[i], directions[i], radius, &r_hits[i], callback, userdata, flag);
+    }
+  });
+}
+
+void BLI_bvhtree_find_nearest_batch(const BVHTree &tree,
+                                    const IndexMask &mask,
+                                    const Span<float3> positions,
+                                    MutableSpan<BVHTreeNearest> r_nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    const bool use_previous_nearest)
+{
+  foreach_chunk_sorted_spatially(mask, positions, [&](const auto &indices) {
+    const BVHTreeNearest *prev_nearest = nullptr;
+    for (const int64_t i : indices) {
+      BVHTreeNearest &nearest = r_nearest[i];
+      /* The nearest point of the previous position is on the surface, so the distance to it is an
+       * upper bound for the distance to the nearest point. */
+      if (use_previous_nearest && prev_nearest && prev_nearest->index != -1) {
+        const float dist_sq = math::distance_squared(positions[i], float3(prev_nearest->co));
+        if (dist_sq < nearest.dist_sq) {
+          nearest = *prev_nearest;
+          nearest.dist_sq = dist_sq;
+        }
+      }
+      BLI_bvhtree_find_nearest(&tree, positions[i], &nearest, callback, userdata);
+      prev_nearest = &nearest;
+    }
+  });
+}
+
+}  // namespace blender
+
+/** \} */
@@ -97,6 +97,7 @@
 #include "BLI_listbase.h"
 #include "BLI_map.hh"
 #include "BLI_mempool.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "BLI_array_store.h" /* Own include. */
@@ -175,6 +176,23 @@ struct BChunkList;
 #  define BCHUNK_HASH_LEN 16
 #endif
 
+#ifdef USE_HASH_TABLE_ACCUMULATE
+/**
+ * Hash large arrays in parallel, split into segments.
+ *
+ * The accumulation reads values ahead of the one being written,
+ * so a second buffer is used to make segments independent of each other.
+ */
+#  define USE_HASH_TABLE_THREADED
+#endif
+
+#ifdef USE_HASH_TABLE_THREADED
+/** Only use threads for hash arrays with more elements than this. */
+#  define BCHUNK_HASH_THREADED_MIN (1 << 16)
+/** Number of elements each task hashes. */
+#  define BCHUNK_HASH_THREADED_GRAIN (1 << 14)
+#endif
+
 /**
  * Calculate the key once and reuse it.
  */
@@ -887,6 +905,67 @@ static void hash_accum(hash_key *hash_array, const size_t hash_array_len, size_t
   }
 }
 
+#  ifdef USE_HASH_TABLE_THREADED
+/**
+ * Same result as #hash_array_from_data followed by #hash_accum,
+ * using multiple threads for large arrays.
+ */
+static void hash_array_from_data_accum_threaded(const BArrayInfo *info,
+                                                const uchar *data_slice,
+                                                const size_t data_slice_len,
+                                                hash_key *hash_array,
+                                                size_t iter_steps)
+{
+  using namespace blender;
+  const size_t hash_array_len = data_slice_len / info->chunk_stride;
+  if (hash_array_len <= BCHUNK_HASH_THREADED_MIN) {
+    hash_array_from_data(info, data_slice, data_slice_len, hash_array);
+    hash_accum(hash_array, hash_array_len, iter_steps);
+    return;
+  }
+
+  threading::parallel_for(
+      IndexRange(int64_t(hash_array_len)), BCHUNK_HASH_THREADED_GRAIN, [&](const IndexRange range) {
+        hash_array_from_data(info,
+                             &data_slice[size_t(range.start()) * info->chunk_stride],
+                             size_t(range.size()) * info->chunk_stride,
+                             &hash_array[range.start()]);
+      });
+
+  if (UNLIKELY(iter_steps > hash_array_len)) {
+    iter_steps = hash_array_len;
+  }
+  const size_t hash_array_search_len = hash_array_len - iter_steps;
+
+  /* Each step of #hash_accum only reads values from the previous step (the values ahead of the
+   * one being written haven't been written yet). Alternate between two buffers so any segment can
+   * be written while others are read. Values past `hash_array_search_len` never change. */
+  hash_key *hash_array_other = MEM_malloc_arrayN<hash_key>(hash_array_len, __func__);
+  memcpy(hash_array_other, hash_array, sizeof(hash_key) * hash_array_len);
+
+  hash_key *src = hash_array;
+  hash_key *dst = hash_array_other;
+  while (iter_steps != 0) {
+    const size_t hash_offset = iter_steps;
+    threading::parallel_for(IndexRange(int64_t(hash_array_search_len)),
+                            BCHUNK_HASH_THREADED_GRAIN,
+                            [&](const IndexRange range) {
+                              for (const int64_t i_signed : range) {
+                                const size_t i = size_t(i_signed);
+                                dst[i] = src[i] + ((src[i + hash_offset] << 3) ^ (src[i] >> 1));
+                              }
+                            });
+    std::swap(src, dst);
+    iter_steps -= 1;
+  }
+
+  if (src != hash_array) {
+    memcpy(hash_array, src, sizeof(hash_key) * hash_array_search_len);
+  }
+  MEM_freeN(hash_array_other);
+}
+#  endif /* USE_HASH_TABLE_THREADED */
+
 /**
  * When we only need a single value, can use a small optimization.
  * we can avoid accumulating the tail of the array a little, each iteration.
@@ -1265,9 +1344,14 @@ static BChunkList *bchunk_list_from_data_merge(const BArrayInfo *info,
     size_t i_table_start = i_prev;
     const size_t table_hash_array_len = (data_len - i_prev) / info->chunk_stride;
     hash_key *table_hash_array = MEM_malloc_arrayN<hash_key>(table_hash_array_len, __func__);
+#  ifdef USE_HASH_TABLE_THREADED
+    hash_array_from_data_accum_threaded(
+        info, &data[i_prev], data_len - i_prev, table_hash_array, info->accum_steps);
+#  else
     hash_array_from_data(info, &data[i_prev], data_len - i_prev, table_hash_array);
 
     hash_accum(table_hash_array, table_hash_array_len, info->accum_steps);
+#  endif
 #else
     /* Dummy vars. */
     uint i_table_start = 0;
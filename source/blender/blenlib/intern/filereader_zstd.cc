@@ -12,9 +12,24 @@
 
 #include "BLI_fileops.hh"
 #include "BLI_filereader.h"
+#include "BLI_task.hh"
 
 #include "MEM_guardedalloc.h"
 
+/**
+ * Number of frames of a seekable file that are decompressed in parallel when reading
+ * sequentially. Since #writefile.cc writes 1mb frames, this keeps a few mb of read-ahead.
+ */
+#define ZSTD_READ_AHEAD_FRAMES 8
+
+/** Decompressed content of a single frame of a seekable file. */
+struct ZstdFrameCache {
+  /** Each cache slot has its own context, so that slots can be decompressed in parallel. */
+  ZSTD_DCtx *ctx;
+  char *content;
+  int frame;
+};
+
 struct ZstdReader {
   FileReader reader;
 
@@ -29,8 +44,13 @@ struct ZstdReader {
     size_t *compressed_ofs;
     size_t *uncompressed_ofs;
 
-    char *cached_content;
-    int cached_frame;
+    /**
+     * Frames are stored in slot `frame % ZSTD_READ_AHEAD_FRAMES`, so a batch of consecutive
+     * frames never evicts itself, while random access only replaces a single slot.
+     */
+    ZstdFrameCache cache[ZSTD_READ_AHEAD_FRAMES];
+    /** The last frame that has been accessed, used to detect sequential reading. */
+    int last_frame;
   } seek;
 };
 
@@ -125,7 +145,10 @@ static bool zstd_read_seek_table(ZstdReader *zstd)
     return false;
   }
 
-  zstd->seek.cached_frame = -1;
+  for (ZstdFrameCache &slot : zstd->seek.cache) {
+    slot.frame = -1;
+  }
+  zstd->seek.last_frame = -1;
 
   return true;
 }
@@ -153,42 +176,85 @@ static int zstd_frame_from_pos(ZstdReader *zstd, size_t pos)
   return low;
 }
 
-/* Ensure that the currently loaded frame is the correct one. */
-static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+/* Decompress `frames_num` consecutive frames starting at `first_frame` into their cache slots.
+ * The compressed data is read from the base reader in one go, while the decompression of the
+ * individual frames runs in parallel. */
+static void zstd_decompress_frames(ZstdReader *zstd, const int first_frame, const int frames_num)
 {
-  if (zstd->seek.cached_frame == frame) {
-    /* Cached frame matches, so just return it. */
-    return zstd->seek.cached_content;
-  }
-
-  /* Cached frame doesn't match, so discard it and cache the wanted one instead. */
-  MEM_SAFE_FREE(zstd->seek.cached_content);
+  const size_t compressed_start = zstd->seek.compressed_ofs[first_frame];
+  const size_t compressed_size = zstd->seek.compressed_ofs[first_frame + frames_num] -
+                                 compressed_start;
 
-  size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] - zstd->seek.compressed_ofs[frame];
-  size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
-                             zstd->seek.uncompressed_ofs[frame];
-
-  char *uncompressed_data = MEM_malloc_arrayN<char>(uncompressed_size, __func__);
   char *compressed_data = MEM_malloc_arrayN<char>(compressed_size, __func__);
-  if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
+  if (zstd->base->seek(zstd->base, compressed_start, SEEK_SET) < 0 ||
       zstd->base->read(zstd->base, compressed_data, compressed_size) < compressed_size)
   {
     MEM_freeN(compressed_data);
-    MEM_freeN(uncompressed_data);
-    return nullptr;
+    return;
   }
 
-  size_t res = ZSTD_decompressDCtx(
-      zstd->ctx, uncompressed_data, uncompressed_size, compressed_data, compressed_size);
+  blender::threading::parallel_for(
+      blender::IndexRange(frames_num), 1, [&](const blender::IndexRange range) {
+        for (const int64_t i : range) {
+          const int frame = first_frame + int(i);
+          ZstdFrameCache &slot = zstd->seek.cache[frame % ZSTD_READ_AHEAD_FRAMES];
+          if (slot.frame == frame) {
+            continue;
+          }
+          MEM_SAFE_FREE(slot.content);
+          slot.frame = -1;
+
+          const size_t frame_compressed_size = zstd->seek.compressed_ofs[frame + 1] -
+                                               zstd->seek.compressed_ofs[frame];
+          const size_t frame_uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
+                                                 zstd->seek.uncompressed_ofs[frame];
+          const char *frame_compressed_data = compressed_data +
+                                              (zstd->seek.compressed_ofs[frame] -
+                                               compressed_start);
+
+          if (slot.ctx == nullptr) {
+            slot.ctx = ZSTD_createDCtx();
+          }
+          char *uncompressed_data = MEM_malloc_arrayN<char>(frame_uncompressed_size, __func__);
+          size_t res = ZSTD_decompressDCtx(slot.ctx,
+                                           uncompressed_data,
+                                           frame_uncompressed_size,
+                                           frame_compressed_data,
+                                           frame_compressed_size);
+          if (ZSTD_isError(res) || res < frame_uncompressed_size) {
+            MEM_freeN(uncompressed_data);
+            continue;
+          }
+          slot.content = uncompressed_data;
+          slot.frame = frame;
+        }
+      });
+
   MEM_freeN(compressed_data);
-  if (ZSTD_isError(res) || res < uncompressed_size) {
-    MEM_freeN(uncompressed_data);
-    return nullptr;
+}
+
+/* Ensure that the given frame is loaded into the cache. */
+static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
+{
+  ZstdFrameCache &slot = zstd->seek.cache[frame % ZSTD_READ_AHEAD_FRAMES];
+  if (slot.frame != frame) {
+    /* When reading sequentially (e.g. while scanning all #BHead's of a file), decompress
+     * the following frames ahead of time as well. When jumping to an arbitrary position
+     * (e.g. reading the data of a single linked ID on demand), only decompress the frame
+     * that is actually needed. */
+    const bool is_sequential = (frame == zstd->seek.last_frame + 1);
+    const int frames_num = is_sequential ?
+                               std::min(ZSTD_READ_AHEAD_FRAMES, zstd->seek.frames_num - frame) :
+                               1;
+    zstd_decompress_frames(zstd, frame, frames_num);
+    if (slot.frame != frame) {
+      /* Error while reading or decompressing the frame. */
+      return nullptr;
+    }
   }
 
-  zstd->seek.cached_frame = frame;
-  zstd->seek.cached_content = uncompressed_data;
-  return uncompressed_data;
+  zstd->seek.last_frame = frame;
+  return slot.content;
 }
 
 static int64_t zstd_read_seekable(FileReader *reader, void *buffer, size_t size)
@@ -281,9 +347,14 @@ static void zstd_close(FileReader *reader)
   if (zstd->reader.seek) {
     MEM_freeN(zstd->seek.uncompressed_ofs);
     MEM_freeN(zstd->seek.compressed_ofs);
-    /* When an error has occurred this may be nullptr, see: #99744. */
-    if (zstd->seek.cached_content) {
-      MEM_freeN(zstd->seek.cached_content);
+    for (ZstdFrameCache &slot : zstd->seek.cache) {
+      /* When an error has occurred this may be nullptr, see: #99744. */
+      if (slot.content) {
+        MEM_freeN(slot.content);
+      }
+      if (slot.ctx) {
+        ZSTD_freeDCtx(slot.ctx);
+      }
     }
   }
   else {
@@ -10,6 +10,5 @@
 #define KDTREE_PREFIX_ID BLI_kdtree_1d
 #define KDTree KDTree_1d
 #define KDTreeNode KDTreeNode_1d
-#define KDTreeNode_head KDTreeNode_head_1d
 #define KDTreeNearest KDTreeNearest_1d
 #include "kdtree_impl.hh"
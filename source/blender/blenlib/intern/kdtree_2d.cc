@@ -10,6 +10,5 @@
 #define KDTREE_PREFIX_ID BLI_kdtree_2d
 #define KDTree KDTree_2d
 #define KDTreeNode KDTreeNode_2d
-#define KDTreeNode_head KDTreeNode_head_2d
 #define KDTreeNearest KDTreeNearest_2d
 #include "kdtree_impl.hh"
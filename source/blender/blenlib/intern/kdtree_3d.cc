@@ -10,6 +10,5 @@
 #define KDTREE_PREFIX_ID BLI_kdtree_3d
 #define KDTree KDTree_3d
 #define KDTreeNode KDTreeNode_3d
-#define KDTreeNode_head KDTreeNode_head_3d
 #define KDTreeNearest KDTreeNearest_3d
 #include "kdtree_impl.hh"
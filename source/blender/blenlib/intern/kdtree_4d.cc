@@ -10,6 +10,5 @@
 #define KDTREE_PREFIX_ID BLI_kdtree_4d
 #define KDTree KDTree_4d
 #define KDTreeNode KDTreeNode_4d
-#define KDTreeNode_head KDTreeNode_head_4d
 #define KDTreeNearest KDTreeNearest_4d
 #include "kdtree_impl.hh"
@@ -9,12 +9,15 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_array.hh"
+#include "BLI_index_mask.hh"
 #include "BLI_kdtree_impl.hh"
 #include "BLI_math_base.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 #include "BLI_vector.hh"
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 
 #include "BLI_strict_flags.h" /* IWYU pragma: keep. Keep last. */
@@ -29,12 +32,6 @@ namespace blender {
  * rule. Otherwise `MEM_malloc_array<KDTreeNode>` can get defined once for multiple dimensions,
  * with different node sizes. */
 
-struct KDTreeNode_head {
-  uint left, right;
-  float co[KD_DIMS];
-  int index;
-};
-
 struct KDTreeNode {
   uint left, right;
   float co[KD_DIMS];
@@ -148,12 +145,13 @@ void BLI_kdtree_nd_(insert)(KDTree *tree, int index, const float co[KD_DIMS])
 #endif
 }
 
+/**
+ * Below this number of nodes, sub-trees are balanced on the calling thread.
+ */
+#define KD_BALANCE_PARALLEL_THRESHOLD 8192
+
 static uint kdtree_balance(KDTreeNode *nodes, uint nodes_len, uint axis, const uint ofs)
 {
-  KDTreeNode *node;
-  float co;
-  uint left, right, median, i, j;
-
   if (nodes_len <= 0) {
     return KD_NODE_UNSET;
   }
@@ -161,45 +159,30 @@ static uint kdtree_balance(KDTreeNode *nodes, uint nodes_len, uint axis, const u
     return 0 + ofs;
   }
 
-  /* Quick-sort style sorting around median. */
-  left = 0;
-  right = nodes_len - 1;
-  median = nodes_len / 2;
-
-  while (right > left) {
-    co = nodes[right].co[axis];
-    i = left - 1;
-    j = right;
-
-    while (true) {
-      while (nodes[++i].co[axis] < co) { /* pass */
-      }
-      while (nodes[--j].co[axis] > co && j > left) { /* pass */
-      }
-
-      if (i >= j) {
-        break;
-      }
-
-      SWAP(KDTreeNode_head, *(KDTreeNode_head *)&nodes[i], *(KDTreeNode_head *)&nodes[j]);
-    }
-
-    SWAP(KDTreeNode_head, *(KDTreeNode_head *)&nodes[i], *(KDTreeNode_head *)&nodes[right]);
-    if (i >= median) {
-      right = i - 1;
-    }
-    if (i <= median) {
-      left = i + 1;
-    }
-  }
+  /* Partition around the median, #std::nth_element has no quadratic worst case for input that is
+   * already sorted along the axis. */
+  const uint median = nodes_len / 2;
+  std::nth_element(nodes,
+                   nodes + median,
+                   nodes + nodes_len,
+                   [axis](const KDTreeNode &a, const KDTreeNode &b) {
+                     return a.co[axis] < b.co[axis];
+                   });
 
-  /* Set node and sort sub-nodes. */
-  node = &nodes[median];
+  /* Set node and sort sub-nodes, which don't overlap in memory. */
+  KDTreeNode *node = &nodes[median];
   node->d = axis;
   axis = (axis + 1) % KD_DIMS;
-  node->left = kdtree_balance(nodes, median, axis, ofs);
-  node->right = kdtree_balance(
-      nodes + median + 1, (nodes_len - (median + 1)), axis, (median + 1) + ofs);
+  uint left, right;
+  threading::parallel_invoke(
+      nodes_len > KD_BALANCE_PARALLEL_THRESHOLD,
+      [&]() { left = kdtree_balance(nodes, median, axis, ofs); },
+      [&]() {
+        right = kdtree_balance(
+            nodes + median + 1, (nodes_len - (median + 1)), axis, (median + 1) + ofs);
+      });
+  node->left = left;
+  node->right = right;
 
   return median + ofs;
 }
@@ -233,6 +216,37 @@ static uint *realloc_nodes(uint *stack, uint *stack_len_capacity, const bool is_
   return stack_new;
 }
 
+/**
+ * Node to visit in nearest point searches, with the squared distance to the closest splitting
+ * plane that separates it from the searched position. Only nodes closer than the current nearest
+ * point have to be visited when they are popped from the stack, which culls a lot more than
+ * checking the distance when they are pushed, before the other side was searched.
+ */
+struct KDTreeNearestStackItem {
+  uint node;
+  float plane_dist_sq;
+};
+
+/**
+ * Push the children of \a node, the one on the same side of the splitting plane as \a co last, so
+ * that it's searched first.
+ */
+static void nearest_stack_push_children(Vector<KDTreeNearestStackItem, KD_STACK_INIT> &stack,
+                                        const KDTreeNode *node,
+                                        const float co[KD_DIMS],
+                                        const float plane_dist_sq)
+{
+  const float plane_dist = co[node->d] - node->co[node->d];
+  const uint near_node = plane_dist < 0.0f ? node->left : node->right;
+  const uint far_node = plane_dist < 0.0f ? node->right : node->left;
+  if (far_node != KD_NODE_UNSET) {
+    stack.append({far_node, std::max(plane_dist_sq, square_f(plane_dist))});
+  }
+  if (near_node != KD_NODE_UNSET) {
+    stack.append({near_node, plane_dist_sq});
+  }
+}
+
 /**
  * Find nearest returns index, and -1 if no node is found.
  */
@@ -241,10 +255,6 @@ int BLI_kdtree_nd_(find_nearest)(const KDTree *tree,
                                  KDTreeNearest *r_nearest)
 {
   const KDTreeNode *nodes = tree->nodes;
-  const KDTreeNode *root, *min_node;
-  uint *stack, stack_default[KD_STACK_INIT];
-  float min_dist, cur_dist;
-  uint stack_len_capacity, cur = 0;
 
 #ifndef NDEBUG
   BLI_assert(tree->is_balanced == true);
@@ -254,72 +264,23 @@ int BLI_kdtree_nd_(find_nearest)(const KDTree *tree,
     return -1;
   }
 
-  stack = stack_default;
-  stack_len_capacity = KD_STACK_INIT;
-
-  root = &nodes[tree->root];
-  min_node = root;
-  min_dist = len_squared_vnvn(root->co, co);
-
-  if (co[root->d] < root->co[root->d]) {
-    if (root->right != KD_NODE_UNSET) {
-      stack[cur++] = root->right;
-    }
-    if (root->left != KD_NODE_UNSET) {
-      stack[cur++] = root->left;
-    }
-  }
-  else {
-    if (root->left != KD_NODE_UNSET) {
-      stack[cur++] = root->left;
-    }
-    if (root->right != KD_NODE_UNSET) {
-      stack[cur++] = root->right;
-    }
-  }
-
-  while (cur--) {
-    const KDTreeNode *node = &nodes[stack[cur]];
-
-    cur_dist = node->co[node->d] - co[node->d];
-
-    if (cur_dist < 0.0f) {
-      cur_dist = -cur_dist * cur_dist;
+  const KDTreeNode *min_node = &nodes[tree->root];
+  float min_dist = FLT_MAX;
 
-      if (-cur_dist < min_dist) {
-        cur_dist = len_squared_vnvn(node->co, co);
-        if (cur_dist < min_dist) {
-          min_dist = cur_dist;
-          min_node = node;
-        }
-        if (node->left != KD_NODE_UNSET) {
-          stack[cur++] = node->left;
-        }
-      }
-      if (node->right != KD_NODE_UNSET) {
-        stack[cur++] = node->right;
-      }
-    }
-    else {
-      cur_dist = cur_dist * cur_dist;
-
-      if (cur_dist < min_dist) {
-        cur_dist = len_squared_vnvn(node->co, co);
-        if (cur_dist < min_dist) {
-          min_dist = cur_dist;
-          min_node = node;
-        }
-        if (node->right != KD_NODE_UNSET) {
-          stack[cur++] = node->right;
-        }
-      }
-      if (node->left != KD_NODE_UNSET) {
-        stack[cur++] = node->left;
-      }
+  Vector<KDTreeNearestStackItem, KD_STACK_INIT> stack;
+  stack.append({tree->root, 0.0f});
+  while (!stack.is_empty()) {
+    const KDTreeNearestStackItem item = stack.pop_last();
+    if (item.plane_dist_sq >= min_dist) {
+      continue;
     }
-    if (UNLIKELY(cur + KD_DIMS > stack_len_capacity)) {
-      stack = realloc_nodes(stack, &stack_len_capacity, stack_default != stack);
+    const KDTreeNode *node = &nodes[item.node];
+    const float cur_dist = len_squared_vnvn(node->co, co);
+    if (cur_dist < min_dist) {
+      min_dist = cur_dist;
+      min_node = node;
     }
+    nearest_stack_push_children(stack, node, co, item.plane_dist_sq);
   }
 
   if (r_nearest) {
@@ -328,10 +289,6 @@ int BLI_kdtree_nd_(find_nearest)(const KDTree *tree,
     copy_vn_vn(r_nearest->co, min_node->co);
   }
 
-  if (stack != stack_default) {
-    MEM_freeN(stack);
-  }
-
   return min_node->index;
 }
 
@@ -344,10 +301,7 @@ int BLI_kdtree_nd_(find_nearest_cb)(
 {
   const KDTreeNode *nodes = tree->nodes;
   const KDTreeNode *min_node = nullptr;
-
-  uint *stack, stack_default[KD_STACK_INIT];
-  float min_dist = FLT_MAX, cur_dist;
-  uint stack_len_capacity, cur = 0;
+  float min_dist = FLT_MAX;
 
 #ifndef NDEBUG
   BLI_assert(tree->is_balanced == true);
@@ -357,74 +311,27 @@ int BLI_kdtree_nd_(find_nearest_cb)(
     return -1;
   }
 
-  stack = stack_default;
-  stack_len_capacity = int(ARRAY_SIZE(stack_default));
-
-#define NODE_TEST_NEAREST(node) \
-  { \
-    const float dist_sq = len_squared_vnvn((node)->co, co); \
-    if (dist_sq < min_dist) { \
-      const int result = filter_cb(user_data, (node)->index, (node)->co, dist_sq); \
-      if (result == 1) { \
-        min_dist = dist_sq; \
-        min_node = node; \
-      } \
-      else if (result == 0) { \
-        /* pass */ \
-      } \
-      else { \
-        BLI_assert(result == -1); \
-        goto finally; \
-      } \
-    } \
-  } \
-  ((void)0)
-
-  stack[cur++] = tree->root;
-
-  while (cur--) {
-    const KDTreeNode *node = &nodes[stack[cur]];
-
-    cur_dist = node->co[node->d] - co[node->d];
-
-    if (cur_dist < 0.0f) {
-      cur_dist = -cur_dist * cur_dist;
-
-      if (-cur_dist < min_dist) {
-        NODE_TEST_NEAREST(node);
-
-        if (node->left != KD_NODE_UNSET) {
-          stack[cur++] = node->left;
-        }
-      }
-      if (node->right != KD_NODE_UNSET) {
-        stack[cur++] = node->right;
-      }
+  Vector<KDTreeNearestStackItem, KD_STACK_INIT> stack;
+  stack.append({tree->root, 0.0f});
+  while (!stack.is_empty()) {
+    const KDTreeNearestStackItem item = stack.pop_last();
+    if (item.plane_dist_sq >= min_dist) {
+      continue;
     }
-    else {
-      cur_dist = cur_dist * cur_dist;
-
-      if (cur_dist < min_dist) {
-        NODE_TEST_NEAREST(node);
-
-        if (node->right != KD_NODE_UNSET) {
-          stack[cur++] = node->right;
-        }
+    const KDTreeNode *node = &nodes[item.node];
+    const float dist_sq = len_squared_vnvn(node->co, co);
+    if (dist_sq < min_dist) {
+      const int result = filter_cb(user_data, node->index, node->co, dist_sq);
+      BLI_assert(ELEM(result, 1, 0, -1));
+      if (result == 1) {
+        min_dist = dist_sq;
+        min_node = node;
       }
-      if (node->left != KD_NODE_UNSET) {
-        stack[cur++] = node->left;
+      else if (result == -1) {
+        break;
       }
     }
-    if (UNLIKELY(cur + KD_DIMS > stack_len_capacity)) {
-      stack = realloc_nodes(stack, &stack_len_capacity, stack_default != stack);
-    }
-  }
-
-#undef NODE_TEST_NEAREST
-
-finally:
-  if (stack != stack_default) {
-    MEM_freeN(stack);
+    nearest_stack_push_children(stack, node, co, item.plane_dist_sq);
   }
 
   if (min_node) {
@@ -475,10 +382,6 @@ int BLI_kdtree_nd_(find_nearest_n_with_len_squared_cb)(
     const void *user_data)
 {
   const KDTreeNode *nodes = tree->nodes;
-  const KDTreeNode *root;
-  uint *stack, stack_default[KD_STACK_INIT];
-  float cur_dist;
-  uint stack_len_capacity, cur = 0;
   uint i, nearest_len = 0;
 
 #ifndef NDEBUG
@@ -494,87 +397,27 @@ int BLI_kdtree_nd_(find_nearest_n_with_len_squared_cb)(
     BLI_assert(user_data == nullptr);
   }
 
-  stack = stack_default;
-  stack_len_capacity = int(ARRAY_SIZE(stack_default));
-
-  root = &nodes[tree->root];
-
-  cur_dist = len_sq_fn(co, root->co, user_data);
-  nearest_ordered_insert(
-      r_nearest, &nearest_len, nearest_len_capacity, root->index, cur_dist, root->co);
-
-  if (co[root->d] < root->co[root->d]) {
-    if (root->right != KD_NODE_UNSET) {
-      stack[cur++] = root->right;
-    }
-    if (root->left != KD_NODE_UNSET) {
-      stack[cur++] = root->left;
-    }
-  }
-  else {
-    if (root->left != KD_NODE_UNSET) {
-      stack[cur++] = root->left;
-    }
-    if (root->right != KD_NODE_UNSET) {
-      stack[cur++] = root->right;
-    }
-  }
-
-  while (cur--) {
-    const KDTreeNode *node = &nodes[stack[cur]];
-
-    cur_dist = node->co[node->d] - co[node->d];
-
-    if (cur_dist < 0.0f) {
-      cur_dist = -cur_dist * cur_dist;
-
-      if (nearest_len < nearest_len_capacity || -cur_dist < r_nearest[nearest_len - 1].dist) {
-        cur_dist = len_sq_fn(co, node->co, user_data);
-
-        if (nearest_len < nearest_len_capacity || cur_dist < r_nearest[nearest_len - 1].dist) {
-          nearest_ordered_insert(
-              r_nearest, &nearest_len, nearest_len_capacity, node->index, cur_dist, node->co);
-        }
-
-        if (node->left != KD_NODE_UNSET) {
-          stack[cur++] = node->left;
-        }
-      }
-      if (node->right != KD_NODE_UNSET) {
-        stack[cur++] = node->right;
-      }
-    }
-    else {
-      cur_dist = cur_dist * cur_dist;
-
-      if (nearest_len < nearest_len_capacity || cur_dist < r_nearest[nearest_len - 1].dist) {
-        cur_dist = len_sq_fn(co, node->co, user_data);
-        if (nearest_len < nearest_len_capacity || cur_dist < r_nearest[nearest_len - 1].dist) {
-          nearest_ordered_insert(
-              r_nearest, &nearest_len, nearest_len_capacity, node->index, cur_dist, node->co);
-        }
-
-        if (node->right != KD_NODE_UNSET) {
-          stack[cur++] = node->right;
-        }
-      }
-      if (node->left != KD_NODE_UNSET) {
-        stack[cur++] = node->left;
-      }
+  Vector<KDTreeNearestStackItem, KD_STACK_INIT> stack;
+  stack.append({tree->root, 0.0f});
+  while (!stack.is_empty()) {
+    const KDTreeNearestStackItem item = stack.pop_last();
+    const bool is_full = nearest_len == nearest_len_capacity;
+    if (is_full && item.plane_dist_sq >= r_nearest[nearest_len - 1].dist) {
+      continue;
     }
-    if (UNLIKELY(cur + KD_DIMS > stack_len_capacity)) {
-      stack = realloc_nodes(stack, &stack_len_capacity, stack_default != stack);
+    const KDTreeNode *node = &nodes[item.node];
+    const float cur_dist = len_sq_fn(co, node->co, user_data);
+    if (!is_full || cur_dist < r_nearest[nearest_len - 1].dist) {
+      nearest_ordered_insert(
+          r_nearest, &nearest_len, nearest_len_capacity, node->index, cur_dist, node->co);
     }
+    nearest_stack_push_children(stack, node, co, item.plane_dist_sq);
   }
 
   for (i = 0; i < nearest_len; i++) {
     r_nearest[i].dist = sqrtf(r_nearest[i].dist);
   }
 
-  if (stack != stack_default) {
-    MEM_freeN(stack);
-  }
-
   return (int)nearest_len;
 }
 
@@ -1056,4 +899,56 @@ int BLI_kdtree_nd_(deduplicate)(KDTree *tree)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name BLI_kdtree_3d Batched Queries
+ * \{ */
+
+void BLI_kdtree_nd_(find_nearest_n_batch)(const KDTree *tree,
+                                          const IndexMask &mask,
+                                          const Span<VecBase<float, KD_DIMS>> positions,
+                                          const int nearest_len_capacity,
+                                          MutableSpan<KDTreeNearest> r_nearest,
+                                          MutableSpan<int> r_nearest_len)
+{
+  BLI_assert(nearest_len_capacity >= 0);
+  BLI_assert(r_nearest.size() >= mask.min_array_size() * nearest_len_capacity);
+  mask.foreach_index(GrainSize(256), [&](const int64_t i) {
+    r_nearest_len[i] = BLI_kdtree_nd_(find_nearest_n)(tree,
+                                                       positions[i],
+                                                       &r_nearest[i * nearest_len_capacity],
+                                                       uint(nearest_len_capacity));
+  });
+}
+
+void BLI_kdtree_nd_(range_search_batch)(
+    const KDTree *tree,
+    const IndexMask &mask,
+    const Span<VecBase<float, KD_DIMS>> positions,
+    const float range,
+    const FunctionRef<void(int64_t index, Span<KDTreeNearest> nearest)> fn)
+{
+  threading::parallel_for(mask.index_range(), 256, [&](const IndexRange range_in_mask) {
+    /* Reused by all queries of this task, so that there is no allocation for every query. */
+    Vector<KDTreeNearest, KD_FOUND_ALLOC_INC> nearest;
+    mask.slice(range_in_mask).foreach_index([&](const int64_t i) {
+      nearest.clear();
+      BLI_kdtree_nd_(range_search_cb_cpp)(
+          tree, positions[i], range, [&](const int index, const float *co, const float dist_sq) {
+            KDTreeNearest item;
+            item.index = index;
+            item.dist = std::sqrt(dist_sq);
+            copy_vn_vn(item.co, co);
+            nearest.append(item);
+            return true;
+          });
+      std::sort(nearest.begin(),
+                nearest.end(),
+                [](const KDTreeNearest &a, const KDTreeNearest &b) { return a.dist < b.dist; });
+      fn(i, nearest);
+    });
+  });
+}
+
+/** \} */
+
 }  //  namespace blender
@@ -20,6 +20,7 @@
 #include "BLI_assert.h"
 #include "BLI_mempool.h"
 #include "BLI_task.h"
+#include "BLI_task_statistics.hh"
 #include "BLI_threads.h"
 #include "BLI_vector.hh"
 
@@ -110,12 +111,6 @@ class Task {
   void operator()() const;
 };
 
-/* Execute task. */
-void Task::operator()() const
-{
-  run(pool, taskdata);
-}
-
 /* TBB Task Group.
  *
  * Subclass since there seems to be no other way to set priority. */
@@ -174,11 +169,25 @@ struct TaskPool {
 
   eTaskPriority priority;
 
+#ifdef WITH_TASK_STATISTICS
+  /* Only set when task statistics were enabled when the pool was created. */
+  std::unique_ptr<blender::threading::statistics::detail::CallRecorder> statistics_recorder;
+#endif
+
   TaskPool(const TaskPoolType type, const eTaskPriority priority, void *userdata)
       : type(type), userdata(userdata), priority(priority)
   {
     this->use_threads = BLI_task_scheduler_num_threads() > 1 && type != TASK_POOL_NO_THREADS;
 
+#ifdef WITH_TASK_STATISTICS
+    /* The call site is only known once the first task is pushed. */
+    if (this->use_threads && blender::threading::statistics::is_enabled()) {
+      this->statistics_recorder =
+          std::make_unique<blender::threading::statistics::detail::CallRecorder>(
+              blender::threading::statistics::CallSiteType::TaskPool, nullptr, 0, 0);
+    }
+#endif
+
     /* Background task pool uses regular TBB scheduling if available. Only when
      * building without TBB or running with -t 1 do we need to ensure these tasks
      * do not block the main thread. */
@@ -253,6 +262,11 @@ struct TaskPool {
                  bool free_taskdata,
                  TaskFreeFunction freedata)
   {
+#ifdef WITH_TASK_STATISTICS
+    if (this->statistics_recorder) {
+      this->statistics_recorder->set_call_site_if_unknown(reinterpret_cast<const void *>(run));
+    }
+#endif
     switch (this->type) {
       case TASK_POOL_TBB:
       case TASK_POOL_TBB_SUSPENDED:
@@ -282,6 +296,11 @@ struct TaskPool {
         this->background_task_pool_work_and_wait();
         break;
     }
+#ifdef WITH_TASK_STATISTICS
+    if (this->statistics_recorder) {
+      this->statistics_recorder->finish();
+    }
+#endif
   }
 
   /**
@@ -340,6 +359,18 @@ struct TaskPool {
   static void *background_task_run(void *userdata);
 };
 
+/* Execute task. */
+void Task::operator()() const
+{
+#ifdef WITH_TASK_STATISTICS
+  if (pool->statistics_recorder) {
+    pool->statistics_recorder->run_task([&]() { run(pool, taskdata); });
+    return;
+  }
+#endif
+  run(pool, taskdata);
+}
+
 void TaskPool::tbb_task_pool_run(Task &&task)
 {
   BLI_assert(ELEM(this->type, TASK_POOL_TBB, TASK_POOL_TBB_SUSPENDED, TASK_POOL_NO_THREADS));
@@ -17,6 +17,7 @@
 #include "BLI_offset_indices.hh"
 #include "BLI_task.h"
 #include "BLI_task.hh"
+#include "BLI_task_statistics.hh"
 #include "BLI_threads.h"
 #include "BLI_vector.hh"
 
@@ -171,6 +172,22 @@ static void parallel_for_impl_static_size(const IndexRange range,
                       function(IndexRange(subrange.begin(), subrange.size()));
                     });
 }
+
+/**
+ * Same as #threading::parallel_for, but not recorded in the task statistics, because it only
+ * splits up the work of a call that is recorded already.
+ */
+template<typename Function>
+static void parallel_for_unrecorded(const IndexRange range,
+                                    const int64_t grain_size,
+                                    const Function &function)
+{
+  if (range.size() <= grain_size) {
+    function(range);
+    return;
+  }
+  parallel_for_impl(range, grain_size, function, TaskSizeHints_Static(1), nullptr);
+}
 #endif /* WITH_TBB */
 
 #ifdef WITH_TBB
@@ -184,7 +201,7 @@ static void parallel_for_impl_individual_size_lookup(
    * small. Also shouldn't be too large because then the serial code to split up tasks causes extra
    * overhead. */
   const int64_t outer_grain_size = std::min<int64_t>(grain_size, 512);
-  threading::parallel_for(range, outer_grain_size, [&](const IndexRange sub_range) {
+  parallel_for_unrecorded(range, outer_grain_size, [&](const IndexRange sub_range) {
     /* Compute the size of every task in the current range. */
     Array<int64_t, 1024> task_sizes(sub_range.size());
     size_hints.lookup_individual_sizes(sub_range, task_sizes);
@@ -206,7 +223,7 @@ static void parallel_for_impl_individual_size_lookup(
     const OffsetIndices<int64_t> offsets = offsets_vec.as_span();
 
     /* Run the dynamically split tasks in parallel. */
-    threading::parallel_for(offsets.index_range(), 1, [&](const IndexRange offsets_range) {
+    parallel_for_unrecorded(offsets.index_range(), 1, [&](const IndexRange offsets_range) {
       for (const int64_t i : offsets_range) {
         const IndexRange actual_range = offsets[i].shift(sub_range.start());
         function(actual_range);
@@ -246,10 +263,10 @@ static void parallel_for_impl_accumulated_size_lookup(
       });
 }
 
-void parallel_for_impl(const IndexRange range,
-                       const int64_t grain_size,
-                       const FunctionRef<void(IndexRange)> function,
-                       const TaskSizeHints &size_hints)
+static void parallel_for_dispatch(const IndexRange range,
+                                  const int64_t grain_size,
+                                  const FunctionRef<void(IndexRange)> function,
+                                  const TaskSizeHints &size_hints)
 {
 #ifdef WITH_TBB
   lazy_threading::send_hint();
@@ -286,6 +303,30 @@ void parallel_for_impl(const IndexRange range,
 #endif
 }
 
+void parallel_for_impl(const IndexRange range,
+                       const int64_t grain_size,
+                       const FunctionRef<void(IndexRange)> function,
+                       const TaskSizeHints &size_hints,
+                       const std::type_info *call_site)
+{
+#ifdef WITH_TASK_STATISTICS
+  if (call_site != nullptr && statistics::is_enabled()) {
+    statistics::detail::CallRecorder recorder(
+        statistics::CallSiteType::ParallelFor, call_site, grain_size, range.size());
+    parallel_for_dispatch(
+        range,
+        grain_size,
+        [&](const IndexRange sub_range) { recorder.run_task([&]() { function(sub_range); }); },
+        size_hints);
+    recorder.finish();
+    return;
+  }
+#else
+  UNUSED_VARS(call_site);
+#endif
+  parallel_for_dispatch(range, grain_size, function, size_hints);
+}
+
 void memory_bandwidth_bound_task_impl(const FunctionRef<void()> function)
 {
 #ifdef WITH_TBB
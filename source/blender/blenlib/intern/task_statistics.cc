@@ -0,0 +1,325 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bli
+ *
+ * Recording of task statistics, see #BLI_task_statistics.hh.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <typeindex>
+
+#include "BLI_map.hh"
+#include "BLI_mutex.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_task.h"
+#include "BLI_task_statistics.hh"
+#include "BLI_utildefines.h"
+
+#include <fmt/format.h>
+
+#ifdef WITH_TBB
+#  include <tbb/task_arena.h>
+#endif
+
+#ifdef __GNUC__
+#  include <cxxabi.h>
+#endif
+
+#if defined(HAVE_EXECINFO_H)
+#  include <execinfo.h>
+#endif
+
+namespace blender::threading::statistics {
+
+#ifdef WITH_TASK_STATISTICS
+
+static std::atomic<bool> statistics_enabled = false;
+
+struct TypeIndexHash {
+  uint64_t operator()(const std::type_index &value) const
+  {
+    return value.hash_code();
+  }
+};
+
+static Mutex statistics_mutex;
+
+/**
+ * Totals of #parallel_for call sites, keyed by the type of their callback. #std::type_index is
+ * used because the same type may have multiple #std::type_info objects across shared libraries.
+ */
+static Map<std::type_index, CallSiteStatistics, 0, DefaultProbingStrategy, TypeIndexHash> &
+parallel_for_statistics()
+{
+  static Map<std::type_index, CallSiteStatistics, 0, DefaultProbingStrategy, TypeIndexHash>
+      statistics;
+  return statistics;
+}
+
+/** Totals of task pools, keyed by the address of the function run by their first task. */
+static Map<const void *, CallSiteStatistics> &task_pool_statistics()
+{
+  static Map<const void *, CallSiteStatistics> statistics;
+  return statistics;
+}
+
+/** Number of recorded tasks that are currently running on this thread, to detect nested calls. */
+static thread_local int running_tasks_depth = 0;
+
+static std::string demangle(const char *name)
+{
+#  ifdef __GNUC__
+  int status = 0;
+  char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+  if (status == 0 && demangled) {
+    std::string result = demangled;
+    free(demangled);
+    return result;
+  }
+#  endif
+  return name;
+}
+
+/**
+ * The symbol name of a task run function. It's only available when the function is exported,
+ * otherwise the address can be resolved with `addr2line`.
+ */
+static std::string function_name(const void *function)
+{
+#  if defined(HAVE_EXECINFO_H)
+  void *address = const_cast<void *>(function);
+  if (char **symbols = backtrace_symbols(&address, 1)) {
+    std::string result = symbols[0];
+    free(symbols);
+    const int64_t begin = StringRef(result).find('(');
+    const int64_t end = StringRef(result).find('+', begin);
+    if (begin != StringRef::not_found && end != StringRef::not_found && end > begin + 1) {
+      return demangle(result.substr(begin + 1, end - begin - 1).c_str());
+    }
+    return result;
+  }
+#  endif
+  return fmt::format("{}", function);
+}
+
+static int available_threads_num()
+{
+#  ifdef WITH_TBB
+  return tbb::this_task_arena::max_concurrency();
+#  else
+  return 1;
+#  endif
+}
+
+#endif /* WITH_TASK_STATISTICS */
+
+bool is_available()
+{
+#ifdef WITH_TASK_STATISTICS
+  return true;
+#else
+  return false;
+#endif
+}
+
+void set_enabled(const bool enable)
+{
+#ifdef WITH_TASK_STATISTICS
+  statistics_enabled.store(enable, std::memory_order_relaxed);
+#else
+  UNUSED_VARS(enable);
+#endif
+}
+
+bool is_enabled()
+{
+#ifdef WITH_TASK_STATISTICS
+  return statistics_enabled.load(std::memory_order_relaxed);
+#else
+  return false;
+#endif
+}
+
+void reset()
+{
+#ifdef WITH_TASK_STATISTICS
+  std::lock_guard lock{statistics_mutex};
+  parallel_for_statistics().clear();
+  task_pool_statistics().clear();
+#endif
+}
+
+Vector<CallSiteStatistics> get_all()
+{
+  Vector<CallSiteStatistics> result;
+#ifdef WITH_TASK_STATISTICS
+  {
+    std::lock_guard lock{statistics_mutex};
+    for (const auto item : parallel_for_statistics().items()) {
+      result.append(item.value);
+      result.last().name = demangle(item.key.name());
+    }
+    for (const auto item : task_pool_statistics().items()) {
+      result.append(item.value);
+      result.last().name = function_name(item.key);
+    }
+  }
+  std::sort(result.begin(),
+            result.end(),
+            [](const CallSiteStatistics &a, const CallSiteStatistics &b) {
+              return a.wall_time > b.wall_time;
+            });
+#endif
+  return result;
+}
+
+void print()
+{
+  if (!is_available()) {
+    std::cout << "Task statistics are not available, build with WITH_TASK_STATISTICS\n";
+    return;
+  }
+  const Vector<CallSiteStatistics> statistics = get_all();
+  const auto ms = [](const timeit::Nanoseconds duration) { return duration.count() / 1.0e6; };
+
+  fmt::memory_buffer buf;
+  fmt::format_to(fmt::appender(buf),
+                 "Task statistics ({} threads, {} call sites):\n",
+                 BLI_task_scheduler_num_threads(),
+                 statistics.size());
+  fmt::format_to(fmt::appender(buf),
+                 "{:>10} {:>10} {:>10} {:>8} {:>9} {:>6} {:>6} {:>15} {:>11}  {}\n",
+                 "Wall ms",
+                 "Busy ms",
+                 "Idle ms",
+                 "Calls",
+                 "Tasks",
+                 "Nested",
+                 "Peak",
+                 "Grain size",
+                 "Elements",
+                 "Call site");
+  for (const CallSiteStatistics &call_site : statistics) {
+    const std::string grain_size = call_site.type == CallSiteType::TaskPool ?
+                                       std::string("-") :
+                                       fmt::format("{}-{}",
+                                                   call_site.grain_size_min,
+                                                   call_site.grain_size_max);
+    fmt::format_to(fmt::appender(buf),
+                   "{:>10.2f} {:>10.2f} {:>10.2f} {:>8} {:>9} {:>6} {:>6} {:>15} {:>11}  {}{}\n",
+                   ms(call_site.wall_time),
+                   ms(call_site.busy_time),
+                   ms(call_site.idle_time),
+                   call_site.calls,
+                   call_site.tasks,
+                   call_site.nested_calls,
+                   call_site.peak_concurrency,
+                   grain_size,
+                   call_site.elements,
+                   call_site.type == CallSiteType::TaskPool ? "Task pool: " : "",
+                   call_site.name);
+  }
+  std::cout << StringRef(buf.data(), buf.size());
+}
+
+namespace detail {
+
+CallRecorder::CallRecorder(const CallSiteType type,
+                           const void *call_site,
+                           const int64_t grain_size,
+                           const int64_t elements)
+    : type_(type), call_site_(call_site), grain_size_(grain_size), elements_(elements)
+{
+#ifdef WITH_TASK_STATISTICS
+  threads_num_ = available_threads_num();
+  is_nested_ = running_tasks_depth > 0;
+#else
+  threads_num_ = 1;
+  is_nested_ = false;
+#endif
+  start_ = timeit::Clock::now();
+}
+
+void CallRecorder::set_call_site_if_unknown(const void *call_site)
+{
+  const void *unknown = nullptr;
+  call_site_.compare_exchange_strong(unknown, call_site, std::memory_order_relaxed);
+}
+
+timeit::TimePoint CallRecorder::task_begin()
+{
+#ifdef WITH_TASK_STATISTICS
+  running_tasks_depth++;
+#endif
+  const int running_tasks_num = running_tasks_num_.fetch_add(1, std::memory_order_relaxed) + 1;
+  int peak = peak_concurrency_.load(std::memory_order_relaxed);
+  while (running_tasks_num > peak &&
+         !peak_concurrency_.compare_exchange_weak(peak, running_tasks_num))
+  {
+  }
+  return timeit::Clock::now();
+}
+
+void CallRecorder::task_end(const timeit::TimePoint start)
+{
+  const timeit::Nanoseconds duration = timeit::Clock::now() - start;
+  busy_time_ns_.fetch_add(duration.count(), std::memory_order_relaxed);
+  tasks_num_.fetch_add(1, std::memory_order_relaxed);
+  running_tasks_num_.fetch_sub(1, std::memory_order_relaxed);
+#ifdef WITH_TASK_STATISTICS
+  running_tasks_depth--;
+#endif
+}
+
+void CallRecorder::finish()
+{
+  const timeit::TimePoint end = timeit::Clock::now();
+#ifdef WITH_TASK_STATISTICS
+  const void *call_site = call_site_.load(std::memory_order_relaxed);
+  if (call_site != nullptr) {
+    const timeit::Nanoseconds wall_time = end - start_;
+    const timeit::Nanoseconds busy_time(busy_time_ns_.load(std::memory_order_relaxed));
+    const timeit::Nanoseconds idle_time = std::max(wall_time * threads_num_ - busy_time,
+                                                   timeit::Nanoseconds(0));
+
+    const auto new_statistics = [&]() {
+      CallSiteStatistics new_statistics;
+      new_statistics.type = type_;
+      new_statistics.grain_size_min = grain_size_;
+      new_statistics.grain_size_max = grain_size_;
+      return new_statistics;
+    };
+
+    std::lock_guard lock{statistics_mutex};
+    CallSiteStatistics &statistics =
+        type_ == CallSiteType::ParallelFor ?
+            parallel_for_statistics().lookup_or_add_cb(
+                std::type_index(*static_cast<const std::type_info *>(call_site)), new_statistics) :
+            task_pool_statistics().lookup_or_add_cb(call_site, new_statistics);
+    statistics.calls++;
+    statistics.tasks += tasks_num_.load(std::memory_order_relaxed);
+    statistics.elements += elements_;
+    statistics.grain_size_min = std::min(statistics.grain_size_min, grain_size_);
+    statistics.grain_size_max = std::max(statistics.grain_size_max, grain_size_);
+    statistics.nested_calls += is_nested_ ? 1 : 0;
+    statistics.peak_concurrency = std::max(statistics.peak_concurrency,
+                                           peak_concurrency_.load(std::memory_order_relaxed));
+    statistics.wall_time += wall_time;
+    statistics.busy_time += busy_time;
+    statistics.idle_time += idle_time;
+  }
+#endif
+  start_ = end;
+  tasks_num_.store(0, std::memory_order_relaxed);
+  busy_time_ns_.store(0, std::memory_order_relaxed);
+  peak_concurrency_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace detail
+
+}  // namespace blender::threading::statistics
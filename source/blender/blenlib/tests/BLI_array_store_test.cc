@@ -13,6 +13,7 @@
 #include "BLI_ressource_strings.h"
 #include "BLI_string.h"
 #include "BLI_sys_types.h"
+#include "BLI_timeit.hh"
 #include "BLI_utildefines.h"
 
 /* print memory savings */
@@ -1057,6 +1058,96 @@ TEST(array_store, RLE_RandomBytes)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Large Array Tests
+ *
+ * Arrays large enough for their hashes to be calculated using multiple threads.
+ * \{ */
+
+/**
+ * Add a random array, then a version of it with items inserted at the start (so chunks don't
+ * line up and the hash table is used) and some items modified.
+ *
+ * \param timer_name: When set, print the time taken to add the second array.
+ */
+static void array_store_test_large_array(const uint stride,
+                                         const uint chunk_count,
+                                         const size_t items_num,
+                                         const char *timer_name = nullptr)
+{
+  BArrayStore *bs = BLI_array_store_create(stride, chunk_count);
+  RNG *rng = BLI_rng_new(uint(items_num));
+
+  const size_t data_len = items_num * stride;
+  const size_t insert_len = 3 * stride;
+  char *data_a = MEM_malloc_arrayN<char>(data_len, __func__);
+  BLI_rng_get_char_n(rng, data_a, data_len);
+
+  char *data_b = MEM_malloc_arrayN<char>(data_len + insert_len, __func__);
+  BLI_rng_get_char_n(rng, data_b, insert_len);
+  memcpy(data_b + insert_len, data_a, data_len);
+  for (int i = 0; i < 16; i++) {
+    data_b[insert_len + BLI_rng_get_uint(rng) % data_len] ^= 1;
+  }
+
+  BArrayState *state_a = BLI_array_store_state_add(bs, data_a, data_len, nullptr);
+  BArrayState *state_b;
+  {
+    std::optional<blender::timeit::ScopedTimer> timer;
+    if (timer_name) {
+      timer.emplace(timer_name);
+    }
+    state_b = BLI_array_store_state_add(bs, data_b, data_len + insert_len, state_a);
+  }
+  EXPECT_TRUE(BLI_array_store_is_valid(bs));
+
+  size_t data_test_len;
+  char *data_test = static_cast<char *>(
+      BLI_array_store_state_data_get_alloc(state_b, &data_test_len));
+  EXPECT_EQ(data_test_len, data_len + insert_len);
+  EXPECT_EQ(memcmp(data_test, data_b, data_test_len), 0);
+  MEM_freeN(data_test);
+
+  /* Most of the second array should be shared with the first. */
+  EXPECT_LT(BLI_array_store_calc_size_compacted_get(bs), data_len + data_len / 2);
+
+  MEM_freeN(data_a);
+  MEM_freeN(data_b);
+  BLI_rng_free(rng);
+  BLI_array_store_destroy(bs);
+}
+
+TEST(array_store, LargeArray_Stride1_Chunk4096)
+{
+  array_store_test_large_array(1, 4096, 1000000);
+}
+
+TEST(array_store, LargeArray_Stride12_Chunk1024)
+{
+  array_store_test_large_array(12, 1024, 500000);
+}
+
+TEST(array_store, LargeArray_Stride4_Chunk65)
+{
+  array_store_test_large_array(4, 65, 300001);
+}
+
+/**
+ * Set this to 1 to activate the benchmark, measuring the time to add a state for a given array
+ * size. It is disabled by default, because it is slow and prints a lot.
+ */
+#if 0
+TEST(array_store, LargeArrayBenchmark)
+{
+  for (const size_t items_num : {size_t(1) << 16, size_t(1) << 20, size_t(1) << 23}) {
+    const std::string name = "Add " + std::to_string(items_num) + " float3";
+    array_store_test_large_array(12, 2048, items_num, name.c_str());
+  }
+}
+#endif
+
+/** \} */
+
 #if 0
 
 /* -------------------------------------------------------------------- */
@@ -0,0 +1,107 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <cstring>
+#include <zstd.h>
+
+#include "BLI_filereader.h"
+#include "BLI_vector.hh"
+
+namespace blender::tests {
+
+static void append_u32(Vector<char> &buffer, const uint32_t value)
+{
+  /* NOTE: this is endianness-sensitive, matching the seek table reading. */
+  buffer.extend(Span<char>(reinterpret_cast<const char *>(&value), sizeof(uint32_t)));
+}
+
+/**
+ * Compress `data` into independent frames of `frame_size` bytes, followed by a seek table,
+ * in the same way as `writefile.cc` does.
+ */
+static Vector<char> zstd_compress_seekable(const Span<char> data, const int64_t frame_size)
+{
+  Vector<char> result;
+  Vector<std::pair<uint32_t, uint32_t>> frames;
+  for (int64_t ofs = 0; ofs < data.size(); ofs += frame_size) {
+    const Span<char> frame = data.slice(ofs, std::min(frame_size, data.size() - ofs));
+    Vector<char> compressed(ZSTD_compressBound(frame.size()));
+    const size_t compressed_size = ZSTD_compress(
+        compressed.data(), compressed.size(), frame.data(), frame.size(), 1);
+    result.extend(compressed.as_span().take_front(compressed_size));
+    frames.append({uint32_t(compressed_size), uint32_t(frame.size())});
+  }
+
+  append_u32(result, 0x184D2A5E);
+  append_u32(result, uint32_t(frames.size() * 8 + 9));
+  for (const auto &[compressed_size, uncompressed_size] : frames) {
+    append_u32(result, compressed_size);
+    append_u32(result, uncompressed_size);
+  }
+  append_u32(result, uint32_t(frames.size()));
+  result.append(0);
+  append_u32(result, 0x8F92EAB1);
+  return result;
+}
+
+static Vector<char> test_data(const int64_t size)
+{
+  Vector<char> data(size);
+  for (const int64_t i : data.index_range()) {
+    data[i] = char((i * 7) ^ (i >> 9));
+  }
+  return data;
+}
+
+TEST(filereader, zstd_seekable_sequential)
+{
+  const Vector<char> data = test_data(100 * 1000);
+  const Vector<char> compressed = zstd_compress_seekable(data, 1000);
+
+  FileReader *reader = BLI_filereader_new_zstd(
+      BLI_filereader_new_memory(compressed.data(), compressed.size()));
+  ASSERT_NE(reader, nullptr);
+  ASSERT_NE(reader->seek, nullptr);
+
+  /* Read in pieces that don't line up with the frames. */
+  Vector<char> result(data.size());
+  int64_t ofs = 0;
+  while (ofs < result.size()) {
+    const int64_t size = std::min<int64_t>(777, result.size() - ofs);
+    ASSERT_EQ(reader->read(reader, result.data() + ofs, size), size);
+    ofs += size;
+  }
+  EXPECT_EQ(result.as_span(), data.as_span());
+
+  char extra;
+  EXPECT_EQ(reader->read(reader, &extra, 1), 0);
+
+  reader->close(reader);
+}
+
+TEST(filereader, zstd_seekable_random_access)
+{
+  const Vector<char> data = test_data(50 * 1000);
+  const Vector<char> compressed = zstd_compress_seekable(data, 1000);
+
+  FileReader *reader = BLI_filereader_new_zstd(
+      BLI_filereader_new_memory(compressed.data(), compressed.size()));
+  ASSERT_NE(reader, nullptr);
+  ASSERT_NE(reader->seek, nullptr);
+
+  const int64_t offsets[] = {42000, 500, 999, 49500, 13000, 13999, 0, 20000, 21000};
+  for (const int64_t offset : offsets) {
+    char buffer[1500];
+    const int64_t size = std::min<int64_t>(sizeof(buffer), data.size() - offset);
+    ASSERT_EQ(reader->seek(reader, offset, SEEK_SET), offset);
+    ASSERT_EQ(reader->read(reader, buffer, size), size);
+    EXPECT_EQ(Span<char>(buffer, size), data.as_span().slice(offset, size));
+  }
+
+  reader->close(reader);
+}
+
+}  // namespace blender::tests
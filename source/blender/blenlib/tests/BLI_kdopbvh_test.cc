@@ -8,8 +8,11 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_compiler_attrs.h"
+#include "BLI_index_mask.hh"
 #include "BLI_kdopbvh.hh"
+#include "BLI_math_geom.h"
 #include "BLI_math_vector.h"
 #include "BLI_rand.h"
 
@@ -134,3 +137,164 @@ TEST(kdopbvh, OptimalFindNearest_500)
 {
   find_nearest_points_test(500, 1.0, 1000, 12, true);
 }
+
+TEST(kdopbvh, SurfaceAreaCost)
+{
+  const int points_len = 1000;
+  RNG *rng = BLI_rng_new(42);
+  float (*points)[3] = MEM_malloc_arrayN<float[3]>(size_t(points_len), __func__);
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 4, 6);
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BLI_bvhtree_balance(tree);
+  const float build_cost = BLI_bvhtree_get_surface_area_cost(tree);
+  EXPECT_GT(build_cost, 1.0f);
+
+  /* The cost doesn't depend on the scale of the tree. */
+  for (int i = 0; i < points_len; i++) {
+    mul_v3_fl(points[i], 2.0f);
+    BLI_bvhtree_update_node(tree, i, points[i], nullptr, 1);
+  }
+  BLI_bvhtree_update_tree(tree);
+  EXPECT_NEAR(BLI_bvhtree_get_surface_area_cost(tree), build_cost, build_cost * 1e-4f);
+
+  /* Moving the points to unrelated positions makes the refit tree much worse. */
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_update_node(tree, i, points[i], nullptr, 1);
+  }
+  BLI_bvhtree_update_tree(tree);
+  EXPECT_GT(BLI_bvhtree_get_surface_area_cost(tree), build_cost * 2.0f);
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+}
+
+TEST(kdopbvh, Copy)
+{
+  const int points_len = 500;
+  RNG *rng = BLI_rng_new(7);
+  float (*points)[3] = MEM_malloc_arrayN<float[3]>(size_t(points_len), __func__);
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 4, 8);
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BLI_bvhtree_balance(tree);
+
+  BVHTree *copy = BLI_bvhtree_copy(tree);
+  EXPECT_EQ(BLI_bvhtree_get_len(copy), points_len);
+
+  /* Refitting the copy doesn't change the original. */
+  const float offset[3] = {10.0f, 0.0f, 0.0f};
+  for (int i = 0; i < points_len; i++) {
+    float co[3];
+    add_v3_v3v3(co, points[i], offset);
+    BLI_bvhtree_update_node(copy, i, co, nullptr, 1);
+  }
+  BLI_bvhtree_update_tree(copy);
+
+  BLI_bvhtree_free(tree);
+  for (int i = 0; i < points_len; i++) {
+    float co[3];
+    add_v3_v3v3(co, points[i], offset);
+    const int j = BLI_bvhtree_find_nearest(copy, co, nullptr, nullptr, nullptr);
+    EXPECT_GE(j, 0);
+    EXPECT_EQ_ARRAY(points[i], points[j], 3);
+  }
+
+  BLI_bvhtree_free(copy);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+}
+
+/* -------------------------------------------------------------------- */
+/* Batched Queries */
+
+/** Compare batched queries against one query per position, with enough positions to sort them. */
+static void batch_queries_test(const int points_len, const int queries_len, const bool use_mask)
+{
+  using namespace blender;
+  RNG *rng = BLI_rng_new(points_len);
+  Array<float3> points(points_len);
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 8, 8);
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BLI_bvhtree_balance(tree);
+
+  Array<float3> positions(queries_len);
+  Array<float3> directions(queries_len);
+  for (int i = 0; i < queries_len; i++) {
+    rng_v3_round(positions[i], 3, rng, 1000, 1.0f);
+    rng_v3_round(directions[i], 3, rng, 1000, 1.0f);
+    normalize_v3(directions[i]);
+  }
+
+  IndexMaskMemory memory;
+  const IndexMask mask = use_mask ? IndexMask::from_predicate(positions.index_range(),
+                                                              GrainSize(1024),
+                                                              memory,
+                                                              [](const int i) { return i % 3; }) :
+                                    IndexMask(queries_len);
+
+  Array<BVHTreeNearest> nearest(queries_len);
+  Array<BVHTreeNearest> nearest_bounded(queries_len);
+  for (const int i : positions.index_range()) {
+    nearest[i].index = -1;
+    nearest[i].dist_sq = FLT_MAX;
+    nearest_bounded[i] = nearest[i];
+  }
+  BLI_bvhtree_find_nearest_batch(*tree, mask, positions, nearest, nullptr, nullptr);
+  BLI_bvhtree_find_nearest_batch(*tree, mask, positions, nearest_bounded, nullptr, nullptr, true);
+
+  Array<BVHTreeRayHit> hits(queries_len);
+  for (BVHTreeRayHit &hit : hits) {
+    hit.index = -1;
+    hit.dist = BVH_RAYCAST_DIST_MAX;
+  }
+  BLI_bvhtree_ray_cast_batch(*tree, mask, positions, directions, 0.1f, hits, nullptr, nullptr);
+
+  for (const int i : positions.index_range()) {
+    if (!mask.contains(i)) {
+      EXPECT_EQ(nearest[i].index, -1);
+      EXPECT_EQ(nearest_bounded[i].index, -1);
+      EXPECT_EQ(hits[i].index, -1);
+      continue;
+    }
+    const int index = BLI_bvhtree_find_nearest(tree, positions[i], nullptr, nullptr, nullptr);
+    EXPECT_EQ(nearest[i].index, index);
+    ASSERT_NE(nearest_bounded[i].index, -1);
+    /* Points can be equally near, so only compare the distance when the search is bounded by the
+     * previous position. */
+    EXPECT_FLOAT_EQ(len_squared_v3v3(positions[i], points[nearest_bounded[i].index]),
+                    len_squared_v3v3(positions[i], points[index]));
+
+    BVHTreeRayHit hit;
+    hit.index = -1;
+    hit.dist = BVH_RAYCAST_DIST_MAX;
+    BLI_bvhtree_ray_cast(tree, positions[i], directions[i], 0.1f, &hit, nullptr, nullptr);
+    EXPECT_EQ(hits[i].index, hit.index);
+    EXPECT_FLOAT_EQ(hits[i].dist, hit.dist);
+  }
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+}
+
+TEST(kdopbvh, BatchQueries_Small)
+{
+  batch_queries_test(100, 50, false);
+}
+TEST(kdopbvh, BatchQueries_Sorted)
+{
+  batch_queries_test(1000, 20000, false);
+}
+TEST(kdopbvh, BatchQueries_SortedMask)
+{
+  batch_queries_test(1000, 20000, true);
+}
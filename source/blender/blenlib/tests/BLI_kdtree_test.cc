@@ -4,8 +4,16 @@
 
 #include "testing/testing.h"
 
+#include "MEM_guardedalloc.h"
+
+#include "BLI_array.hh"
+#include "BLI_index_mask.hh"
 #include "BLI_kdtree.hh"
+#include "BLI_math_vector.hh"
+#include "BLI_rand.hh"
+#include "BLI_vector.hh"
 
+#include <algorithm>
 #include <cmath>
 
 /* -------------------------------------------------------------------- */
@@ -63,3 +71,151 @@ TEST(kdtree, Deduplicate)
 {
   deduplicate_test();
 }
+
+/* Points inserted in sorted order used to make balancing quadratic. Use enough points to balance
+ * sub-trees in parallel. */
+TEST(kdtree, BalanceSorted)
+{
+  const int points_num = 20000;
+  blender::KDTree_1d *tree = blender::BLI_kdtree_1d_new(points_num);
+  for (int i = 0; i < points_num; i++) {
+    const float co[1] = {float(i)};
+    blender::BLI_kdtree_1d_insert(tree, i, co);
+  }
+  blender::BLI_kdtree_1d_balance(tree);
+  for (int i = 0; i < points_num; i += 7) {
+    const float co[1] = {float(i) + 0.25f};
+    EXPECT_EQ(blender::BLI_kdtree_1d_find_nearest(tree, co, nullptr), i);
+  }
+  blender::BLI_kdtree_1d_free(tree);
+}
+
+static blender::Array<blender::float3> random_points(const int points_num, const int seed)
+{
+  blender::RandomNumberGenerator rng(seed);
+  blender::Array<blender::float3> points(points_num);
+  for (blender::float3 &point : points) {
+    point = blender::float3(rng.get_float(), rng.get_float(), rng.get_float());
+  }
+  return points;
+}
+
+TEST(kdtree, FindNearest)
+{
+  using namespace blender;
+  const int points_num = 2000;
+  const Array<float3> points = random_points(points_num, 0);
+  const Array<float3> queries = random_points(200, 1);
+
+  KDTree_3d *tree = BLI_kdtree_3d_new(points_num);
+  for (const int i : points.index_range()) {
+    BLI_kdtree_3d_insert(tree, i, points[i]);
+  }
+  BLI_kdtree_3d_balance(tree);
+
+  for (const float3 &query : queries) {
+    Array<int> sorted_indices(points_num);
+    for (const int i : points.index_range()) {
+      sorted_indices[i] = i;
+    }
+    std::sort(sorted_indices.begin(), sorted_indices.end(), [&](const int a, const int b) {
+      return math::distance_squared(query, points[a]) < math::distance_squared(query, points[b]);
+    });
+
+    EXPECT_EQ(BLI_kdtree_3d_find_nearest(tree, query, nullptr), sorted_indices[0]);
+
+    /* Skip the nearest point with the filter callback. */
+    EXPECT_EQ(BLI_kdtree_3d_find_nearest_cb_cpp(
+                  tree,
+                  query,
+                  nullptr,
+                  [&](const int index, const float * /*co*/, const float /*dist_sq*/) {
+                    return index == sorted_indices[0] ? 0 : 1;
+                  }),
+              sorted_indices[1]);
+
+    KDTreeNearest_3d nearest[10];
+    EXPECT_EQ(BLI_kdtree_3d_find_nearest_n(tree, query, nearest, 10), 10);
+    for (const int i : IndexRange(10)) {
+      EXPECT_EQ(nearest[i].index, sorted_indices[i]);
+    }
+  }
+  BLI_kdtree_3d_free(tree);
+}
+
+TEST(kdtree, FindNearestNBatch)
+{
+  using namespace blender;
+  const int points_num = 20000;
+  const int queries_num = 1000;
+  const int nearest_len = 5;
+  const Array<float3> points = random_points(points_num, 0);
+  const Array<float3> queries = random_points(queries_num, 1);
+
+  KDTree_3d *tree = BLI_kdtree_3d_new(points_num);
+  for (const int i : points.index_range()) {
+    BLI_kdtree_3d_insert(tree, i, points[i]);
+  }
+  BLI_kdtree_3d_balance(tree);
+
+  IndexMaskMemory memory;
+  const IndexMask mask = IndexMask::from_predicate(
+      queries.index_range(), GrainSize(1024), memory, [](const int i) { return i % 3 != 0; });
+  Array<KDTreeNearest_3d> nearest(queries_num * nearest_len);
+  Array<int> nearest_num(queries_num, -1);
+  BLI_kdtree_3d_find_nearest_n_batch(tree, mask, queries, nearest_len, nearest, nearest_num);
+
+  for (const int i : queries.index_range()) {
+    if (!mask.contains(i)) {
+      EXPECT_EQ(nearest_num[i], -1);
+      continue;
+    }
+    KDTreeNearest_3d expected[nearest_len];
+    EXPECT_EQ(nearest_num[i],
+              BLI_kdtree_3d_find_nearest_n(tree, queries[i], expected, nearest_len));
+    for (const int j : IndexRange(nearest_num[i])) {
+      EXPECT_EQ(nearest[i * nearest_len + j].index, expected[j].index);
+    }
+  }
+  BLI_kdtree_3d_free(tree);
+}
+
+TEST(kdtree, RangeSearchBatch)
+{
+  using namespace blender;
+  const int points_num = 20000;
+  const int queries_num = 1000;
+  const float range = 0.05f;
+  const Array<float3> points = random_points(points_num, 0);
+  const Array<float3> queries = random_points(queries_num, 1);
+
+  KDTree_3d *tree = BLI_kdtree_3d_new(points_num);
+  for (const int i : points.index_range()) {
+    BLI_kdtree_3d_insert(tree, i, points[i]);
+  }
+  BLI_kdtree_3d_balance(tree);
+
+  Array<Vector<int>> found(queries_num);
+  BLI_kdtree_3d_range_search_batch(tree,
+                                   queries.index_range(),
+                                   queries,
+                                   range,
+                                   [&](const int64_t i, const Span<KDTreeNearest_3d> nearest) {
+                                     for (const KDTreeNearest_3d &item : nearest) {
+                                       found[i].append(item.index);
+                                     }
+                                   });
+
+  for (const int i : queries.index_range()) {
+    KDTreeNearest_3d *expected = nullptr;
+    const int expected_num = BLI_kdtree_3d_range_search(tree, queries[i], &expected, range);
+    ASSERT_EQ(found[i].size(), expected_num);
+    for (const int j : IndexRange(expected_num)) {
+      EXPECT_EQ(found[i][j], expected[j].index);
+    }
+    if (expected) {
+      MEM_freeN(expected);
+    }
+  }
+  BLI_kdtree_3d_free(tree);
+}
@@ -14,6 +14,7 @@
 #include "BLI_mempool.h"
 #include "BLI_task.h"
 #include "BLI_task.hh"
+#include "BLI_task_statistics.hh"
 
 #define ITEMS_NUM 10000
 
@@ -243,3 +244,37 @@ TEST(task, ParallelInvoke)
                                       [&]() { counter++; });
   EXPECT_EQ(counter, 6);
 }
+
+TEST(task, Statistics)
+{
+  using namespace blender;
+  namespace statistics = threading::statistics;
+  statistics::reset();
+  statistics::set_enabled(true);
+  std::atomic<int64_t> sum = 0;
+  threading::parallel_for(IndexRange(ITEMS_NUM), 100, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      sum += i;
+    }
+  });
+  statistics::set_enabled(false);
+  const Vector<statistics::CallSiteStatistics> all_statistics = statistics::get_all();
+  statistics::reset();
+
+  EXPECT_EQ(sum, int64_t(ITEMS_NUM) * (ITEMS_NUM - 1) / 2);
+  if (!statistics::is_available()) {
+    EXPECT_TRUE(all_statistics.is_empty());
+    return;
+  }
+  ASSERT_EQ(all_statistics.size(), 1);
+  const statistics::CallSiteStatistics &call_site = all_statistics[0];
+  EXPECT_EQ(call_site.type, statistics::CallSiteType::ParallelFor);
+  EXPECT_EQ(call_site.calls, 1);
+  EXPECT_EQ(call_site.elements, ITEMS_NUM);
+  EXPECT_EQ(call_site.grain_size_min, 100);
+  EXPECT_EQ(call_site.grain_size_max, 100);
+  EXPECT_EQ(call_site.nested_calls, 0);
+  EXPECT_GE(call_site.tasks, 1);
+  EXPECT_GE(call_site.peak_concurrency, 1);
+  EXPECT_GE(call_site.wall_time, call_site.busy_time / BLI_task_scheduler_num_threads());
+}
@@ -0,0 +1,163 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_kdopbvh.hh"
+#include "BLI_math_geom.h"
+#include "BLI_math_vector.h"
+#include "BLI_math_vector.hh"
+#include "BLI_rand.hh"
+#include "BLI_task.hh"
+#include "BLI_timeit.hh"
+#include "BLI_vector.hh"
+
+#include <array>
+
+#include <fmt/format.h>
+
+namespace blender::tests {
+
+using Triangle = std::array<float3, 3>;
+
+/** Evenly tessellated UV sphere. */
+static Vector<Triangle> create_sphere_triangles(const int tris_num)
+{
+  const int rings_num = std::max(int(std::sqrt(float(tris_num / 4))), 2);
+  const int segments_num = rings_num * 2;
+  auto vert = [&](const int ring, const int segment) {
+    const float theta = float(M_PI) * float(ring) / float(rings_num);
+    const float phi = 2.0f * float(M_PI) * float(segment) / float(segments_num);
+    return float3(
+        std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+  };
+  Vector<Triangle> tris;
+  for (const int ring : IndexRange(rings_num)) {
+    for (const int segment : IndexRange(segments_num)) {
+      const float3 a = vert(ring, segment);
+      const float3 b = vert(ring + 1, segment);
+      const float3 c = vert(ring + 1, segment + 1);
+      const float3 d = vert(ring, segment + 1);
+      tris.append({a, b, c});
+      tris.append({a, c, d});
+    }
+  }
+  return tris;
+}
+
+static void raycast_callback(void *userdata,
+                             const int index,
+                             const BVHTreeRay *ray,
+                             BVHTreeRayHit *hit)
+{
+  const Span<Triangle> tris = *static_cast<const Span<Triangle> *>(userdata);
+  const Triangle &tri = tris[index];
+  float dist;
+  if (isect_ray_tri_v3(ray->origin, ray->direction, tri[0], tri[1], tri[2], &dist, nullptr) &&
+      dist < hit->dist)
+  {
+    hit->index = index;
+    hit->dist = dist;
+  }
+}
+
+static void nearest_callback(void *userdata,
+                             const int index,
+                             const float co[3],
+                             BVHTreeNearest *nearest)
+{
+  const Span<Triangle> tris = *static_cast<const Span<Triangle> *>(userdata);
+  const Triangle &tri = tris[index];
+  float3 closest;
+  closest_on_tri_to_point_v3(closest, co, tri[0], tri[1], tri[2]);
+  const float dist_sq = len_squared_v3v3(co, closest);
+  if (dist_sq < nearest->dist_sq) {
+    nearest->index = index;
+    nearest->dist_sq = dist_sq;
+    copy_v3_v3(nearest->co, closest);
+  }
+}
+
+/**
+ * Compare queries in a #threading::parallel_for, as done by most callers, with batched queries.
+ * The positions are close to the surface like for shrink-wrapping, but in random order like the
+ * points of a scattered point cloud.
+ */
+static void bvhtree_batch_queries_benchmark(Span<Triangle> tris, const int queries_num)
+{
+  BVHTree *tree = BLI_bvhtree_new(tris.size(), 0.0f, 4, 26);
+  for (const int i : tris.index_range()) {
+    BLI_bvhtree_insert(tree, i, &tris[i][0][0], 3);
+  }
+  BLI_bvhtree_balance(tree);
+
+  RandomNumberGenerator rng(queries_num);
+  Array<float3> positions(queries_num);
+  Array<float3> directions(queries_num);
+  for (const int i : IndexRange(queries_num)) {
+    positions[i] = rng.get_unit_float3() * (1.0f + 0.1f * rng.get_float());
+    directions[i] = math::normalize(-positions[i] + rng.get_unit_float3() * 0.1f);
+  }
+  const IndexMask mask(queries_num);
+
+  fmt::print("{} triangles, {} queries\n", tris.size(), queries_num);
+  Array<BVHTreeNearest> nearest(queries_num);
+  Array<BVHTreeRayHit> hits(queries_num);
+  auto reset_results = [&]() {
+    for (const int i : IndexRange(queries_num)) {
+      nearest[i].index = -1;
+      nearest[i].dist_sq = FLT_MAX;
+      hits[i].index = -1;
+      hits[i].dist = BVH_RAYCAST_DIST_MAX;
+    }
+  };
+
+  reset_results();
+  {
+    SCOPED_TIMER("Single ray cast");
+    threading::parallel_for(IndexRange(queries_num), 256, [&](const IndexRange range) {
+      for (const int i : range) {
+        BLI_bvhtree_ray_cast(
+            tree, positions[i], directions[i], 0.0f, &hits[i], raycast_callback, &tris);
+      }
+    });
+  }
+  {
+    SCOPED_TIMER("Single find nearest");
+    threading::parallel_for(IndexRange(queries_num), 256, [&](const IndexRange range) {
+      for (const int i : range) {
+        BLI_bvhtree_find_nearest(tree, positions[i], &nearest[i], nearest_callback, &tris);
+      }
+    });
+  }
+
+  reset_results();
+  {
+    SCOPED_TIMER("Batch ray cast");
+    BLI_bvhtree_ray_cast_batch(
+        *tree, mask, positions, directions, 0.0f, hits, raycast_callback, &tris);
+  }
+  {
+    SCOPED_TIMER("Batch find nearest");
+    BLI_bvhtree_find_nearest_batch(*tree, mask, positions, nearest, nearest_callback, &tris);
+  }
+
+  reset_results();
+  {
+    SCOPED_TIMER("Batch find nearest from previous");
+    BLI_bvhtree_find_nearest_batch(
+        *tree, mask, positions, nearest, nearest_callback, &tris, true);
+  }
+
+  BLI_bvhtree_free(tree);
+}
+
+TEST(kdopbvh, BatchQueriesSphere_1M)
+{
+  bvhtree_batch_queries_benchmark(create_sphere_triangles(1000000), 200000);
+}
+
+}  // namespace blender::tests
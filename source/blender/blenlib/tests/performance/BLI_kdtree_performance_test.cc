@@ -0,0 +1,127 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_array.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_kdtree.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_rand.hh"
+#include "BLI_task.hh"
+#include "BLI_timeit.hh"
+
+#include <algorithm>
+
+#include <fmt/format.h>
+
+namespace blender::tests {
+
+/* Run the longest tests! */
+// #define USE_BIG_TESTS
+
+static Array<float3> create_random_points(const int points_num, const int seed)
+{
+  RandomNumberGenerator rng(seed);
+  Array<float3> points(points_num);
+  for (float3 &point : points) {
+    point = float3(rng.get_float(), rng.get_float(), rng.get_float());
+  }
+  return points;
+}
+
+/**
+ * Compare queries in a #threading::parallel_for, as done by most callers, with batched queries.
+ * \param sort_points: Insert the points sorted along the first axis, like vertices of a mesh
+ * that were generated row by row.
+ */
+static void kdtree_benchmark(const int points_num, const int queries_num, const bool sort_points)
+{
+  Array<float3> points = create_random_points(points_num, 0);
+  if (sort_points) {
+    std::sort(points.begin(), points.end(), [](const float3 &a, const float3 &b) {
+      return a.x < b.x;
+    });
+  }
+  const Array<float3> queries = create_random_points(queries_num, 1);
+  const IndexMask mask(queries_num);
+  /* Search about as many neighbors in range as with the nearest points. */
+  const float radius = std::cbrt(8.0f / float(points_num));
+  const int nearest_len = 8;
+
+  fmt::print("{} points, {} queries\n", points_num, queries_num);
+  KDTree_3d *tree = BLI_kdtree_3d_new(points_num);
+  {
+    SCOPED_TIMER("Build");
+    for (const int i : points.index_range()) {
+      BLI_kdtree_3d_insert(tree, i, points[i]);
+    }
+    BLI_kdtree_3d_balance(tree);
+  }
+
+  Array<KDTreeNearest_3d> nearest(queries_num * nearest_len);
+  Array<int> nearest_num(queries_num);
+  {
+    SCOPED_TIMER("Single find nearest n");
+    threading::parallel_for(queries.index_range(), 256, [&](const IndexRange range) {
+      for (const int i : range) {
+        nearest_num[i] = BLI_kdtree_3d_find_nearest_n(
+            tree, queries[i], &nearest[i * nearest_len], nearest_len);
+      }
+    });
+  }
+  {
+    SCOPED_TIMER("Batch find nearest n");
+    BLI_kdtree_3d_find_nearest_n_batch(tree, mask, queries, nearest_len, nearest, nearest_num);
+  }
+
+  Array<int> found_num(queries_num);
+  {
+    SCOPED_TIMER("Single range search");
+    threading::parallel_for(queries.index_range(), 256, [&](const IndexRange range) {
+      for (const int i : range) {
+        KDTreeNearest_3d *found = nullptr;
+        found_num[i] = BLI_kdtree_3d_range_search(tree, queries[i], &found, radius);
+        if (found) {
+          MEM_freeN(found);
+        }
+      }
+    });
+  }
+  {
+    SCOPED_TIMER("Batch range search");
+    BLI_kdtree_3d_range_search_batch(
+        tree, mask, queries, radius, [&](const int64_t i, const Span<KDTreeNearest_3d> found) {
+          found_num[i] = int(found.size());
+        });
+  }
+
+  BLI_kdtree_3d_free(tree);
+}
+
+TEST(kdtree, Random_1M)
+{
+  kdtree_benchmark(1000000, 1000000, false);
+}
+
+TEST(kdtree, Sorted_1M)
+{
+  kdtree_benchmark(1000000, 1000000, true);
+}
+
+#ifdef USE_BIG_TESTS
+TEST(kdtree, Random_10M)
+{
+  kdtree_benchmark(10000000, 1000000, false);
+}
+
+TEST(kdtree, Random_100M)
+{
+  kdtree_benchmark(100000000, 1000000, false);
+}
+#endif
+
+}  // namespace blender::tests
@@ -361,6 +361,22 @@ blender::ImplicitSharingInfoAndData blo_read_shared_impl(
     const void **ptr_p,
     blender::FunctionRef<const blender::ImplicitSharingInfo *()> read_fn);
 
+/**
+ * Share the data at the given old address directly with the memory-mapped blend-file instead of
+ * reading it into a new allocation. Only meant to be used in the read function passed to
+ * #BLO_read_shared, for arrays of trivial types that don't need any processing after reading.
+ *
+ * \return The sharing-info owning the data, or null if the data cannot be shared with the file
+ * (e.g. because the file is compressed, or memory-mapped reading is disabled). In that case the
+ * data has to be read as usual.
+ *
+ * \note The data may still be modified in place when it is not shared, the mapping is
+ * copy-on-write.
+ */
+const blender::ImplicitSharingInfo *BLO_read_data_address_mapped(BlendDataReader *reader,
+                                                                 const void **ptr_p,
+                                                                 int64_t expected_size);
+
 /**
  * Check if there is any shared data for the given data pointer. If yes, return the existing
  * sharing-info. If not, call the provided function to actually read the data now.
@@ -115,6 +115,20 @@ void BLO_memfile_merge(MemFile *first, MemFile *second);
  */
 void BLO_memfile_clear_future(MemFile *memfile);
 
+/**
+ * Memory usage of the buffers of all memfile chunks, which are shared between all undo steps
+ * based on their content.
+ */
+struct MemFileChunkStoreStats {
+  int64_t buffers_num;
+  /** Memory used by the buffers. */
+  size_t size;
+  /** Memory saved by sharing buffers between chunks. */
+  size_t size_shared;
+};
+
+MemFileChunkStoreStats BLO_memfile_chunk_store_stats();
+
 /* Utilities. */
 
 Main *BLO_memfile_main_get(MemFile *memfile, Main *bmain, Scene **r_scene);
@@ -11,6 +11,7 @@
 
 #include "BLI_sys_types.h"
 
+struct BlendFileJournal;
 struct BlendThumbnail;
 struct Main;
 struct MemFile;
@@ -62,3 +63,41 @@ extern bool BLO_write_file(Main *mainvar,
 extern bool BLO_write_file_mem(Main *mainvar, MemFile *compare, MemFile *current, int write_flags);
 
 /** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name BLO Auto-Save Journal API
+ *
+ * Incremental auto-save: only the data of IDs which changed since the previous write is added to
+ * the journal file, on a background thread.
+ * \{ */
+
+BlendFileJournal *BLO_journal_new(const char *filepath);
+/** Waits for any pending write to finish. */
+void BLO_journal_free(BlendFileJournal *journal);
+const char *BLO_journal_filepath(const BlendFileJournal *journal);
+
+enum class BlendFileJournalWriteResult {
+  /** Writing the changed data has been queued. */
+  Queued,
+  /** The previous write is still in progress, nothing has been done. */
+  Busy,
+  /** Serializing the file failed. */
+  Error,
+};
+
+/**
+ * Serialize \a mainvar and queue writing the changed data to the journal.
+ * Errors while writing the journal file itself are reported in the console.
+ */
+BlendFileJournalWriteResult BLO_journal_write(BlendFileJournal *journal,
+                                              Main *mainvar,
+                                              int write_flags);
+
+/**
+ * Write the latest complete state stored in the journal as a regular (uncompressed) blend-file.
+ *
+ * \return Success.
+ */
+bool BLO_journal_restore(const char *journal_filepath, const char *filepath, ReportList *reports);
+
+/** \} */
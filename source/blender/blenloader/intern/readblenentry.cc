@@ -60,7 +60,7 @@ BlendHandle *BLO_blendhandle_from_file(const char *filepath, BlendFileReadReport
 {
   BlendHandle *bh;
 
-  bh = (BlendHandle *)blo_filedata_from_file(filepath, reports);
+  bh = (BlendHandle *)blo_filedata_from_library_file(filepath, reports);
 
   return bh;
 }
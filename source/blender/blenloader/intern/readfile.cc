@@ -8,6 +8,7 @@
 
 #include "fmt/core.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <cstdarg> /* for va_start/end. */
 #include <cstddef> /* for offsetof. */
@@ -52,21 +53,29 @@
 #include "BLI_endian_defines.h"
 #include "BLI_fileops.h"
 #include "BLI_ghash.h"
+#include "BLI_hash.hh"
+#include "BLI_implicit_sharing.hh"
 #include "BLI_map.hh"
 #include "BLI_memarena.h"
+#include "BLI_mmap.h"
+#include "BLI_path_utils.hh"
 #include "BLI_set.hh"
 #include "BLI_string.h"
 #include "BLI_string_ref.hh"
 #include "BLI_string_utf8.h"
 #include "BLI_string_utils.hh"
+#include "BLI_system.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_time.h"
 #include "BLI_utildefines.h"
+#include BLI_SYSTEM_PID_H
 
 #include "BLT_translation.hh"
 
 #include "BKE_anim_data.hh"
 #include "BKE_animsys.h"
+#include "BKE_appdir.hh"
 #include "BKE_asset.hh"
 #include "BKE_blender_version.h"
 #include "BKE_collection.hh"
@@ -1113,6 +1122,309 @@ static void long_id_names_process_action_slots_identifiers(Main *bmain)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name BHead Index Cache
+ *
+ * Building the list of #BHead's of a library file requires scanning the whole file (and
+ * decompressing it, for compressed files), even when only a few IDs are linked from it.
+ *
+ * To avoid this, the headers of all blocks of large library files are stored in a cache file the
+ * first time they are read. The data of #BLO_CODE_DATA blocks is not stored in the index, it is
+ * read from the library file on demand (see #USE_BHEAD_READ_ON_DEMAND). The data of all other
+ * blocks (IDs, DNA, globals...) is stored in the index as well, since it is needed to look up IDs
+ * by name, and to decode the rest of the file.
+ *
+ * The index files are stored in `BKE_appdir_folder_caches/blend-bhead-indices/`, and are
+ * validated against the size and modification time (with the precision of the file system) of
+ * the library file. The least recently used index files are removed when their total size gets
+ * too large.
+ * \{ */
+
+#ifdef USE_BHEAD_READ_ON_DEMAND
+
+/** Smaller library files are cheap enough to scan, don't create an index for them. */
+#  define BHEAD_INDEX_MIN_FILE_SIZE (16 << 20)
+/** Increase when changing the layout of the index file. */
+#  define BHEAD_INDEX_VERSION 2
+/** Upper bound of the total size of all index files. */
+#  define BHEAD_INDEX_CACHE_MAX_SIZE (int64_t(1) << 30)
+/** Temporary files older than this (in seconds) are left over from crashed writes. */
+#  define BHEAD_INDEX_TMP_FILE_MAX_AGE (60 * 60)
+
+struct BHeadIndexHeader {
+  char magic[8];
+  int version;
+  BlenderHeader blender_header;
+  int64_t file_size;
+  /** Modification time in nanoseconds, see #bhead_index_file_mtime_ns. */
+  int64_t file_mtime_ns;
+  int64_t bheads_num;
+};
+
+struct BHeadIndexEntry {
+  BHead bhead;
+  /**
+   * Offset of the data in the (uncompressed) library file, or zero when the data directly follows
+   * this entry in the index file.
+   */
+  int64_t file_offset;
+};
+
+static const char bhead_index_magic[8] = {'B', 'L', 'E', 'N', 'D', 'I', 'D', 'X'};
+
+static bool bhead_index_is_supported(const FileData *fd)
+{
+  return (fd->file->seek != nullptr) && fd->file_stat.has_value() &&
+         (fd->file_stat->st_size >= BHEAD_INDEX_MIN_FILE_SIZE);
+}
+
+static bool bhead_index_dirpath_get(char *r_dirpath, const size_t maxncpy)
+{
+  if (!BKE_appdir_folder_caches(r_dirpath, maxncpy)) {
+    return false;
+  }
+  BLI_path_append(r_dirpath, maxncpy, "blend-bhead-indices");
+  return true;
+}
+
+static bool bhead_index_filepath_get(const FileData *fd, char *r_filepath, const size_t maxncpy)
+{
+  char dirpath[FILE_MAX];
+  if (!bhead_index_dirpath_get(dirpath, sizeof(dirpath))) {
+    return false;
+  }
+
+  const std::string filename = fmt::format("{:016x}_{}.bhead_index",
+                                           blender::get_default_hash(
+                                               blender::StringRef(fd->relabase)),
+                                           BLI_path_basename(fd->relabase));
+  BLI_path_join(r_filepath, maxncpy, dirpath, filename.c_str());
+  return true;
+}
+
+/**
+ * Saving a file within the same second as the previous save is common (e.g. from scripts), so the
+ * modification time in seconds is not enough to detect changes.
+ */
+static int64_t bhead_index_file_mtime_ns(const BLI_stat_t &stat)
+{
+#  if defined(WIN32)
+  /* Only seconds are available. */
+  return int64_t(stat.st_mtime) * 1000000000;
+#  elif defined(__APPLE__)
+  return int64_t(stat.st_mtimespec.tv_sec) * 1000000000 + int64_t(stat.st_mtimespec.tv_nsec);
+#  else
+  return int64_t(stat.st_mtim.tv_sec) * 1000000000 + int64_t(stat.st_mtim.tv_nsec);
+#  endif
+}
+
+static void bhead_index_header_init(const FileData *fd, BHeadIndexHeader *header)
+{
+  memset(header, 0, sizeof(*header));
+  memcpy(header->magic, bhead_index_magic, sizeof(header->magic));
+  header->version = BHEAD_INDEX_VERSION;
+  header->blender_header = fd->blender_header;
+  header->file_size = int64_t(fd->file_stat->st_size);
+  header->file_mtime_ns = bhead_index_file_mtime_ns(*fd->file_stat);
+}
+
+/**
+ * Fill the #BHead list of the given (not yet scanned) file from its index, if a valid one exists.
+ * On failure, the file data is left untouched, and the file has to be scanned as usual.
+ */
+static bool bhead_index_read(FileData *fd)
+{
+  BLI_assert(BLI_listbase_is_empty(&fd->bhead_list) && !fd->is_eof);
+  if (!bhead_index_is_supported(fd)) {
+    return false;
+  }
+  char index_filepath[FILE_MAX];
+  if (!bhead_index_filepath_get(fd, index_filepath, sizeof(index_filepath))) {
+    return false;
+  }
+  FILE *file = BLI_fopen(index_filepath, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  BHeadIndexHeader header_expected;
+  bhead_index_header_init(fd, &header_expected);
+  BHeadIndexHeader header;
+  bool success = (fread(&header, sizeof(header), 1, file) == 1) &&
+                 memcmp(header.magic, header_expected.magic, sizeof(header.magic)) == 0 &&
+                 header.version == header_expected.version &&
+                 header.blender_header.pointer_size ==
+                     header_expected.blender_header.pointer_size &&
+                 header.blender_header.endian == header_expected.blender_header.endian &&
+                 header.blender_header.file_version ==
+                     header_expected.blender_header.file_version &&
+                 header.blender_header.file_format_version ==
+                     header_expected.blender_header.file_format_version &&
+                 header.file_size == header_expected.file_size &&
+                 header.file_mtime_ns == header_expected.file_mtime_ns && header.bheads_num > 0;
+
+  ListBase bhead_list = {nullptr, nullptr};
+  for (int64_t i = 0; success && i < header.bheads_num; i++) {
+    BHeadIndexEntry entry;
+    if (fread(&entry, sizeof(entry), 1, file) != 1 || entry.bhead.len < 0) {
+      success = false;
+      break;
+    }
+
+    BHeadN *new_bhead;
+    if (entry.file_offset != 0) {
+      if (!BHEAD_USE_READ_ON_DEMAND(&entry.bhead)) {
+        success = false;
+        break;
+      }
+      new_bhead = MEM_mallocN<BHeadN>("new_bhead");
+      new_bhead->file_offset = entry.file_offset;
+      new_bhead->has_data = false;
+    }
+    else {
+      new_bhead = static_cast<BHeadN *>(
+          MEM_mallocN(sizeof(BHeadN) + size_t(entry.bhead.len), "new_bhead"));
+      if (fread(new_bhead + 1, size_t(entry.bhead.len), 1, file) != 1 && entry.bhead.len != 0) {
+        MEM_freeN(new_bhead);
+        success = false;
+        break;
+      }
+      new_bhead->file_offset = 0;
+      new_bhead->has_data = true;
+    }
+    new_bhead->next = new_bhead->prev = nullptr;
+    new_bhead->is_memchunk_identical = false;
+    new_bhead->bhead = entry.bhead;
+    BLI_addtail(&bhead_list, new_bhead);
+  }
+  fclose(file);
+
+  if (!success) {
+    BLI_freelistN(&bhead_list);
+    CLOG_DEBUG(&LOG, "Ignoring outdated or invalid BHead index '%s'", index_filepath);
+    return false;
+  }
+
+  /* All blocks are known now, the file itself is only read for the data of #BLO_CODE_DATA
+   * blocks. */
+  fd->bhead_list = bhead_list;
+  fd->is_eof = true;
+  /* The modification time of index files tells which were used least recently, see
+   * #bhead_index_prune. */
+  BLI_file_touch(index_filepath);
+  CLOG_DEBUG(&LOG, "Read BHead index '%s' for '%s'", index_filepath, fd->relabase);
+  return true;
+}
+
+/**
+ * Remove the least recently used index files until the total size is within
+ * #BHEAD_INDEX_CACHE_MAX_SIZE, as well as temporary files of interrupted writes.
+ */
+static void bhead_index_prune()
+{
+  char dirpath[FILE_MAX];
+  if (!bhead_index_dirpath_get(dirpath, sizeof(dirpath))) {
+    return;
+  }
+  direntry *entries = nullptr;
+  const uint entries_num = BLI_filelist_dir_contents(dirpath, &entries);
+  const int64_t now = int64_t(time(nullptr));
+
+  blender::Vector<const direntry *> index_files;
+  int64_t total_size = 0;
+  for (uint i = 0; i < entries_num; i++) {
+    const direntry &entry = entries[i];
+    if (!S_ISREG(entry.s.st_mode)) {
+      continue;
+    }
+    if (BLI_str_endswith(entry.relname, ".bhead_index")) {
+      index_files.append(&entry);
+      total_size += int64_t(entry.s.st_size);
+    }
+    else if (BLI_str_endswith(entry.relname, ".tmp") &&
+             now - int64_t(entry.s.st_mtime) > BHEAD_INDEX_TMP_FILE_MAX_AGE)
+    {
+      BLI_delete(entry.path, false, false);
+    }
+  }
+
+  if (total_size > BHEAD_INDEX_CACHE_MAX_SIZE) {
+    std::sort(index_files.begin(), index_files.end(), [](const direntry *a, const direntry *b) {
+      return a->s.st_mtime < b->s.st_mtime;
+    });
+    for (const direntry *entry : index_files) {
+      if (total_size <= BHEAD_INDEX_CACHE_MAX_SIZE) {
+        break;
+      }
+      if (BLI_delete(entry->path, false, false) == 0) {
+        total_size -= int64_t(entry->s.st_size);
+        CLOG_DEBUG(&LOG, "Removed least recently used BHead index '%s'", entry->path);
+      }
+    }
+  }
+
+  BLI_filelist_free(entries, entries_num);
+}
+
+/**
+ * Write the index of a file for which #bhead_index_read failed, to speed up the next reading.
+ */
+static void bhead_index_write(FileData *fd)
+{
+  if (!bhead_index_is_supported(fd)) {
+    return;
+  }
+  char index_filepath[FILE_MAX];
+  if (!bhead_index_filepath_get(fd, index_filepath, sizeof(index_filepath))) {
+    return;
+  }
+
+  /* Ensure the whole file has been scanned. */
+  BHeadIndexHeader header;
+  bhead_index_header_init(fd, &header);
+  for (BHead *bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
+    header.bheads_num++;
+  }
+
+  /* Write to a temporary file first, so that other Blender instances reading the same library
+   * never see an incomplete index. */
+  const std::string tmp_filepath = fmt::format("{}.{}.tmp", index_filepath, abs(getpid()));
+  if (!BLI_file_ensure_parent_dir_exists(tmp_filepath.c_str())) {
+    return;
+  }
+  FILE *file = BLI_fopen(tmp_filepath.c_str(), "wb");
+  if (file == nullptr) {
+    return;
+  }
+
+  bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+  LISTBASE_FOREACH (BHeadN *, new_bhead, &fd->bhead_list) {
+    if (!success) {
+      break;
+    }
+    BHeadIndexEntry entry = {};
+    entry.bhead = new_bhead->bhead;
+    entry.file_offset = new_bhead->has_data ? 0 : new_bhead->file_offset;
+    success = fwrite(&entry, sizeof(entry), 1, file) == 1;
+    if (success && new_bhead->has_data && new_bhead->bhead.len != 0) {
+      success = fwrite(new_bhead + 1, size_t(new_bhead->bhead.len), 1, file) == 1;
+    }
+  }
+  success &= (fclose(file) == 0);
+
+  if (!success || BLI_rename_overwrite(tmp_filepath.c_str(), index_filepath) != 0) {
+    BLI_delete(tmp_filepath.c_str(), false, false);
+    return;
+  }
+  CLOG_DEBUG(&LOG, "Wrote BHead index '%s' for '%s'", index_filepath, fd->relabase);
+
+  bhead_index_prune();
+}
+
+#endif /* USE_BHEAD_READ_ON_DEMAND */
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name File Data API
  * \{ */
@@ -1202,6 +1514,10 @@ static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
     fd = nullptr;
   }
   else if (fd->flags & FD_FLAGS_FILE_OK) {
+#ifdef USE_BHEAD_READ_ON_DEMAND
+    const bool use_bhead_index = (fd->flags & FD_FLAGS_USE_BHEAD_INDEX) != 0;
+    const bool has_bhead_index = use_bhead_index && bhead_index_read(fd);
+#endif
     const char *error_message = nullptr;
     if (read_file_dna(fd, &error_message) == false) {
       BKE_reportf(
@@ -1213,6 +1529,11 @@ static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
       blo_filedata_free(fd);
       fd = nullptr;
     }
+#ifdef USE_BHEAD_READ_ON_DEMAND
+    else if (use_bhead_index && !has_bhead_index) {
+      bhead_index_write(fd);
+    }
+#endif
   }
   else if (fd->flags & FD_FLAGS_FILE_FUTURE) {
     BKE_reportf(
@@ -1236,7 +1557,21 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
                                                    BlendFileReadReport *reports,
                                                    const int filedes)
 {
-  FileReader *file = BLO_file_reader_uncompressed_from_descriptor(filedes);
+  std::shared_ptr<BLI_mmap_file> mapping;
+#ifndef WIN32
+  /* On Windows, files can't be replaced while they are mapped, which would make saving over the
+   * opened file fail for as long as any data is shared with the mapping. */
+  if (USER_EXPERIMENTAL_TEST(&U, use_blend_file_mmap)) {
+    if (BLI_mmap_file *mmap_file = BLI_mmap_open_copy_on_write(filedes)) {
+      mapping = std::shared_ptr<BLI_mmap_file>(mmap_file, BLI_mmap_free);
+    }
+    /* Opening the mapping moves the file position to its end. */
+    BLI_lseek(filedes, 0, SEEK_SET);
+  }
+#endif
+
+  FileReader *rawfile = BLI_filereader_new_file(filedes);
+  FileReader *file = BLO_file_reader_uncompressed(rawfile);
   if (file == nullptr) {
     BKE_reportf(reports->reports, RPT_WARNING, "Unrecognized file format '%s'", filepath);
     return nullptr;
@@ -1244,6 +1579,10 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 
   FileData *fd = filedata_new(reports);
   fd->file = file;
+  if (file == rawfile) {
+    /* Data can only be shared with the mapping when the file is not compressed. */
+    fd->mapping = std::move(mapping);
+  }
 
   BLI_stat_t stat;
   if (BLI_stat(filepath, &stat) != -1) {
@@ -1280,6 +1619,19 @@ FileData *blo_filedata_from_file(const char *filepath, BlendFileReadReport *repo
   return nullptr;
 }
 
+FileData *blo_filedata_from_library_file(const char *filepath, BlendFileReadReport *reports)
+{
+  FileData *fd = blo_filedata_from_file_open(filepath, reports);
+  if (fd != nullptr) {
+    /* needed for library_append and read_libraries */
+    STRNCPY(fd->relabase, filepath);
+    fd->flags |= FD_FLAGS_USE_BHEAD_INDEX;
+
+    return blo_decode_and_check(fd, reports->reports);
+  }
+  return nullptr;
+}
+
 /**
  * Same as blo_filedata_from_file(), but does not reads DNA data, only header.
  * Use it for light access (e.g. thumbnail reading).
@@ -1437,16 +1789,40 @@ short BLO_version_from_file(const char *filepath)
 /** \name Old/New Pointer Map
  * \{ */
 
+/**
+ * Read a data block that was not read by #read_data_into_datamap because it may have been shared
+ * with the memory-mapped file, but is accessed in the regular way.
+ */
+static void *newdataadr_read_mapped(FileData *fd, const void *adr, const bool increase_users)
+{
+  const std::optional<BHeadMapped> mapped = fd->mapped_datamap.pop_try(adr);
+  if (!mapped) {
+    return nullptr;
+  }
+  void *data = read_struct(fd, mapped->bhead, mapped->allocname, mapped->id_type_index);
+  if (data == nullptr) {
+    return nullptr;
+  }
+  oldnewmap_insert(fd->datamap, adr, data, increase_users ? 1 : 0);
+  return data;
+}
+
 /* Only direct data-blocks. */
 static void *newdataadr(FileData *fd, const void *adr)
 {
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, true);
+  if (void *data = oldnewmap_lookup_and_inc(fd->datamap, adr, true)) {
+    return data;
+  }
+  return newdataadr_read_mapped(fd, adr, true);
 }
 
 /* Only direct data-blocks. */
 static void *newdataadr_no_us(FileData *fd, const void *adr)
 {
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, false);
+  if (void *data = oldnewmap_lookup_and_inc(fd->datamap, adr, false)) {
+    return data;
+  }
+  return newdataadr_read_mapped(fd, adr, false);
 }
 
 void *blo_read_get_new_globaldata_address(FileData *fd, const void *adr)
@@ -2752,27 +3128,172 @@ static bool direct_link_id(FileData *fd,
   return success;
 }
 
-/* Read all data associated with a datablock into datamap. */
+/** Data blocks smaller than this are always copied, even when the file is memory-mapped. */
+#define MAPPED_DATA_MIN_SIZE (64 * 1024)
+
+/**
+ * Whether the data of the block can be shared with the memory-mapped file, i.e. it is big enough
+ * to be worth it and it is stored in the file exactly as it is expected in memory.
+ */
+static bool blo_bhead_data_can_be_mapped(FileData *fd, BHead *bhead)
+{
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  if (!fd->mapping || bhead->len < MAPPED_DATA_MIN_SIZE) {
+    return false;
+  }
+  const BHeadN *new_bhead = BHEADN_FROM_BHEAD(bhead);
+  if (new_bhead->has_data || fd->compflags[bhead->SDNAnr] != SDNA_CMP_EQUAL) {
+    return false;
+  }
+  int alignment = DNA_struct_alignment(fd->filesdna, bhead->SDNAnr);
+  if (bhead->SDNAnr == SDNA_RAW_DATA_STRUCT_INDEX) {
+    /* Raw data, the type of its elements is unknown, so use the alignment of allocations. */
+    alignment = std::max<int>(alignment, alignof(std::max_align_t));
+  }
+  return (new_bhead->file_offset % alignment) == 0 &&
+         new_bhead->file_offset + bhead->len <= BLI_mmap_get_length(fd->mapping.get());
+#else
+  UNUSED_VARS(fd, bhead);
+  return false;
+#endif
+}
+
+/**
+ * Upper bound of the (file) data size of the blocks that are waiting to be reconstructed at the
+ * same time, limits the peak memory usage of #read_data_into_datamap.
+ */
+#define RECONSTRUCT_BATCH_MAX_SIZE (64 * 1024 * 1024)
+
+/** A data block which has to be converted from the file SDNA to the current SDNA. */
+struct BHeadReconstruct {
+  /** Block with its data loaded in memory. */
+  BHead *bhead;
+  /** The #BHeadN holding the data was allocated only for the reconstruction. */
+  bool free_bhead;
+  const char *alloc_name;
+  /** Index of the block in the list of blocks of the ID, see #read_data_into_datamap. */
+  int64_t index;
+};
+
+/**
+ * Whether the block has to go through #DNA_struct_reconstruct, which does not depend on any other
+ * data and can be done on any thread.
+ */
+static bool blo_bhead_needs_reconstruct(FileData *fd, const BHead *bhead)
+{
+  return bhead->len && bhead->SDNAnr > SDNA_RAW_DATA_STRUCT_INDEX &&
+         fd->compflags[bhead->SDNAnr] == SDNA_CMP_NOT_EQUAL &&
+         (fd->flags & FD_FLAGS_SWITCH_ENDIAN) == 0;
+}
+
+/**
+ * Reconstruct the given blocks in parallel. Reading from the file is not thread-safe, so the data
+ * of all blocks is expected to be loaded already.
+ */
+static void read_structs_reconstruct(FileData *fd,
+                                     const blender::Span<BHeadReconstruct> blocks,
+                                     blender::MutableSpan<void *> r_data)
+{
+  blender::threading::parallel_for(
+      blocks.index_range(),
+      256 * 1024,
+      [&](const blender::IndexRange range) {
+        for (const BHeadReconstruct &block : blocks.slice(range)) {
+          r_data[block.index] = DNA_struct_reconstruct(fd->reconstruct_info,
+                                                       block.bhead->SDNAnr,
+                                                       block.bhead->nr,
+                                                       block.bhead + 1,
+                                                       block.alloc_name);
+        }
+      },
+      blender::threading::individual_task_sizes(
+          [&](const int64_t i) { return int64_t(blocks[i].bhead->len); }, blocks.size()));
+
+  for (const BHeadReconstruct &block : blocks) {
+#ifdef USE_BHEAD_READ_ON_DEMAND
+    if (block.free_bhead) {
+      MEM_freeN(BHEADN_FROM_BHEAD(block.bhead));
+    }
+#else
+    UNUSED_VARS(block);
+#endif
+  }
+}
+
+/**
+ * Read all data associated with a datablock into datamap.
+ *
+ * Blocks that were written with a different SDNA are reconstructed together on the task
+ * scheduler, this is the main cost of reading files saved by other Blender versions.
+ */
 static BHead *read_data_into_datamap(FileData *fd,
                                      BHead *bhead,
                                      const char *allocname,
                                      const int id_type_index)
 {
+  /* Old addresses and new data of all blocks, inserted in the datamap in file order at the end,
+   * so that duplicate addresses in corrupt files are handled as when reading serially. */
+  blender::Vector<const void *> old_addresses;
+  blender::Vector<void *> new_data;
+  blender::Vector<BHeadReconstruct> reconstruct_blocks;
+  int64_t reconstruct_size = 0;
+
   bhead = blo_bhead_next(fd, bhead);
 
   while (bhead && bhead->code == BLO_CODE_DATA) {
-    void *data = read_struct(fd, bhead, allocname, id_type_index);
-    if (data) {
-      const bool is_new = oldnewmap_insert(fd->datamap, bhead->old, data, 0);
+    if (blo_bhead_data_can_be_mapped(fd, bhead)) {
+      /* Defer reading, the data may be shared with the mapped file instead of being copied. */
+      fd->mapped_datamap.add(bhead->old, {bhead, allocname, id_type_index});
+      bhead = blo_bhead_next(fd, bhead);
+      continue;
+    }
+    if (blo_bhead_needs_reconstruct(fd, bhead)) {
+      BHeadReconstruct block{bhead, false, nullptr, old_addresses.size()};
+#ifdef USE_BHEAD_READ_ON_DEMAND
+      if (BHEADN_FROM_BHEAD(bhead)->has_data == false) {
+        block.bhead = blo_bhead_read_full(fd, bhead);
+        if (UNLIKELY(block.bhead == nullptr)) {
+          fd->flags &= ~FD_FLAGS_FILE_OK;
+          bhead = blo_bhead_next(fd, bhead);
+          continue;
+        }
+        block.free_bhead = true;
+      }
+#endif
+      /* Not thread-safe, see #get_alloc_name. */
+      block.alloc_name = get_alloc_name(fd, bhead, allocname, id_type_index);
+      reconstruct_blocks.append(block);
+      reconstruct_size += bhead->len;
+      old_addresses.append(bhead->old);
+      new_data.append(nullptr);
+
+      if (reconstruct_size > RECONSTRUCT_BATCH_MAX_SIZE) {
+        read_structs_reconstruct(fd, reconstruct_blocks, new_data);
+        reconstruct_blocks.clear();
+        reconstruct_size = 0;
+      }
+      bhead = blo_bhead_next(fd, bhead);
+      continue;
+    }
+
+    old_addresses.append(bhead->old);
+    new_data.append(read_struct(fd, bhead, allocname, id_type_index));
+
+    bhead = blo_bhead_next(fd, bhead);
+  }
+
+  read_structs_reconstruct(fd, reconstruct_blocks, new_data);
+
+  for (const int64_t i : old_addresses.index_range()) {
+    if (new_data[i]) {
+      const bool is_new = oldnewmap_insert(fd->datamap, old_addresses[i], new_data[i], 0);
       if (!is_new) {
         CLOG_ERROR(&LOG,
                    "Blendfile corruption: Invalid, or multiple `bhead` with same old address "
                    "value (%p) for a given ID.",
-                   bhead->old);
+                   old_addresses[i]);
       }
     }
-
-    bhead = blo_bhead_next(fd, bhead);
   }
 
   return bhead;
@@ -3322,6 +3843,7 @@ static BHead *read_libblock(FileData *fd,
   bhead = read_data_into_datamap(fd, bhead, blockname, id_type_index);
   const bool success = direct_link_id(fd, main, id_tag, id_read_tags, id, id_old);
   oldnewmap_clear(fd->datamap);
+  fd->mapped_datamap.clear();
 
   if (!success) {
     /* XXX This is probably working OK currently given the very limited scope of that flag.
@@ -3374,6 +3896,7 @@ BHead *blo_read_asset_data_block(FileData *fd, BHead *bhead, AssetMetaData **r_a
   BKE_asset_metadata_read(&reader, *r_asset_data);
 
   oldnewmap_clear(fd->datamap);
+  fd->mapped_datamap.clear();
 
   return bhead;
 }
@@ -3877,6 +4400,7 @@ static BHead *read_userdef(BlendFileData *bfd, FileData *fd, BHead *bhead)
 
   /* free fd->datamap again */
   oldnewmap_clear(fd->datamap);
+  fd->mapped_datamap.clear();
 
   return bhead;
 }
@@ -5493,7 +6017,8 @@ static FileData *read_library_file_data(FileData *basefd, Main *bmain, Main *lib
                      lib_bmain->curlib->runtime->filepath_abs,
                      lib_bmain->curlib->filepath,
                      library_parent_filepath(lib_bmain->curlib));
-    fd = blo_filedata_from_file(lib_bmain->curlib->runtime->filepath_abs, basefd->reports);
+    fd = blo_filedata_from_library_file(lib_bmain->curlib->runtime->filepath_abs,
+                                        basefd->reports);
   }
 
   if (fd) {
@@ -5889,6 +6414,43 @@ void BLO_read_pointer_array(BlendDataReader *reader, const int64_t array_size, v
   *ptr_p = final_array;
 }
 
+/** Keeps the memory-mapped file alive as long as data shared with it is used. */
+class MappedDataImplicitSharing : public blender::ImplicitSharingInfo {
+ public:
+  std::shared_ptr<BLI_mmap_file> mapping;
+
+  MappedDataImplicitSharing(std::shared_ptr<BLI_mmap_file> mapping) : mapping(std::move(mapping))
+  {
+  }
+
+ private:
+  void delete_self_with_data() override
+  {
+    MEM_delete(this);
+  }
+};
+
+const blender::ImplicitSharingInfo *BLO_read_data_address_mapped(BlendDataReader *reader,
+                                                                 const void **ptr_p,
+                                                                 const int64_t expected_size)
+{
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  FileData *fd = reader->fd;
+  const BHeadMapped *mapped = fd->mapped_datamap.lookup_ptr(*ptr_p);
+  if (mapped == nullptr || mapped->bhead->len != expected_size) {
+    return nullptr;
+  }
+  const BHeadN *new_bhead = BHEADN_FROM_BHEAD(mapped->bhead);
+  fd->mapped_datamap.remove(*ptr_p);
+  *ptr_p = static_cast<const char *>(BLI_mmap_get_pointer(fd->mapping.get())) +
+           new_bhead->file_offset;
+  return MEM_new<MappedDataImplicitSharing>(__func__, fd->mapping);
+#else
+  UNUSED_VARS(reader, ptr_p, expected_size);
+  return nullptr;
+#endif
+}
+
 blender::ImplicitSharingInfoAndData blo_read_shared_impl(
     BlendDataReader *reader,
     const void **ptr_p,
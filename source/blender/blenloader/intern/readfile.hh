@@ -34,6 +34,7 @@ struct BlendFileReadParams;
 struct BlendFileReadReport;
 struct BLOCacheStorage;
 struct BHeadSort;
+struct BLI_mmap_file;
 struct DNA_ReconstructInfo;
 struct IDNameLib_Map;
 struct Key;
@@ -62,6 +63,11 @@ enum eFileDataFlag {
    * corrupted). I.e. their names have no null char in their first 66 bytes.
    */
   FD_FLAGS_HAS_INVALID_ID_NAMES = 1 << 6,
+  /**
+   * The blend-file is read as a library, use (or create) a cached index of its #BHead's
+   * instead of scanning the whole file, see #blo_filedata_from_library_file.
+   */
+  FD_FLAGS_USE_BHEAD_INDEX = 1 << 7,
 };
 ENUM_OPERATORS(eFileDataFlag)
 
@@ -70,6 +76,13 @@ ENUM_OPERATORS(eFileDataFlag)
 #  pragma GCC poison off_t
 #endif
 
+/** A data block that is not read yet, see #FileData::mapped_datamap. */
+struct BHeadMapped {
+  BHead *bhead;
+  const char *allocname;
+  int id_type_index;
+};
+
 /**
  * General data used during a blend-file reading.
  *
@@ -85,6 +98,12 @@ struct FileData {
 
   FileReader *file = nullptr;
   std::optional<BLI_stat_t> file_stat;
+  /**
+   * Copy-on-write memory mapping of uncompressed files, when enabled in the preferences. Large
+   * arrays can be shared with it instead of being copied, see #BLO_read_data_address_mapped.
+   * Data shared with the mapping keeps it alive after the file data is freed.
+   */
+  std::shared_ptr<BLI_mmap_file> mapping;
 
   /**
    * Whether we are undoing (< 0) or redoing (> 0), used to choose which 'unchanged' flag to use
@@ -139,6 +158,11 @@ struct FileData {
   int id_tag_extra = 0;
 
   OldNewMap *datamap = nullptr;
+  /**
+   * Data blocks of the ID being read that may be shared with #mapping. They are only read (and
+   * moved to #datamap) when they are accessed without #BLO_read_data_address_mapped.
+   */
+  blender::Map<const void *, BHeadMapped> mapped_datamap;
   OldNewMap *globmap = nullptr;
   /** Used to keep track of already loaded packed IDs to avoid loading them multiple times. */
   std::shared_ptr<blender::Map<IDHash, ID *>> id_by_deep_hash;
@@ -221,6 +245,12 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath) ATTR_N
  * cannot be called with relative paths anymore!
  */
 FileData *blo_filedata_from_file(const char *filepath, BlendFileReadReport *reports);
+/**
+ * Same as #blo_filedata_from_file, for blend-files that are only partially read (to link IDs
+ * from them, or list their content). The #BHead's of large files are cached in an index, so that
+ * following readings don't need to scan the whole file.
+ */
+FileData *blo_filedata_from_library_file(const char *filepath, BlendFileReadReport *reports);
 FileData *blo_filedata_from_memory(const void *mem, int memsize, BlendFileReadReport *reports);
 FileData *blo_filedata_from_memfile(MemFile *memfile,
                                     const BlendFileReadParams *params,
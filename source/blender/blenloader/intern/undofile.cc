@@ -10,6 +10,8 @@
 #include <cstdlib>
 #include <cstring>
 #include <fcntl.h>
+#include <mutex>
+#include <xxhash.h>
 
 /* open/close */
 #ifndef _WIN32
@@ -23,6 +25,7 @@
 #include "DNA_listBase.h"
 
 #include "BLI_implicit_sharing.hh"
+#include "BLI_mutex.hh"
 
 #include "BLO_readfile.hh"
 #include "BLO_undofile.hh"
@@ -35,13 +38,113 @@
 
 #include "writefile.hh"
 
+/* -------------------------------------------------------------------- */
+/** \name Chunk Store
+ *
+ * Chunk buffers are stored once per content hash, so that identical chunks are shared by all
+ * undo steps, regardless of their position in the memfiles. Every chunk owning its buffer
+ * (i.e. #MemFileChunk.is_identical is false) holds one user of it.
+ * \{ */
+
+using MemFileChunkHash = std::pair<uint64_t, uint64_t>;
+
+/** Header of chunk buffers, the data follows it. */
+struct MemFileChunkBuffer {
+  MemFileChunkHash hash;
+  size_t size;
+  int users;
+  /** False in case of a hash collision, the buffer is not shared then. */
+  bool is_stored;
+};
+
+struct MemFileChunkStore {
+  blender::Mutex mutex;
+  blender::Map<MemFileChunkHash, MemFileChunkBuffer *> buffers;
+  /** Memory used by all buffers. */
+  size_t size = 0;
+  /** Memory which would have been used by additional users of the buffers without sharing. */
+  size_t size_shared = 0;
+};
+
+static MemFileChunkStore &memfile_chunk_store()
+{
+  static MemFileChunkStore store;
+  return store;
+}
+
+static MemFileChunkBuffer *memfile_chunk_buffer_from_data(const char *buf)
+{
+  return reinterpret_cast<MemFileChunkBuffer *>(const_cast<char *>(buf)) - 1;
+}
+
+/**
+ * Get a buffer with the given content, adding a user to an existing one if possible.
+ * \param r_is_new: Set to true when new memory was allocated.
+ */
+static const char *memfile_chunk_buffer_add(const char *buf, const size_t size, bool *r_is_new)
+{
+  const XXH128_hash_t hash_value = XXH3_128bits(buf, size);
+  const MemFileChunkHash hash{hash_value.low64, hash_value.high64};
+
+  MemFileChunkStore &store = memfile_chunk_store();
+  std::scoped_lock lock(store.mutex);
+
+  MemFileChunkBuffer *buffer = store.buffers.lookup_default(hash, nullptr);
+  if (buffer && buffer->size == size && memcmp(buffer + 1, buf, size) == 0) {
+    buffer->users++;
+    store.size_shared += size;
+    *r_is_new = false;
+    return reinterpret_cast<const char *>(buffer + 1);
+  }
+
+  buffer = static_cast<MemFileChunkBuffer *>(
+      MEM_mallocN(sizeof(MemFileChunkBuffer) + size, "Chunk buffer"));
+  buffer->hash = hash;
+  buffer->size = size;
+  buffer->users = 1;
+  buffer->is_stored = store.buffers.add(hash, buffer);
+  memcpy(buffer + 1, buf, size);
+  store.size += size;
+  *r_is_new = true;
+  return reinterpret_cast<const char *>(buffer + 1);
+}
+
+static void memfile_chunk_buffer_release(const char *buf)
+{
+  MemFileChunkBuffer *buffer = memfile_chunk_buffer_from_data(buf);
+
+  MemFileChunkStore &store = memfile_chunk_store();
+  std::scoped_lock lock(store.mutex);
+
+  BLI_assert(buffer->users > 0);
+  buffer->users--;
+  if (buffer->users > 0) {
+    store.size_shared -= buffer->size;
+    return;
+  }
+  if (buffer->is_stored) {
+    store.buffers.remove(buffer->hash);
+  }
+  store.size -= buffer->size;
+  MEM_freeN(static_cast<void *>(buffer));
+}
+
+MemFileChunkStoreStats BLO_memfile_chunk_store_stats()
+{
+  MemFileChunkStore &store = memfile_chunk_store();
+  std::scoped_lock lock(store.mutex);
+  return {store.buffers.size(), store.size, store.size_shared};
+}
+
+/** \} */
+
 /* **************** support for memory-write, for undo buffers *************** */
 
 void BLO_memfile_free(MemFile *memfile)
 {
   while (MemFileChunk *chunk = static_cast<MemFileChunk *>(BLI_pophead(&memfile->chunks))) {
     if (chunk->is_identical == false) {
-      MEM_freeN(chunk->buf);
+      memfile_chunk_buffer_release(chunk->buf);
     }
     MEM_freeN(chunk);
   }
@@ -75,7 +178,9 @@ void BLO_memfile_merge(MemFile *first, MemFile *second)
    * it is also used by the second memfile, transfer the ownership. */
   LISTBASE_FOREACH (MemFileChunk *, fc, &first->chunks) {
     if (!fc->is_identical) {
-      if (MemFileChunk *sc = buffer_to_second_memchunk.lookup_default(fc->buf, nullptr)) {
+      /* The buffer may be owned by several chunks (see #memfile_chunk_buffer_add), only transfer
+       * the ownership of one of them. */
+      if (MemFileChunk *sc = buffer_to_second_memchunk.pop_default(fc->buf, nullptr)) {
         BLI_assert(sc->is_identical);
         sc->is_identical = false;
         fc->is_identical = true;
@@ -169,10 +274,12 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
 
   /* not equal... */
   if (curchunk->buf == nullptr) {
-    char *buf_new = MEM_malloc_arrayN<char>(size, "Chunk buffer");
-    memcpy(buf_new, buf, size);
-    curchunk->buf = buf_new;
-    memfile->size += size;
+    /* Still try to share the data with any other chunk of all undo steps. */
+    bool is_new;
+    curchunk->buf = memfile_chunk_buffer_add(buf, size, &is_new);
+    if (is_new) {
+      memfile->size += size;
+    }
   }
 }
 
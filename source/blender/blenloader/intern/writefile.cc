@@ -59,6 +59,7 @@
  *   - #BLENDER_USERPREF_FILE (on UNIX `~/.config/blender/X.X/config/userpref.blend`).
  */
 
+#include <atomic>
 #include <cerrno>
 #include <climits>
 #include <cstdio>
@@ -66,7 +67,9 @@
 #include <cstring>
 #include <fcntl.h>
 #include <iomanip>
+#include <optional>
 #include <sstream>
+#include <thread>
 #include <xxhash.h>
 
 #ifdef WIN32
@@ -104,6 +107,7 @@
 #include "BLI_path_utils.hh"
 #include "BLI_set.hh"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
 #include "BLI_time.h"
 
@@ -187,6 +191,11 @@ class WriteWrap {
 
   /** Buffer output (we only want when output isn't already buffered). */
   bool use_buf = true;
+  /**
+   * Flush the buffer after each ID (as done for undo), so that the data of unchanged IDs is
+   * always passed to #write as identical chunks.
+   */
+  bool use_id_chunks = false;
 };
 
 class RawWriteWrap : public WriteWrap {
@@ -698,6 +707,9 @@ static void mywrite_id_end(WriteData *wd, ID * /*id*/)
     mywrite_flush(wd);
     wd->mem.current_id_session_uid = MAIN_ID_SESSION_UID_UNSET;
   }
+  else if (wd->ww->use_id_chunks) {
+    mywrite_flush(wd);
+  }
 
   wd->validation_data.per_id_addresses_set.clear();
   wd->per_id_written_shared_addresses.clear();
@@ -2110,6 +2122,493 @@ static bool BLO_write_file_impl(Main *mainvar,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Auto-Save Journal
+ *
+ * Incremental alternative to writing the whole file for every auto-save. The file is serialized
+ * as usual, but with the buffer flushed after every ID (as done for undo steps), so that the data
+ * of unchanged IDs is passed to the #WriteWrap as identical chunks. Only chunks that are not in
+ * the journal yet are kept, they are compressed and appended to the journal by a background
+ * thread, followed by a snapshot record listing the chunks that make up the file.
+ *
+ * The journal is rewritten with only the chunks of the latest snapshot once most of it is not
+ * used anymore. #BLO_journal_restore turns the latest complete snapshot back into a blend-file.
+ * \{ */
+
+#define JOURNAL_MAGIC "BLENDJNL"
+#define JOURNAL_VERSION 1
+
+/** Compact the journal when it is this many times bigger than the data of the latest snapshot. */
+#define JOURNAL_COMPACT_FACTOR 2
+/** Never compact journals smaller than this. */
+#define JOURNAL_COMPACT_MIN_SIZE (64 * 1024 * 1024)
+
+#define JOURNAL_CODE_CHUNK "CHNK"
+#define JOURNAL_CODE_SNAPSHOT "SNAP"
+
+using JournalChunkHash = std::pair<uint64_t, uint64_t>;
+
+struct JournalFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t _pad;
+};
+
+struct JournalRecordHeader {
+  char code[4];
+  uint32_t _pad;
+  /** Size of the record data following this header. */
+  uint64_t size;
+};
+
+/**
+ * Data of #JOURNAL_CODE_CHUNK records, followed by the compressed chunk. #JOURNAL_CODE_SNAPSHOT
+ * records contain an array of chunk hashes.
+ */
+struct JournalChunkHeader {
+  uint64_t hash[2];
+  uint64_t uncompressed_size;
+};
+
+struct JournalChunk {
+  /** Offset of the record header in the journal file. */
+  uint64_t offset;
+  /** Size of the whole record, including its header. */
+  uint64_t size;
+};
+
+struct JournalPendingChunk {
+  JournalChunkHash hash;
+  uint64_t size;
+  blender::Vector<char> data;
+  /** Compressed by the background thread. */
+  blender::Vector<char> compressed;
+};
+
+struct BlendFileJournal {
+  std::string filepath;
+
+  /** Chunks stored in the journal file. */
+  blender::Map<JournalChunkHash, JournalChunk> chunks;
+  /** Current size of the journal file, zero when it has to be (re)created. */
+  uint64_t file_size = 0;
+
+  /** Chunks of the snapshot being written, in file order. */
+  blender::Vector<JournalChunkHash> snapshot;
+  /** Chunks of the snapshot that are not in the journal yet. */
+  blender::Vector<JournalPendingChunk> pending;
+
+  /**
+   * Writes the pending chunks and the snapshot. The journal must not be accessed by the main
+   * thread while it is running.
+   */
+  std::thread thread;
+  std::atomic<bool> is_writing = false;
+};
+
+class JournalWriteWrap : public WriteWrap {
+  BlendFileJournal &journal_;
+  blender::Set<JournalChunkHash> pending_hashes_;
+
+ public:
+  JournalWriteWrap(BlendFileJournal &journal) : journal_(journal)
+  {
+    use_id_chunks = true;
+  }
+
+  bool open(const char * /*filepath*/) override
+  {
+    return true;
+  }
+  bool close() override
+  {
+    return true;
+  }
+  bool write(const void *buf, size_t buf_len) override
+  {
+    const XXH128_hash_t hash_value = XXH3_128bits(buf, buf_len);
+    const JournalChunkHash hash{hash_value.low64, hash_value.high64};
+    journal_.snapshot.append(hash);
+    if (!journal_.chunks.contains(hash) && pending_hashes_.add(hash)) {
+      JournalPendingChunk chunk;
+      chunk.hash = hash;
+      chunk.size = uint64_t(buf_len);
+      chunk.data.extend(blender::Span(static_cast<const char *>(buf), int64_t(buf_len)));
+      journal_.pending.append(std::move(chunk));
+    }
+    return true;
+  }
+};
+
+static bool journal_write_record(const int file,
+                                 const char code[4],
+                                 const blender::Span<blender::Span<char>> data)
+{
+  JournalRecordHeader header = {};
+  memcpy(header.code, code, sizeof(header.code));
+  for (const blender::Span<char> part : data) {
+    header.size += uint64_t(part.size());
+  }
+  if (::write(file, &header, sizeof(header)) != sizeof(header)) {
+    return false;
+  }
+  for (const blender::Span<char> part : data) {
+    if (::write(file, part.data(), size_t(part.size())) != part.size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool journal_read(const int file, const uint64_t offset, void *buf, const size_t buf_len)
+{
+  return BLI_lseek(file, int64_t(offset), SEEK_SET) == int64_t(offset) &&
+         BLI_read(file, buf, buf_len) == int64_t(buf_len);
+}
+
+/**
+ * Copy the chunks of the current snapshot that are already in the journal to a new journal file,
+ * leaving out everything else.
+ * \return The chunks of the new journal.
+ */
+static std::optional<blender::Map<JournalChunkHash, JournalChunk>> journal_compact(
+    BlendFileJournal &journal, const int file_dst, uint64_t &r_file_size)
+{
+  blender::Map<JournalChunkHash, JournalChunk> chunks;
+  if (journal.file_size == 0) {
+    return chunks;
+  }
+  const int file_src = BLI_open(journal.filepath.c_str(), O_BINARY | O_RDONLY, 0);
+  if (file_src == -1) {
+    return std::nullopt;
+  }
+  blender::Vector<char> buffer;
+  bool ok = true;
+  for (const JournalChunkHash &hash : journal.snapshot) {
+    const JournalChunk *chunk = journal.chunks.lookup_ptr(hash);
+    if (chunk == nullptr || chunks.contains(hash)) {
+      continue;
+    }
+    buffer.resize(int64_t(chunk->size));
+    if (!journal_read(file_src, chunk->offset, buffer.data(), chunk->size) ||
+        ::write(file_dst, buffer.data(), chunk->size) != chunk->size)
+    {
+      ok = false;
+      break;
+    }
+    chunks.add_new(hash, {r_file_size, chunk->size});
+    r_file_size += chunk->size;
+  }
+  ::close(file_src);
+  if (!ok) {
+    return std::nullopt;
+  }
+  return chunks;
+}
+
+/** Runs on the background thread. */
+static bool journal_flush(BlendFileJournal &journal)
+{
+  using namespace blender;
+
+  threading::parallel_for(journal.pending.index_range(), 1, [&](const IndexRange range) {
+    for (JournalPendingChunk &chunk : journal.pending.as_mutable_span().slice(range)) {
+      chunk.compressed.resize(int64_t(ZSTD_compressBound(size_t(chunk.data.size()))));
+      const size_t compressed_size = ZSTD_compress(chunk.compressed.data(),
+                                                   size_t(chunk.compressed.size()),
+                                                   chunk.data.data(),
+                                                   size_t(chunk.data.size()),
+                                                   ZSTD_COMPRESSION_LEVEL);
+      chunk.compressed.resize(ZSTD_isError(compressed_size) ? 0 : int64_t(compressed_size));
+      chunk.data.clear_and_shrink();
+    }
+  });
+
+  /* Size of the data used by the snapshot, to decide whether the journal should be compacted. */
+  uint64_t used_size = 0;
+  uint64_t new_size = 0;
+  Set<JournalChunkHash> used_hashes;
+  for (const JournalChunkHash &hash : journal.snapshot) {
+    if (used_hashes.add(hash)) {
+      if (const JournalChunk *chunk = journal.chunks.lookup_ptr(hash)) {
+        used_size += chunk->size;
+      }
+    }
+  }
+  for (const JournalPendingChunk &chunk : journal.pending) {
+    if (chunk.compressed.is_empty()) {
+      return false;
+    }
+    new_size += sizeof(JournalRecordHeader) + sizeof(JournalChunkHeader) +
+                uint64_t(chunk.compressed.size());
+  }
+  used_size += new_size;
+
+  const bool use_compact = journal.file_size == 0 ||
+                           (journal.file_size + new_size > JOURNAL_COMPACT_MIN_SIZE &&
+                            journal.file_size + new_size > used_size * JOURNAL_COMPACT_FACTOR);
+
+  const std::string filepath_tmp = journal.filepath + "@";
+  const char *filepath = use_compact ? filepath_tmp.c_str() : journal.filepath.c_str();
+  const int file = use_compact ?
+                       BLI_open(filepath, O_BINARY | O_WRONLY | O_CREAT | O_TRUNC, 0666) :
+                       BLI_open(filepath, O_BINARY | O_WRONLY | O_APPEND, 0666);
+  if (file == -1) {
+    return false;
+  }
+
+  Map<JournalChunkHash, JournalChunk> chunks;
+  uint64_t file_size = journal.file_size;
+  bool ok = true;
+  if (use_compact) {
+    JournalFileHeader header = {};
+    memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+    header.version = JOURNAL_VERSION;
+    file_size = sizeof(header);
+    ok = ::write(file, &header, sizeof(header)) == sizeof(header);
+    if (ok) {
+      std::optional<Map<JournalChunkHash, JournalChunk>> compacted = journal_compact(
+          journal, file, file_size);
+      ok = compacted.has_value();
+      if (ok) {
+        chunks = std::move(*compacted);
+      }
+    }
+  }
+  else {
+    chunks = std::move(journal.chunks);
+  }
+
+  for (const JournalPendingChunk &chunk : journal.pending) {
+    if (!ok) {
+      break;
+    }
+    const JournalChunkHeader header = {{chunk.hash.first, chunk.hash.second}, chunk.size};
+    ok = journal_write_record(
+        file,
+        JOURNAL_CODE_CHUNK,
+        {Span(reinterpret_cast<const char *>(&header), sizeof(header)), chunk.compressed});
+    const uint64_t record_size = sizeof(JournalRecordHeader) + sizeof(header) +
+                                 uint64_t(chunk.compressed.size());
+    chunks.add(chunk.hash, {file_size, record_size});
+    file_size += record_size;
+  }
+
+  if (ok) {
+    const Span<char> snapshot_data(reinterpret_cast<const char *>(journal.snapshot.data()),
+                                   journal.snapshot.size() * int64_t(sizeof(JournalChunkHash)));
+    ok = journal_write_record(file, JOURNAL_CODE_SNAPSHOT, {snapshot_data});
+    file_size += sizeof(JournalRecordHeader) + uint64_t(snapshot_data.size());
+  }
+
+  ok &= ::close(file) != -1;
+  if (ok && use_compact) {
+    ok = BLI_rename_overwrite(filepath_tmp.c_str(), journal.filepath.c_str()) == 0;
+  }
+  if (!ok) {
+    if (use_compact) {
+      BLI_delete(filepath_tmp.c_str(), false, false);
+    }
+    return false;
+  }
+
+  journal.chunks = std::move(chunks);
+  journal.file_size = file_size;
+  journal.pending.clear();
+  return true;
+}
+
+static void journal_wait(BlendFileJournal &journal)
+{
+  if (journal.thread.joinable()) {
+    journal.thread.join();
+  }
+}
+
+BlendFileJournal *BLO_journal_new(const char *filepath)
+{
+  BlendFileJournal *journal = MEM_new<BlendFileJournal>(__func__);
+  journal->filepath = filepath;
+  return journal;
+}
+
+void BLO_journal_free(BlendFileJournal *journal)
+{
+  journal_wait(*journal);
+  MEM_delete(journal);
+}
+
+const char *BLO_journal_filepath(const BlendFileJournal *journal)
+{
+  return journal->filepath.c_str();
+}
+
+BlendFileJournalWriteResult BLO_journal_write(BlendFileJournal *journal,
+                                              Main *mainvar,
+                                              const int write_flags)
+{
+  if (journal->is_writing) {
+    return BlendFileJournalWriteResult::Busy;
+  }
+  journal_wait(*journal);
+
+  journal->snapshot.clear();
+  journal->pending.clear();
+
+  JournalWriteWrap ww(*journal);
+  const bool err = write_file_handle(
+      mainvar, &ww, nullptr, nullptr, write_flags, false, nullptr, nullptr);
+  if (err) {
+    return BlendFileJournalWriteResult::Error;
+  }
+
+  CLOG_INFO(&LOG,
+            "Auto-save journal: %d of %d chunks changed",
+            int(journal->pending.size()),
+            int(journal->snapshot.size()));
+
+  journal->is_writing = true;
+  journal->thread = std::thread([journal]() {
+    if (!journal_flush(*journal)) {
+      CLOG_ERROR(&LOG, "Failed to write auto-save journal %s", journal->filepath.c_str());
+      /* Start over with a new journal next time. */
+      journal->chunks.clear();
+      journal->file_size = 0;
+      journal->pending.clear();
+    }
+    journal->is_writing = false;
+  });
+  return BlendFileJournalWriteResult::Queued;
+}
+
+bool BLO_journal_restore(const char *journal_filepath, const char *filepath, ReportList *reports)
+{
+  using namespace blender;
+
+  const int file = BLI_open(journal_filepath, O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    BKE_reportf(reports, RPT_ERROR, "Cannot open auto-save journal %s", journal_filepath);
+    return false;
+  }
+
+  JournalFileHeader file_header;
+  if (BLI_read(file, &file_header, sizeof(file_header)) != sizeof(file_header) ||
+      memcmp(file_header.magic, JOURNAL_MAGIC, sizeof(file_header.magic)) != 0 ||
+      file_header.version != JOURNAL_VERSION)
+  {
+    ::close(file);
+    BKE_reportf(reports, RPT_ERROR, "Invalid auto-save journal %s", journal_filepath);
+    return false;
+  }
+
+  /* Sizes stored in the journal are only trusted when they fit into the file, a partially
+   * written record at the end is ignored. */
+  const size_t journal_size = BLI_file_descriptor_size(file);
+  if (journal_size == size_t(-1)) {
+    ::close(file);
+    BKE_reportf(reports, RPT_ERROR, "Cannot read auto-save journal %s", journal_filepath);
+    return false;
+  }
+
+  /* Scan all records, a snapshot is only used when it and all chunks before it are complete. */
+  Map<JournalChunkHash, JournalChunk> chunks;
+  Vector<JournalChunkHash> snapshot;
+  bool has_snapshot = false;
+  uint64_t offset = sizeof(file_header);
+  JournalRecordHeader header;
+  while (journal_read(file, offset, &header, sizeof(header))) {
+    if (header.size > journal_size - offset - sizeof(header)) {
+      break;
+    }
+    const uint64_t record_size = sizeof(header) + header.size;
+    if (memcmp(header.code, JOURNAL_CODE_CHUNK, sizeof(header.code)) == 0) {
+      JournalChunkHeader chunk_header;
+      if (header.size < sizeof(chunk_header) ||
+          !journal_read(file, offset + sizeof(header), &chunk_header, sizeof(chunk_header)))
+      {
+        break;
+      }
+      chunks.add({chunk_header.hash[0], chunk_header.hash[1]}, {offset, record_size});
+    }
+    else if (memcmp(header.code, JOURNAL_CODE_SNAPSHOT, sizeof(header.code)) == 0) {
+      if (header.size % sizeof(JournalChunkHash) != 0) {
+        break;
+      }
+      Vector<JournalChunkHash> hashes(int64_t(header.size / sizeof(JournalChunkHash)));
+      if (!journal_read(file, offset + sizeof(header), hashes.data(), header.size)) {
+        break;
+      }
+      snapshot = std::move(hashes);
+      has_snapshot = true;
+    }
+    else {
+      break;
+    }
+    offset += record_size;
+  }
+
+  if (!has_snapshot) {
+    ::close(file);
+    BKE_reportf(reports, RPT_ERROR, "No complete auto-save in journal %s", journal_filepath);
+    return false;
+  }
+
+  char tempname[FILE_MAX + 1];
+  SNPRINTF(tempname, "%s@", filepath);
+  const int file_dst = BLI_open(tempname, O_BINARY | O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (file_dst == -1) {
+    ::close(file);
+    BKE_reportf(
+        reports, RPT_ERROR, "Cannot open file %s for writing: %s", tempname, strerror(errno));
+    return false;
+  }
+
+  bool ok = true;
+  Vector<char> compressed;
+  Vector<char> decompressed;
+  for (const JournalChunkHash &hash : snapshot) {
+    const JournalChunk *chunk = chunks.lookup_ptr(hash);
+    JournalChunkHeader chunk_header;
+    const uint64_t data_offset = sizeof(JournalRecordHeader) + sizeof(chunk_header);
+    if (chunk == nullptr ||
+        !journal_read(file, chunk->offset + sizeof(JournalRecordHeader), &chunk_header,
+                      sizeof(chunk_header)))
+    {
+      ok = false;
+      break;
+    }
+    compressed.resize(int64_t(chunk->size - data_offset));
+    if (!journal_read(file, chunk->offset + data_offset, compressed.data(), compressed.size()) ||
+        ZSTD_getFrameContentSize(compressed.data(), compressed.size()) !=
+            chunk_header.uncompressed_size)
+    {
+      ok = false;
+      break;
+    }
+    decompressed.resize(int64_t(chunk_header.uncompressed_size));
+    if (ZSTD_decompress(decompressed.data(),
+                        decompressed.size(),
+                        compressed.data(),
+                        compressed.size()) != chunk_header.uncompressed_size ||
+        ::write(file_dst, decompressed.data(), decompressed.size()) != decompressed.size())
+    {
+      ok = false;
+      break;
+    }
+  }
+
+  ::close(file);
+  ok &= ::close(file_dst) != -1;
+  if (!ok || BLI_rename_overwrite(tempname, filepath) != 0) {
+    BLI_delete(tempname, false, false);
+    BKE_reportf(reports, RPT_ERROR, "Cannot restore auto-save journal %s", journal_filepath);
+    return false;
+  }
+  return true;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name File Writing (Public)
  * \{ */
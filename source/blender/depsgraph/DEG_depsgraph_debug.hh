@@ -53,6 +53,27 @@ void DEG_debug_stats_gnuplot(const Depsgraph *graph,
                              const char *label,
                              const char *output_filename);
 
+/* ************************************************ */
+/* Evaluation Timeline */
+
+/**
+ * Start recording the evaluation timeline of operation nodes of all dependency graphs:
+ * the thread, start and end time of every evaluated operation and how long it has been waiting
+ * to be evaluated after it was scheduled.
+ *
+ * The recording is written to the given file in the Chrome trace event format (JSON) by
+ * #DEG_debug_trace_end().
+ */
+void DEG_debug_trace_begin(const char *filepath);
+/**
+ * Stop recording and write the file.
+ * Is not to be called while any dependency graph is being evaluated.
+ *
+ * \return false if there was no recording or the file could not be written.
+ */
+bool DEG_debug_trace_end();
+bool DEG_debug_trace_is_enabled();
+
 /* ************************************************ */
 
 /** Compare two dependency graphs. */
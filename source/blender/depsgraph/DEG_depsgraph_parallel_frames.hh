@@ -0,0 +1,51 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Evaluation of multiple frames at the same time, using a separate dependency graph with its own
+ * copy of the evaluated data for every frame in flight. Intended for exporters and bakers which
+ * need every frame of a range, when the frames do not depend on each other.
+ */
+
+#include <cstdint>
+
+#include "BLI_function_ref.hh"
+#include "BLI_span.hh"
+
+struct Depsgraph;
+
+namespace blender::deg::parallel_frames {
+
+/**
+ * Check whether any frame of the graph can be evaluated without evaluating the frames before it.
+ * This is not the case when there are simulations, such as point caches, particles, cloth, soft
+ * and rigid bodies or simulation zones in geometry nodes. Frame change handlers and Python
+ * drivers may depend on the previous frame or on the current frame of the original scene, so
+ * they make frames dependent too.
+ */
+bool frames_are_independent(const Depsgraph &depsgraph);
+
+/**
+ * Evaluate the given frames with up to `graphs_num` dependency graphs at the same time, and call
+ * `frame_fn` for every frame in order on the calling thread, with the graph evaluated at that
+ * frame. The graph is not evaluated at another frame until `frame_fn` returns. Evaluation stops
+ * when `frame_fn` returns false.
+ *
+ * The given graph is used for evaluation of the first frame, additional graphs are created with
+ * `graph_create_fn` which is to return a graph built in the same way, and are freed at the end.
+ * Unlike #BKE_scene_graph_update_for_newframe, no frame change handlers are called and the
+ * original data is not modified, so the caller is responsible for checking that the frames can
+ * be evaluated independently, see #frames_are_independent.
+ */
+void evaluate(Depsgraph &depsgraph,
+              Span<float> frames,
+              int graphs_num,
+              FunctionRef<Depsgraph *()> graph_create_fn,
+              FunctionRef<bool(Depsgraph &depsgraph, int64_t frame_index)> frame_fn);
+
+}  // namespace blender::deg::parallel_frames
@@ -93,6 +93,8 @@ void AbstractBuilderPipeline::build_step_finalize()
 #endif
   /* Relations are up to date. */
   deg_graph_->need_update_relations = false;
+  /* The operations are new, without timing of previous evaluations. */
+  deg_graph_->need_update_critical_path_time = true;
 }
 
 std::unique_ptr<DepsgraphNodeBuilder> AbstractBuilderPipeline::construct_node_builder()
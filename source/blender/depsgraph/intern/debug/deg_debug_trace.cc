@@ -0,0 +1,272 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Timeline of the operation nodes evaluation, written in the Chrome trace event format.
+ * The file can be inspected in `chrome://tracing`, `ui.perfetto.dev` or similar viewers.
+ */
+
+#include "intern/debug/deg_debug_trace.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_fileops.h"
+#include "BLI_mutex.hh"
+#include "BLI_string.h"
+#include "BLI_threads.h"
+#include "BLI_time.h"
+#include "BLI_vector.hh"
+
+#include "DEG_depsgraph_debug.hh"
+
+#include "intern/depsgraph.hh"
+#include "intern/node/deg_node.hh"
+#include "intern/node/deg_node_component.hh"
+#include "intern/node/deg_node_operation.hh"
+
+namespace blender::deg {
+namespace {
+
+struct TraceEvent {
+  std::string name;
+  /* Statically allocated string, such as node type name. */
+  const char *category;
+  std::string graph_name;
+  /* Negative when the event was not scheduled, in which case there is no waiting time. */
+  double schedule_time;
+  double start_time;
+  double end_time;
+};
+
+/* Events are stored per thread, so that recording does not need any synchronization. */
+struct TraceThread {
+  int index;
+  bool is_main;
+  Vector<TraceEvent> events;
+};
+
+struct TraceRecorder {
+  std::string filepath;
+  double start_time;
+  /* Unique for every recording, used to invalidate thread local pointers. */
+  int session;
+
+  Mutex mutex;
+  Vector<std::unique_ptr<TraceThread>> threads;
+};
+
+std::atomic<bool> g_trace_enabled = false;
+TraceRecorder *g_trace_recorder = nullptr;
+int g_trace_session = 0;
+
+TraceThread &trace_thread_get()
+{
+  struct ThreadLocalTrace {
+    int session = -1;
+    TraceThread *thread = nullptr;
+  };
+  static thread_local ThreadLocalTrace thread_local_trace;
+
+  TraceRecorder &recorder = *g_trace_recorder;
+  if (thread_local_trace.session != recorder.session) {
+    std::lock_guard lock(recorder.mutex);
+    std::unique_ptr<TraceThread> thread = std::make_unique<TraceThread>();
+    thread->index = recorder.threads.size() + 1;
+    thread->is_main = BLI_thread_is_main();
+    thread_local_trace.thread = thread.get();
+    thread_local_trace.session = recorder.session;
+    recorder.threads.append(std::move(thread));
+  }
+  return *thread_local_trace.thread;
+}
+
+std::string trace_graph_name(const Depsgraph *graph)
+{
+  if (graph->debug.name.empty()) {
+    return "Depsgraph";
+  }
+  return graph->debug.name;
+}
+
+void trace_write_string(FILE *file, const StringRef str)
+{
+  fputc('"', file);
+  for (const char ch : str) {
+    switch (ch) {
+      case '"':
+        fputs("\\\"", file);
+        break;
+      case '\\':
+        fputs("\\\\", file);
+        break;
+      case '\n':
+        fputs("\\n", file);
+        break;
+      case '\t':
+        fputs("\\t", file);
+        break;
+      default:
+        if (uchar(ch) < 0x20) {
+          fprintf(file, "\\u%04x", uint(uchar(ch)));
+        }
+        else {
+          fputc(ch, file);
+        }
+        break;
+    }
+  }
+  fputc('"', file);
+}
+
+void trace_write_event(FILE *file,
+                       const TraceRecorder &recorder,
+                       const TraceThread &thread,
+                       const TraceEvent &event)
+{
+  /* Times in the trace event format are in microseconds. */
+  const double start_us = (event.start_time - recorder.start_time) * 1e6;
+  const double duration_us = (event.end_time - event.start_time) * 1e6;
+
+  fputs("{\"name\": ", file);
+  trace_write_string(file, event.name);
+  fprintf(file,
+          ", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f",
+          event.category,
+          thread.index,
+          start_us,
+          duration_us);
+  fputs(", \"args\": {\"depsgraph\": ", file);
+  trace_write_string(file, event.graph_name);
+  if (event.schedule_time >= 0.0) {
+    fprintf(file, ", \"wait_us\": %.3f", (event.start_time - event.schedule_time) * 1e6);
+  }
+  fputs("}}", file);
+}
+
+bool trace_write(const TraceRecorder &recorder)
+{
+  errno = 0;
+  FILE *file = BLI_fopen(recorder.filepath.c_str(), "w");
+  if (file == nullptr) {
+    fprintf(stderr,
+            "Error writing depsgraph trace '%s': %s\n",
+            recorder.filepath.c_str(),
+            errno ? strerror(errno) : "unknown error");
+    return false;
+  }
+
+  int64_t events_num = 0;
+  fputs("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n", file);
+  fputs("{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, "
+        "\"args\": {\"name\": \"Depsgraph\"}}",
+        file);
+  for (const std::unique_ptr<TraceThread> &thread : recorder.threads) {
+    char thread_name[64];
+    if (thread->is_main) {
+      STRNCPY(thread_name, "Main");
+    }
+    else {
+      SNPRINTF(thread_name, "Worker %d", thread->index);
+    }
+    fprintf(file,
+            ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, "
+            "\"args\": {\"name\": \"%s\"}}",
+            thread->index,
+            thread_name);
+    for (const TraceEvent &event : thread->events) {
+      fputs(",\n", file);
+      trace_write_event(file, recorder, *thread, event);
+    }
+    events_num += thread->events.size();
+  }
+  fputs("\n]}\n", file);
+  fclose(file);
+
+  printf("Depsgraph trace with %" PRId64 " events on %d threads written to '%s'.\n",
+         events_num,
+         int(recorder.threads.size()),
+         recorder.filepath.c_str());
+  return true;
+}
+
+}  // namespace
+
+bool trace_is_enabled()
+{
+  return g_trace_enabled.load(std::memory_order_relaxed);
+}
+
+void trace_record_operation(const Depsgraph *graph,
+                            const OperationNode *operation_node,
+                            const double schedule_time,
+                            const double start_time,
+                            const double end_time)
+{
+  if (!trace_is_enabled()) {
+    return;
+  }
+  TraceThread &thread = trace_thread_get();
+  thread.events.append({operation_node->full_identifier(),
+                        nodeTypeAsString(operation_node->owner->type),
+                        trace_graph_name(graph),
+                        schedule_time,
+                        start_time,
+                        end_time});
+}
+
+void trace_record_span(const Depsgraph *graph,
+                       const char *name,
+                       const double start_time,
+                       const double end_time)
+{
+  if (!trace_is_enabled()) {
+    return;
+  }
+  TraceThread &thread = trace_thread_get();
+  thread.events.append({name, "EVALUATION", trace_graph_name(graph), -1.0, start_time, end_time});
+}
+
+}  // namespace blender::deg
+
+namespace deg = blender::deg;
+
+void DEG_debug_trace_begin(const char *filepath)
+{
+  if (deg::g_trace_recorder != nullptr) {
+    DEG_debug_trace_end();
+  }
+  deg::TraceRecorder *recorder = MEM_new<deg::TraceRecorder>(__func__);
+  recorder->filepath = filepath;
+  recorder->start_time = BLI_time_now_seconds();
+  recorder->session = deg::g_trace_session++;
+  deg::g_trace_recorder = recorder;
+  deg::g_trace_enabled = true;
+}
+
+bool DEG_debug_trace_end()
+{
+  deg::TraceRecorder *recorder = deg::g_trace_recorder;
+  if (recorder == nullptr) {
+    return false;
+  }
+  deg::g_trace_enabled = false;
+  deg::g_trace_recorder = nullptr;
+  const bool success = deg::trace_write(*recorder);
+  MEM_delete(recorder);
+  return success;
+}
+
+bool DEG_debug_trace_is_enabled()
+{
+  return deg::trace_is_enabled();
+}
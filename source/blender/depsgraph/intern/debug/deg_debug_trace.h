@@ -0,0 +1,36 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Recording of the evaluation timeline of operation nodes, see #DEG_debug_trace_begin().
+ */
+
+#pragma once
+
+namespace blender::deg {
+
+struct Depsgraph;
+struct OperationNode;
+
+/* Check whether the evaluation timeline is being recorded. */
+bool trace_is_enabled();
+
+/* Record evaluation of the operation node on the current thread.
+ * All times are in seconds, as returned by #BLI_time_now_seconds(). */
+void trace_record_operation(const Depsgraph *graph,
+                            const OperationNode *operation_node,
+                            double schedule_time,
+                            double start_time,
+                            double end_time);
+
+/* Record a span of time on the current thread which is not bound to any operation node, such as
+ * the whole graph evaluation or one of its stages. */
+void trace_record_span(const Depsgraph *graph,
+                       const char *name,
+                       double start_time,
+                       double end_time);
+
+}  // namespace blender::deg
@@ -108,6 +108,10 @@ struct Depsgraph {
   /* Indicates whether indirect effect of nodes on a directly visible ones needs to be updated. */
   bool need_update_nodes_visibility;
 
+  /* Indicates whether the critical path time of the operations has to be initialized before the
+   * next evaluation, because they have not been evaluated since the graph was built. */
+  bool need_update_critical_path_time;
+
   /* Indicated whether IDs in this graph are to be tagged as if they first appear visible, with
    * an optional tag for their animation (time) update. */
   bool need_tag_id_on_graph_visibility_update;
@@ -0,0 +1,217 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+
+#include "BLI_listbase.h"
+#include "BLI_task.h"
+#include "BLI_vector.hh"
+
+#include "BKE_anim_data.hh"
+#include "BKE_callbacks.hh"
+#include "BKE_fcurve_driver.h"
+#include "BKE_node_runtime.hh"
+
+#include "DNA_anim_types.h"
+#include "DNA_modifier_types.h"
+#include "DNA_node_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_build.hh"
+#include "DEG_depsgraph_parallel_frames.hh"
+
+#include "intern/depsgraph.hh"
+#include "intern/node/deg_node_id.hh"
+
+namespace blender::deg::parallel_frames {
+
+/** Particles, cloth and soft bodies are simulated from the state at the previous frame. */
+static bool object_is_simulated(const Object &object)
+{
+  if (!BLI_listbase_is_empty(&object.particlesystem) || object.soft != nullptr) {
+    return true;
+  }
+  LISTBASE_FOREACH (const ModifierData *, md, &object.modifiers) {
+    if (ELEM(md->type, eModifierType_Cloth, eModifierType_Softbody)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Python expressions can read anything, including the original data, which is not updated for
+ * the evaluated frame, and can store state between evaluations.
+ */
+static bool id_has_python_drivers(const ID &id)
+{
+  const AnimData *adt = BKE_animdata_from_id(&id);
+  if (adt == nullptr) {
+    return false;
+  }
+  LISTBASE_FOREACH (FCurve *, fcu, &adt->drivers) {
+    ChannelDriver *driver = fcu->driver;
+    if (driver && driver->type == DRIVER_TYPE_PYTHON &&
+        !BKE_driver_has_simple_expression(driver))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool frames_are_independent(const ::Depsgraph &depsgraph)
+{
+  /* Frame change handlers are not called for the frames evaluated in parallel, and usually modify
+   * the original data. */
+  if (BKE_callback_is_used(BKE_CB_EVT_FRAME_CHANGE_PRE) ||
+      BKE_callback_is_used(BKE_CB_EVT_FRAME_CHANGE_POST))
+  {
+    return false;
+  }
+  const deg::Depsgraph &deg_graph = reinterpret_cast<const deg::Depsgraph &>(depsgraph);
+  if (deg_graph.scene->rigidbody_world != nullptr) {
+    return false;
+  }
+  for (const IDNode *id_node : deg_graph.id_nodes) {
+    if (id_node->find_component(NodeType::POINT_CACHE) != nullptr) {
+      return false;
+    }
+    if (id_has_python_drivers(*id_node->id_orig)) {
+      return false;
+    }
+    if (id_node->id_type == ID_OB) {
+      if (object_is_simulated(*reinterpret_cast<const Object *>(id_node->id_orig))) {
+        return false;
+      }
+    }
+    else if (id_node->id_type == ID_NT) {
+      const bNodeTree *ntree = reinterpret_cast<const bNodeTree *>(id_node->id_orig);
+      if (ntree->runtime->runtime_flag & NTREE_RUNTIME_FLAG_HAS_SIMULATION_ZONE) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+namespace {
+
+/* Dependency graph with the frame it is being evaluated at. */
+struct FrameSlot {
+  ::Depsgraph *depsgraph;
+  int64_t frame_index;
+  bool is_evaluated;
+};
+
+struct EvaluateState {
+  Span<float> frames;
+  Vector<FrameSlot> slots;
+
+  std::mutex mutex;
+  std::condition_variable cond;
+};
+
+void evaluate_slot_task(TaskPool *pool, void *taskdata)
+{
+  EvaluateState &state = *static_cast<EvaluateState *>(BLI_task_pool_user_data(pool));
+  FrameSlot &slot = *static_cast<FrameSlot *>(taskdata);
+
+  DEG_evaluate_on_framechange(slot.depsgraph, state.frames[slot.frame_index]);
+
+  {
+    std::lock_guard lock(state.mutex);
+    slot.is_evaluated = true;
+  }
+  state.cond.notify_all();
+}
+
+void evaluate_serial(::Depsgraph &depsgraph,
+                     const Span<float> frames,
+                     const FunctionRef<bool(::Depsgraph &depsgraph, int64_t frame_index)> frame_fn)
+{
+  for (const int64_t frame_index : frames.index_range()) {
+    DEG_evaluate_on_framechange(&depsgraph, frames[frame_index]);
+    if (!frame_fn(depsgraph, frame_index)) {
+      break;
+    }
+  }
+}
+
+}  // namespace
+
+void evaluate(::Depsgraph &depsgraph,
+              const Span<float> frames,
+              const int graphs_num,
+              const FunctionRef<::Depsgraph *()> graph_create_fn,
+              const FunctionRef<bool(::Depsgraph &depsgraph, int64_t frame_index)> frame_fn)
+{
+  const int64_t slots_num = std::min<int64_t>(graphs_num, frames.size());
+  if (slots_num <= 1 || BLI_task_scheduler_num_threads() <= 1) {
+    evaluate_serial(depsgraph, frames, frame_fn);
+    return;
+  }
+
+  EvaluateState state;
+  state.frames = frames;
+  state.slots.append({&depsgraph, -1, false});
+  /* Creating and building graphs accesses original data, do it from this thread only. */
+  while (state.slots.size() < slots_num) {
+    ::Depsgraph *new_graph = graph_create_fn();
+    if (new_graph == nullptr) {
+      break;
+    }
+    DEG_graph_relations_update(new_graph);
+    state.slots.append({new_graph, -1, false});
+  }
+
+  /* Background pool, so that tasks are never executed on this thread: it has to stay available
+   * for consuming frames in order. */
+  TaskPool *task_pool = BLI_task_pool_create_background(&state, TASK_PRIORITY_HIGH);
+  auto push_frame = [&](FrameSlot &slot, const int64_t frame_index) {
+    slot.frame_index = frame_index;
+    slot.is_evaluated = false;
+    BLI_task_pool_push(task_pool, evaluate_slot_task, &slot, false, nullptr);
+  };
+
+  for (const int64_t i : state.slots.index_range()) {
+    push_frame(state.slots[i], i);
+  }
+
+  /* Frames are distributed round-robin over the graphs, so the graph evaluating a frame is known
+   * in advance, and can be given the frame after the next ones as soon as it is consumed. */
+  for (const int64_t frame_index : frames.index_range()) {
+    FrameSlot &slot = state.slots[frame_index % state.slots.size()];
+    BLI_assert(slot.frame_index == frame_index);
+    {
+      std::unique_lock lock(state.mutex);
+      state.cond.wait(lock, [&]() { return slot.is_evaluated; });
+    }
+    if (!frame_fn(*slot.depsgraph, frame_index)) {
+      break;
+    }
+    const int64_t next_frame_index = frame_index + state.slots.size();
+    if (next_frame_index < frames.size()) {
+      push_frame(slot, next_frame_index);
+    }
+  }
+
+  /* Wait for frames which are still being evaluated after cancellation. */
+  BLI_task_pool_work_and_wait(task_pool);
+  BLI_task_pool_free(task_pool);
+
+  for (const FrameSlot &slot : state.slots.as_span().drop_front(1)) {
+    DEG_graph_free(slot.depsgraph);
+  }
+}
+
+}  // namespace blender::deg::parallel_frames
@@ -8,20 +8,25 @@
  * Evaluation engine entry-points for Depsgraph Engine.
  */
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <mutex>
 
 #include "intern/eval/deg_eval.h"
 
 #include "BLI_function_ref.hh"
 #include "BLI_gsqueue.h"
+#include "BLI_mutex.hh"
 #include "BLI_task.h"
 #include "BLI_time.h"
+#include "BLI_vector.hh"
 
 #include "BKE_global.hh"
 
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
+#include "DNA_userdef_types.h"
 
 #include "DEG_depsgraph.hh"
 #include "DEG_depsgraph_query.hh"
@@ -32,10 +37,12 @@
 
 #include "atomic_ops.h"
 
+#include "intern/debug/deg_debug_trace.h"
 #include "intern/depsgraph.hh"
 #include "intern/depsgraph_relation.hh"
 #include "intern/depsgraph_tag.hh"
 #include "intern/eval/deg_eval_copy_on_write.h"
+#include "intern/eval/deg_eval_critical_path.h"
 #include "intern/eval/deg_eval_flush.h"
 #include "intern/eval/deg_eval_stats.h"
 #include "intern/eval/deg_eval_visibility.h"
@@ -76,14 +83,64 @@ enum class EvaluationStage {
   SINGLE_THREADED_WORKAROUND,
 };
 
+const char *evaluation_stage_name(const EvaluationStage stage)
+{
+  switch (stage) {
+    case EvaluationStage::COPY_ON_EVAL:
+      return "Copy-on-Evaluation";
+    case EvaluationStage::DYNAMIC_VISIBILITY:
+      return "Dynamic Visibility";
+    case EvaluationStage::THREADED_EVALUATION:
+      return "Threaded Evaluation";
+    case EvaluationStage::SINGLE_THREADED_WORKAROUND:
+      return "Single Threaded Workaround";
+  }
+  BLI_assert_unreachable();
+  return "";
+}
+
 struct DepsgraphEvalState {
   Depsgraph *graph;
   bool do_stats;
+  /* Record evaluation timeline of operations, see #DEG_debug_trace_begin(). */
+  bool do_trace;
+  /* Evaluate operations with the longest chain of dependent operations first, using the timing
+   * of the previous evaluation. Helps to keep all threads busy until the very end of the graph
+   * evaluation when there are few long chains, such as character rigs. */
+  bool do_critical_path;
   EvaluationStage stage;
   bool need_update_pending_parents = true;
   bool need_single_thread_pass = false;
+
+  /* Heap of operations which are ready to be evaluated, ordered by their critical path time.
+   * Only used by the critical path scheduling: tasks pushed to the task pool pick the most
+   * important operation from the heap rather than the one they were pushed for. */
+  Mutex ready_operations_mutex;
+  Vector<OperationNode *> ready_operations;
 };
 
+bool ready_operation_less(const OperationNode *a, const OperationNode *b)
+{
+  return a->critical_path_time < b->critical_path_time;
+}
+
+void ready_operations_push(DepsgraphEvalState *state, OperationNode *node)
+{
+  std::lock_guard lock(state->ready_operations_mutex);
+  state->ready_operations.append(node);
+  std::push_heap(
+      state->ready_operations.begin(), state->ready_operations.end(), ready_operation_less);
+}
+
+OperationNode *ready_operations_pop(DepsgraphEvalState *state)
+{
+  std::lock_guard lock(state->ready_operations_mutex);
+  BLI_assert(!state->ready_operations.is_empty());
+  std::pop_heap(
+      state->ready_operations.begin(), state->ready_operations.end(), ready_operation_less);
+  return state->ready_operations.pop_last();
+}
+
 void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
 {
   ::Depsgraph *depsgraph = reinterpret_cast<::Depsgraph *>(state->graph);
@@ -91,10 +148,18 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
   /* Sanity checks. */
   BLI_assert_msg(!operation_node->is_noop(), "NOOP nodes should not actually be scheduled");
   /* Perform operation. */
-  if (state->do_stats) {
+  if (state->do_stats || state->do_trace || state->do_critical_path) {
     const double start_time = BLI_time_now_seconds();
     operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += BLI_time_now_seconds() - start_time;
+    const double end_time = BLI_time_now_seconds();
+    operation_node->eval_time = float(end_time - start_time);
+    if (state->do_stats) {
+      operation_node->stats.current_time += end_time - start_time;
+    }
+    if (state->do_trace) {
+      trace_record_operation(
+          state->graph, operation_node, operation_node->trace_schedule_time, start_time, end_time);
+    }
   }
   else {
     operation_node->evaluate(depsgraph);
@@ -107,18 +172,31 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
   operation_node->flag &= ~DEPSOP_FLAG_CLEAR_ON_EVAL;
 }
 
+void task_pool_push_node(DepsgraphEvalState *state, TaskPool *pool, OperationNode *node)
+{
+  if (state->do_critical_path) {
+    /* Make the operation available before the task which is to evaluate it can run. */
+    ready_operations_push(state, node);
+  }
+  BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
+}
+
 void deg_task_run_func(TaskPool *pool, void *taskdata)
 {
   void *userdata_v = BLI_task_pool_user_data(pool);
   DepsgraphEvalState *state = (DepsgraphEvalState *)userdata_v;
 
-  /* Evaluate node. */
-  OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
+  /* Evaluate node.
+   * With the critical path scheduling there is one task per ready operation, but the task takes
+   * the most important operation which is ready at the time it runs. */
+  OperationNode *operation_node = state->do_critical_path ?
+                                      ready_operations_pop(state) :
+                                      reinterpret_cast<OperationNode *>(taskdata);
   evaluate_node(state, operation_node);
 
   /* Schedule children. */
   schedule_children(state, operation_node, [&](OperationNode *node) {
-    BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
+    task_pool_push_node(state, pool, node);
   });
 }
 
@@ -276,6 +354,9 @@ void schedule_node(DepsgraphEvalState *state,
       schedule_children(state, node, schedule_fn);
     }
     else {
+      if (state->do_trace) {
+        node->trace_schedule_time = BLI_time_now_seconds();
+      }
       /* children are scheduled once this task is completed */
       schedule_fn(node);
     }
@@ -314,12 +395,18 @@ void evaluate_graph_threaded_stage(DepsgraphEvalState *state,
 {
   state->stage = stage;
 
+  const double start_time = state->do_trace ? BLI_time_now_seconds() : 0.0;
+
   calculate_pending_parents_if_needed(state);
 
-  schedule_graph(state, [&](OperationNode *node) {
-    BLI_task_pool_push(task_pool, deg_task_run_func, node, false, nullptr);
-  });
+  schedule_graph(state,
+                 [&](OperationNode *node) { task_pool_push_node(state, task_pool, node); });
   BLI_task_pool_work_and_wait(task_pool);
+
+  if (state->do_trace) {
+    trace_record_span(
+        state->graph, evaluation_stage_name(stage), start_time, BLI_time_now_seconds());
+  }
 }
 
 /* Evaluate remaining operations of the dependency graph in a single threaded manner. */
@@ -333,6 +420,8 @@ void evaluate_graph_single_threaded_if_needed(DepsgraphEvalState *state)
 
   state->stage = EvaluationStage::SINGLE_THREADED_WORKAROUND;
 
+  const double start_time = state->do_trace ? BLI_time_now_seconds() : 0.0;
+
   GSQueue *evaluation_queue = BLI_gsqueue_new(sizeof(OperationNode *));
   auto schedule_node_to_queue = [&](OperationNode *node) {
     BLI_gsqueue_push(evaluation_queue, &node);
@@ -348,6 +437,13 @@ void evaluate_graph_single_threaded_if_needed(DepsgraphEvalState *state)
   }
 
   BLI_gsqueue_free(evaluation_queue);
+
+  if (state->do_trace) {
+    trace_record_span(state->graph,
+                      evaluation_stage_name(EvaluationStage::SINGLE_THREADED_WORKAROUND),
+                      start_time,
+                      BLI_time_now_seconds());
+  }
 }
 
 void depsgraph_ensure_view_layer(Depsgraph *graph)
@@ -397,6 +493,7 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   graph->update_count = global_update_count.fetch_add(1) + 1;
 
   graph->debug.begin_graph_evaluation();
+  const double start_time = BLI_time_now_seconds();
 
 #ifdef WITH_PYTHON
   /* Release the GIL so that Python drivers can be evaluated. See #91046. */
@@ -410,6 +507,15 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   DepsgraphEvalState state;
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
+  state.do_trace = trace_is_enabled();
+  state.do_critical_path = USER_EXPERIMENTAL_TEST(&U, use_depsgraph_critical_path_scheduling) &&
+                           (G.debug & G_DEBUG_DEPSGRAPH_NO_THREADS) == 0;
+
+  /* Without timing of a previous evaluation, prioritize operations by the length of the longest
+   * chain of operations depending on them. */
+  if (state.do_critical_path && graph->need_update_critical_path_time) {
+    deg_graph_update_critical_path_time(graph);
+  }
 
   /* Prepare all nodes for evaluation. */
   initialize_execution(&state, graph);
@@ -465,6 +571,15 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
     deg_eval_stats_aggregate(graph);
   }
 
+  /* Prepare priorities for the next evaluation, based on the timing of this one. */
+  if (state.do_critical_path) {
+    deg_graph_update_critical_path_time(graph);
+  }
+
+  if (state.do_trace) {
+    trace_record_span(graph, "Depsgraph Evaluation", start_time, BLI_time_now_seconds());
+  }
+
   /* Clear any uncleared tags. */
   deg_graph_clear_tags(graph);
   graph->is_evaluating = false;
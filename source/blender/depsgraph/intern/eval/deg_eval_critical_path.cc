@@ -0,0 +1,84 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/eval/deg_eval_critical_path.h"
+
+#include <algorithm>
+
+#include "BLI_assert.h"
+#include "BLI_stack.hh"
+
+#include "intern/depsgraph.hh"
+#include "intern/depsgraph_relation.hh"
+#include "intern/node/deg_node.hh"
+#include "intern/node/deg_node_operation.hh"
+
+namespace blender::deg {
+
+/* Cost of an operation which has not been evaluated yet, or which takes no measurable time.
+ * Makes it so long chains of such operations are still preferred over short ones. */
+static constexpr float OPERATION_MIN_TIME = 1e-6f;
+
+static float operation_node_own_time(const OperationNode *op_node)
+{
+  if (op_node->is_noop()) {
+    return 0.0f;
+  }
+  return std::max(op_node->eval_time, OPERATION_MIN_TIME);
+}
+
+void deg_graph_update_critical_path_time(Depsgraph *graph)
+{
+  enum {
+    DEG_NODE_VISITED = (1 << 0),
+  };
+
+  Stack<OperationNode *> stack;
+
+  /* Walk the graph from the leaves up to the roots, so that the critical path time of all
+   * children is known by the time a node is visited. */
+  for (OperationNode *op_node : graph->operations) {
+    op_node->custom_flags = 0;
+    op_node->num_links_pending = 0;
+    op_node->critical_path_time = operation_node_own_time(op_node);
+    for (Relation *rel : op_node->outlinks) {
+      if ((rel->to->type == NodeType::OPERATION) && (rel->flag & RELATION_FLAG_CYCLIC) == 0) {
+        ++op_node->num_links_pending;
+      }
+    }
+    if (op_node->num_links_pending == 0) {
+      stack.push(op_node);
+      op_node->custom_flags |= DEG_NODE_VISITED;
+    }
+  }
+
+  while (!stack.is_empty()) {
+    OperationNode *op_node = stack.pop();
+
+    for (Relation *rel : op_node->inlinks) {
+      if (rel->from->type != NodeType::OPERATION || (rel->flag & RELATION_FLAG_CYCLIC) != 0) {
+        continue;
+      }
+      OperationNode *op_from = reinterpret_cast<OperationNode *>(rel->from);
+      op_from->critical_path_time = std::max(op_from->critical_path_time,
+                                             operation_node_own_time(op_from) +
+                                                 op_node->critical_path_time);
+
+      BLI_assert(op_from->num_links_pending > 0);
+      --op_from->num_links_pending;
+      if ((op_from->num_links_pending == 0) && (op_from->custom_flags & DEG_NODE_VISITED) == 0) {
+        stack.push(op_from);
+        op_from->custom_flags |= DEG_NODE_VISITED;
+      }
+    }
+  }
+
+  graph->need_update_critical_path_time = false;
+}
+
+}  // namespace blender::deg
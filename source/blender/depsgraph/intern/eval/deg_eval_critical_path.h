@@ -0,0 +1,21 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#pragma once
+
+namespace blender::deg {
+
+struct Depsgraph;
+
+/* Update the critical path time of all operation nodes from the evaluation time of the operations
+ * measured during the latest graph evaluation. The critical path time is used to prioritize the
+ * evaluation of the longest chains of operations. Operations which have not been evaluated yet
+ * count with a minimal time, so for a new graph this is based on the length of the chains. */
+void deg_graph_update_critical_path_time(Depsgraph *graph);
+
+}  // namespace blender::deg
@@ -209,7 +209,10 @@ const char *operationCodeAsString(OperationCode opcode)
   return "UNKNOWN";
 }
 
-OperationNode::OperationNode() : name_tag(-1), flag(0) {}
+OperationNode::OperationNode()
+    : name_tag(-1), flag(0), eval_time(0.0f), critical_path_time(0.0f), trace_schedule_time(0.0)
+{
+}
 
 std::string OperationNode::identifier() const
 {
@@ -294,6 +294,17 @@ struct OperationNode : public Node {
   /* (OperationFlag) extra settings affecting evaluation. */
   int flag;
 
+  /* Time in seconds the latest evaluation of this operation took, and the estimated time needed
+   * to evaluate this operation followed by the longest chain of operations depending on it.
+   * Only updated when the critical path scheduling is used, see
+   * #deg_graph_update_critical_path_time(). */
+  float eval_time;
+  float critical_path_time;
+
+  /* Time at which the operation got scheduled for evaluation.
+   * Only set when the evaluation timeline is being recorded, see #DEG_debug_trace_begin(). */
+  double trace_schedule_time;
+
   DEG_DEPSNODE_DECLARE;
 };
 
@@ -132,6 +132,7 @@ static wmOperatorStatus wm_alembic_export_exec(bContext *C, wmOperator *op)
   params.evaluation_mode = eEvaluationMode(RNA_enum_get(op->ptr, "evaluation_mode"));
 
   params.global_scale = RNA_float_get(op->ptr, "global_scale");
+  params.parallel_frames = RNA_int_get(op->ptr, "parallel_frames");
 
   RNA_string_get(op->ptr, "collection", params.collection);
 
@@ -200,6 +201,7 @@ static void ui_alembic_export_settings(const bContext *C,
 
     col = &panel->column(true);
     col->prop(ptr, "evaluation_mode", UI_ITEM_NONE, std::nullopt, ICON_NONE);
+    col->prop(ptr, "parallel_frames", UI_ITEM_NONE, std::nullopt, ICON_NONE);
   }
 
   /* Object Data */
@@ -478,6 +480,19 @@ void WM_OT_alembic_export(wmOperatorType *ot)
                "Determines visibility of objects, modifier settings, and other areas where there "
                "are different settings for viewport and rendering");
 
+  RNA_def_int(ot->srna,
+              "parallel_frames",
+              1,
+              1,
+              64,
+              "Parallel Frames",
+              "Number of frames to evaluate at the same time, each with its own copy of the "
+              "evaluated scene data. Only used when frames do not depend on previous frames (no "
+              "simulations, point caches, frame change handlers or Python drivers). Uses more "
+              "memory",
+              1,
+              16);
+
   /* This dummy prop is used to check whether we need to init the start and
    * end frame values to that of the scene's, otherwise they are reset at
    * every change, draw update. */
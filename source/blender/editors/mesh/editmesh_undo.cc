@@ -23,6 +23,7 @@
 #include "BLI_implicit_sharing.hh"
 #include "BLI_listbase.h"
 #include "BLI_math_base.h"
+#include "BLI_multi_value_map.hh"
 #include "BLI_string.h"
 #include "BLI_task.hh"
 #include "BLI_vector.hh"
@@ -216,6 +217,75 @@ static struct {
 
 } um_arraystore = {{{nullptr}}};
 
+/** Consecutive custom-data layers of a trivial type, de-duplicated with the same store. */
+struct UMTrivialLayers {
+  eCustomDataType type;
+  blender::MutableSpan<CustomDataLayer> layers;
+  BArrayStore *bs;
+};
+
+/**
+ * Add the data of the layers to the array store, clearing them.
+ */
+static blender::Array<BArrayState *> um_arraystore_cd_layers_add(
+    BArrayStore *bs,
+    const eCustomDataType type,
+    blender::MutableSpan<CustomDataLayer> layers_with_type,
+    const size_t data_len,
+    const blender::Array<BArrayState *> *bcd_reference_current)
+{
+  using namespace blender;
+  const int stride = CustomData_sizeof(type);
+  Array<BArrayState *> states(layers_with_type.size());
+
+  for (const int i : layers_with_type.index_range()) {
+    CustomDataLayer &layer = layers_with_type[i];
+    if (!layer.data) {
+      states[i] = nullptr;
+      continue;
+    }
+
+    const BArrayState *state_reference = nullptr;
+    if (bcd_reference_current && i < bcd_reference_current->size()) {
+      state_reference = (*bcd_reference_current)[i];
+    }
+
+    void *data_final = layer.data;
+    size_t data_final_size = size_t(data_len) * stride;
+
+#  ifdef USE_ARRAY_STORE_RLE
+    const bool use_rle = um_customdata_layer_use_rle(type);
+    uint8_t *data_enc = nullptr;
+    if (use_rle) {
+      /* Store the size in the encoded data (for convenience). */
+      size_t data_enc_extra_size = sizeof(size_t);
+      size_t data_enc_len;
+      data_enc = BLI_array_store_rle_encode(reinterpret_cast<const uint8_t *>(data_final),
+                                            data_final_size,
+                                            data_enc_extra_size,
+                                            &data_enc_len);
+      memcpy(data_enc, &data_final_size, data_enc_extra_size);
+      data_final = data_enc;
+      data_final_size = data_enc_extra_size + data_enc_len;
+    }
+#  endif
+
+    states[i] = BLI_array_store_state_add(bs, data_final, data_final_size, state_reference);
+
+#  ifdef USE_ARRAY_STORE_RLE
+    if (use_rle) {
+      MEM_freeN(data_enc);
+    }
+#  endif
+
+    layer.sharing_info->remove_user_and_delete_if_last();
+    layer.sharing_info = nullptr;
+    layer.data = nullptr;
+  }
+
+  return states;
+}
+
 static BArrayCustomData *um_arraystore_cd_create(CustomData *cdata,
                                                  const size_t data_len,
                                                  const int bs_index,
@@ -223,6 +293,7 @@ static BArrayCustomData *um_arraystore_cd_create(CustomData *cdata,
 {
   using namespace blender;
   BArrayCustomData bcd;
+  Vector<UMTrivialLayers> trivial_layers;
 
   MutableSpan all_layers(cdata->layers, cdata->totlayer);
 
@@ -260,61 +331,41 @@ static BArrayCustomData *um_arraystore_cd_create(CustomData *cdata,
       continue;
     }
 
-    Array<BArrayState *> states(layers_with_type.size());
-
     const int stride = CustomData_sizeof(type);
     BArrayStore *bs = BLI_array_store_at_size_ensure(
         &um_arraystore.bs_stride[bs_index], stride, array_chunk_size_calc(stride));
+    trivial_layers.append({type, layers_with_type, bs});
+  }
 
-    const Array<BArrayState *> *bcd_reference_current =
-        bcd_reference ? bcd_reference->trivial_arrays.lookup_ptr(type) : nullptr;
-
-    for (const int i : layers_with_type.index_range()) {
-      CustomDataLayer &layer = layers_with_type[i];
-      if (!layer.data) {
-        states[i] = nullptr;
-        continue;
-      }
-
-      const BArrayState *state_reference = nullptr;
-      if (bcd_reference_current && i < bcd_reference_current->size()) {
-        state_reference = (*bcd_reference_current)[i];
-      }
-
-      void *data_final = layer.data;
-      size_t data_final_size = size_t(data_len) * stride;
-
-#  ifdef USE_ARRAY_STORE_RLE
-      const bool use_rle = um_customdata_layer_use_rle(type);
-      uint8_t *data_enc = nullptr;
-      if (use_rle) {
-        /* Store the size in the encoded data (for convenience). */
-        size_t data_enc_extra_size = sizeof(size_t);
-        size_t data_enc_len;
-        data_enc = BLI_array_store_rle_encode(reinterpret_cast<const uint8_t *>(data_final),
-                                              data_final_size,
-                                              data_enc_extra_size,
-                                              &data_enc_len);
-        memcpy(data_enc, &data_final_size, data_enc_extra_size);
-        data_final = data_enc;
-        data_final_size = data_enc_extra_size + data_enc_len;
-      }
-#  endif
-
-      states[i] = BLI_array_store_state_add(bs, data_final, data_final_size, state_reference);
+  /* Layers using different array stores are independent, so they can be de-duplicated in
+   * parallel. Layers sharing a store (same size) are handled in order by a single task. */
+  MultiValueMap<BArrayStore *, int> layers_by_store;
+  Vector<BArrayStore *> stores;
+  for (const int i : trivial_layers.index_range()) {
+    if (layers_by_store.lookup(trivial_layers[i].bs).is_empty()) {
+      stores.append(trivial_layers[i].bs);
+    }
+    layers_by_store.add(trivial_layers[i].bs, i);
+  }
 
-#  ifdef USE_ARRAY_STORE_RLE
-      if (use_rle) {
-        MEM_freeN(data_enc);
+  Array<Array<BArrayState *>> trivial_states(trivial_layers.size());
+  const int64_t grain_size = data_len > 4096 ? 1 : stores.size();
+  threading::parallel_for(stores.index_range(), grain_size, [&](const IndexRange range) {
+    for (BArrayStore *bs : stores.as_span().slice(range)) {
+      for (const int layer_index : layers_by_store.lookup(bs)) {
+        const UMTrivialLayers &trivial = trivial_layers[layer_index];
+        trivial_states[layer_index] = um_arraystore_cd_layers_add(
+            trivial.bs,
+            trivial.type,
+            trivial.layers,
+            data_len,
+            bcd_reference ? bcd_reference->trivial_arrays.lookup_ptr(trivial.type) : nullptr);
       }
-#  endif
-
-      layer.sharing_info->remove_user_and_delete_if_last();
-      layer.sharing_info = nullptr;
-      layer.data = nullptr;
     }
+  });
 
-    bcd.trivial_arrays.add_new(type, std::move(states));
+  for (const int i : trivial_layers.index_range()) {
+    bcd.trivial_arrays.add_new(trivial_layers[i].type, std::move(trivial_states[i]));
   }
 
   if (bcd.trivial_arrays.is_empty() && bcd.non_trivial_arrays.is_empty()) {
@@ -433,9 +484,9 @@ static void um_arraystore_compact(UndoMesh *um, const UndoMesh *um_ref)
 
   /* Compacting can be time consuming, run in parallel.
    *
-   * NOTE(@ideasman42): this could be further parallelized with every custom-data layer
-   * running in its own thread. If this is a bottleneck it's worth considering.
-   * At the moment it seems fast enough to split by domain.
+   * Split by domain here, custom-data layers using different array stores are further
+   * parallelized by #um_arraystore_cd_create, and large arrays are hashed in parallel by the
+   * array store itself.
    * Since this is itself a background thread, using too many threads here could
    * interfere with foreground tasks. */
 
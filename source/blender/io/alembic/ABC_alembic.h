@@ -59,6 +59,10 @@ struct AlembicExportParams {
 
   float global_scale;
 
+  /* Number of frames evaluated at the same time when the frames are independent from each other,
+   * each with its own depsgraph. Values below 2 evaluate frames one after the other. */
+  int parallel_frames;
+
   char collection[MAX_ID_NAME - 2] = "";
 };
 
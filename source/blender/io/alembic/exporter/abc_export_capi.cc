@@ -11,6 +11,7 @@
 
 #include "DEG_depsgraph.hh"
 #include "DEG_depsgraph_build.hh"
+#include "DEG_depsgraph_parallel_frames.hh"
 #include "DEG_depsgraph_query.hh"
 
 #include "DNA_scene_types.h"
@@ -25,6 +26,7 @@
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
 #include "BLI_timeit.hh"
+#include "BLI_vector.hh"
 
 #include "WM_api.hh"
 #include "WM_types.hh"
@@ -50,7 +52,7 @@ struct ExportJobData {
 namespace blender::io::alembic {
 
 /* Construct the depsgraph for exporting. */
-static bool build_depsgraph(ExportJobData *job)
+static bool build_depsgraph(ExportJobData *job, Depsgraph *depsgraph)
 {
   if (job->params.collection[0]) {
     Collection *collection = reinterpret_cast<Collection *>(
@@ -61,10 +63,10 @@ static bool build_depsgraph(ExportJobData *job)
       return false;
     }
 
-    DEG_graph_build_from_collection(job->depsgraph, collection);
+    DEG_graph_build_from_collection(depsgraph, collection);
   }
   else {
-    DEG_graph_build_from_view_layer(job->depsgraph);
+    DEG_graph_build_from_view_layer(depsgraph);
   }
 
   return true;
@@ -78,6 +80,22 @@ static void report_job_duration(const ExportJobData *data)
   std::cout << '\n';
 }
 
+/* Create another depsgraph for evaluating frames in parallel, built like the main one.
+ * Unlike the main depsgraph this is done from the job thread, which is fine as the deferred
+ * updates of the original data have already been done when building the main depsgraph. */
+static Depsgraph *create_frame_depsgraph(ExportJobData *data)
+{
+  Depsgraph *depsgraph = DEG_graph_new(data->bmain,
+                                       DEG_get_input_scene(data->depsgraph),
+                                       DEG_get_input_view_layer(data->depsgraph),
+                                       data->params.evaluation_mode);
+  if (!build_depsgraph(data, depsgraph)) {
+    DEG_graph_free(depsgraph);
+    return nullptr;
+  }
+  return depsgraph;
+}
+
 static void export_startjob(void *customdata, wmJobWorkerStatus *worker_status)
 {
   ExportJobData *data = static_cast<ExportJobData *>(customdata);
@@ -141,6 +159,42 @@ static void export_startjob(void *customdata, wmJobWorkerStatus *worker_status)
     ABCArchive::Frames::const_iterator frame_it = abc_archive->frames_begin();
     const ABCArchive::Frames::const_iterator frames_end = abc_archive->frames_end();
 
+    const bool use_parallel_frames = data->params.parallel_frames > 1 &&
+                                     deg::parallel_frames::frames_are_independent(
+                                         *data->depsgraph);
+    if (use_parallel_frames) {
+      /* Evaluate several frames at the same time with their own depsgraphs, writing them in order
+       * as they become available. The input scene is not changed. */
+      const Vector<double> frames(frame_it, frames_end);
+      Vector<float> eval_frames;
+      for (const double frame : frames) {
+        eval_frames.append(float(frame));
+      }
+      deg::parallel_frames::evaluate(
+          *data->depsgraph,
+          eval_frames,
+          data->params.parallel_frames,
+          [&]() { return create_frame_depsgraph(data); },
+          [&](Depsgraph &depsgraph, const int64_t frame_index) {
+            if (G.is_break || worker_status->stop) {
+              return false;
+            }
+            const double frame = frames[frame_index];
+            CLOG_DEBUG(&LOG, "Exporting frame %.2f", frame);
+            iter.set_depsgraph(&depsgraph);
+            ExportSubset export_subset = abc_archive->export_subset_for_frame(frame);
+            iter.set_export_subset(export_subset);
+            iter.iterate_and_write();
+
+            worker_status->progress += progress_per_frame;
+            worker_status->do_update = true;
+            return true;
+          });
+      /* The other depsgraphs are freed by now. */
+      iter.set_depsgraph(data->depsgraph);
+      frame_it = frames_end;
+    }
+
     for (; frame_it != frames_end; frame_it++) {
       double frame = *frame_it;
 
@@ -220,7 +274,7 @@ bool ABC_export(Scene *scene,
    *
    * Has to be done from main thread currently, as it may affect Main original data (e.g. when
    * doing deferred update of the view-layers, see #112534 for details). */
-  if (!blender::io::alembic::build_depsgraph(job)) {
+  if (!blender::io::alembic::build_depsgraph(job, job->depsgraph)) {
     return false;
   }
 
@@ -35,8 +35,21 @@ ABCHierarchyIterator::ABCHierarchyIterator(Main *bmain,
 
 void ABCHierarchyIterator::iterate_and_write()
 {
+  /* Iterating writes transforms and creates Alembic objects, which cannot happen while the
+   * previous frame is still being written. */
+  write_queue_.wait();
   AbstractHierarchyIterator::iterate_and_write();
+  write_queue_.prepare();
   update_archive_bounding_box();
+  write_queue_.write_async();
+}
+
+void ABCHierarchyIterator::set_depsgraph(Depsgraph *depsgraph)
+{
+  AbstractHierarchyIterator::set_depsgraph(depsgraph);
+  for (AbstractHierarchyWriter *writer : writers_.values()) {
+    static_cast<ABCAbstractWriter *>(writer)->set_depsgraph(depsgraph);
+  }
 }
 
 void ABCHierarchyIterator::update_archive_bounding_box()
@@ -79,6 +92,7 @@ bool ABCHierarchyIterator::mark_as_weak_export(const Object *object) const
 
 void ABCHierarchyIterator::release_writer(AbstractHierarchyWriter *writer)
 {
+  write_queue_.wait();
   delete writer;
 }
 
@@ -141,7 +155,7 @@ Alembic::Abc::OObject ABCHierarchyIterator::get_alembic_parent(
 }
 
 ABCWriterConstructorArgs ABCHierarchyIterator::writer_constructor_args(
-    const HierarchyContext *context) const
+    const HierarchyContext *context)
 {
   ABCWriterConstructorArgs constructor_args;
   constructor_args.depsgraph = depsgraph_;
@@ -151,6 +165,7 @@ ABCWriterConstructorArgs ABCHierarchyIterator::writer_constructor_args(
   constructor_args.abc_path = context->export_path;
   constructor_args.hierarchy_iterator = this;
   constructor_args.export_params = &params_;
+  constructor_args.write_queue = &write_queue_;
   return constructor_args;
 }
 
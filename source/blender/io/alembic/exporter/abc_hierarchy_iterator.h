@@ -5,6 +5,7 @@
 
 #include "ABC_alembic.h"
 #include "abc_archive.h"
+#include "abc_write_queue.h"
 
 #include "IO_abstract_hierarchy_iterator.h"
 
@@ -29,12 +30,14 @@ struct ABCWriterConstructorArgs {
   std::string abc_path;
   const ABCHierarchyIterator *hierarchy_iterator;
   const AlembicExportParams *export_params;
+  ABCWriteQueue *write_queue;
 };
 
 class ABCHierarchyIterator : public AbstractHierarchyIterator {
  private:
   ABCArchive *abc_archive_;
   const AlembicExportParams &params_;
+  ABCWriteQueue write_queue_;
 
  public:
   ABCHierarchyIterator(Main *bmain,
@@ -43,6 +46,7 @@ class ABCHierarchyIterator : public AbstractHierarchyIterator {
                        const AlembicExportParams &params);
 
   void iterate_and_write() override;
+  void set_depsgraph(Depsgraph *depsgraph) override;
   std::string make_valid_name(const std::string &name) const override;
 
   Alembic::Abc::OObject get_alembic_object(const std::string &export_path) const;
@@ -65,7 +69,7 @@ class ABCHierarchyIterator : public AbstractHierarchyIterator {
 
  private:
   Alembic::Abc::OObject get_alembic_parent(const HierarchyContext *context) const;
-  ABCWriterConstructorArgs writer_constructor_args(const HierarchyContext *context) const;
+  ABCWriterConstructorArgs writer_constructor_args(const HierarchyContext *context);
   void update_archive_bounding_box();
   void update_bounding_box_recursive(Imath::Box3d &bounds, const HierarchyContext *context);
 
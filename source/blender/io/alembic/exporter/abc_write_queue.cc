@@ -0,0 +1,73 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup balembic
+ */
+
+#include "abc_write_queue.h"
+#include "abc_writer_abstract.h"
+
+#include "BLI_task.hh"
+
+#include <utility>
+
+namespace blender::io::alembic {
+
+ABCWriteQueue::~ABCWriteQueue()
+{
+  /* Only reached with a running thread when the export is aborted by an exception, in which case
+   * a second exception from the background thread is not interesting anymore. */
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void ABCWriteQueue::add(ABCAbstractWriter *writer)
+{
+  writers_.append(writer);
+}
+
+void ABCWriteQueue::prepare()
+{
+  threading::parallel_for(writers_.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      writers_[i]->prepare_sample();
+    }
+  });
+}
+
+void ABCWriteQueue::write_async()
+{
+  BLI_assert(!thread_.joinable());
+  if (writers_.is_empty()) {
+    return;
+  }
+  writing_writers_ = std::move(writers_);
+  writers_.clear();
+  thread_ = std::thread([this]() {
+    try {
+      for (ABCAbstractWriter *writer : writing_writers_) {
+        writer->write_sample();
+      }
+    }
+    catch (...) {
+      exception_ = std::current_exception();
+    }
+  });
+}
+
+void ABCWriteQueue::wait()
+{
+  if (!thread_.joinable()) {
+    return;
+  }
+  thread_.join();
+  writing_writers_.clear();
+  if (exception_) {
+    std::rethrow_exception(std::exchange(exception_, nullptr));
+  }
+}
+
+}  // namespace blender::io::alembic
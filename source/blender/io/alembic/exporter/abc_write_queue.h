@@ -0,0 +1,58 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+#pragma once
+
+/** \file
+ * \ingroup balembic
+ */
+
+#include "BLI_vector.hh"
+
+#include <exception>
+#include <thread>
+
+namespace blender::io::alembic {
+
+class ABCAbstractWriter;
+
+/* Writers which are queued while iterating over the export hierarchy, so that the data of the
+ * frame can be written in two steps:
+ *
+ * - The data of all queued writers is extracted from the evaluated objects in parallel, see
+ *   #ABCAbstractWriter::prepare_sample(). This still needs the depsgraph of the frame.
+ * - The prepared samples are written to the archive by a single background thread, as Alembic
+ *   is not thread-safe, see #ABCAbstractWriter::write_sample(). This does not access any Blender
+ *   data anymore, so the depsgraph can already evaluate the next frame meanwhile.
+ *
+ * Nothing else may write to the archive while the background thread is running, so #wait() has
+ * to be called before that. */
+class ABCWriteQueue {
+ private:
+  /* Writers queued for the current frame. */
+  Vector<ABCAbstractWriter *> writers_;
+  /* Writers of which the samples are being written by #thread_. */
+  Vector<ABCAbstractWriter *> writing_writers_;
+  std::thread thread_;
+  /* Exception thrown while writing in the background, rethrown by #wait(). */
+  std::exception_ptr exception_;
+
+ public:
+  ABCWriteQueue() = default;
+  ABCWriteQueue(const ABCWriteQueue &other) = delete;
+  ABCWriteQueue &operator=(const ABCWriteQueue &other) = delete;
+  ~ABCWriteQueue();
+
+  void add(ABCAbstractWriter *writer);
+
+  /* Extract the data of all queued writers in parallel. */
+  void prepare();
+
+  /* Start writing the prepared samples in the background. */
+  void write_async();
+
+  /* Wait until the samples of the previous frame have been written. */
+  void wait();
+};
+
+}  // namespace blender::io::alembic
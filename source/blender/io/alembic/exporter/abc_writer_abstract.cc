@@ -55,6 +55,10 @@ void ABCAbstractWriter::write(HierarchyContext &context)
   frame_has_been_written_ = true;
 }
 
+void ABCAbstractWriter::prepare_sample() {}
+
+void ABCAbstractWriter::write_sample() {}
+
 void ABCAbstractWriter::ensure_custom_properties_exporter(const HierarchyContext &context)
 {
   if (!args_.export_params->export_custom_properties) {
@@ -91,6 +95,11 @@ uint32_t ABCAbstractWriter::timesample_index() const
   return timesample_index_;
 }
 
+void ABCAbstractWriter::set_depsgraph(Depsgraph *depsgraph)
+{
+  args_.depsgraph = depsgraph;
+}
+
 const Imath::Box3d &ABCAbstractWriter::bounding_box() const
 {
   return bounding_box_;
@@ -18,7 +18,7 @@ namespace blender::io::alembic {
 
 class ABCAbstractWriter : public AbstractHierarchyWriter {
  protected:
-  const ABCWriterConstructorArgs args_;
+  ABCWriterConstructorArgs args_;
 
   bool frame_has_been_written_;
   bool is_animated_;
@@ -46,6 +46,7 @@ class ABCAbstractWriter : public AbstractHierarchyWriter {
   virtual bool is_supported(const HierarchyContext *context) const;
 
   uint32_t timesample_index() const;
+  void set_depsgraph(Depsgraph *depsgraph);
   const Imath::Box3d &bounding_box() const;
 
   /* Called by AlembicHierarchyCreator after checking that the data is supported via
@@ -64,6 +65,16 @@ class ABCAbstractWriter : public AbstractHierarchyWriter {
    */
   virtual Alembic::Abc::OCompoundProperty abc_prop_for_custom_props() = 0;
 
+  /* Writers that add themselves to the #ABCWriteQueue in do_write() implement these two steps.
+   *
+   * prepare_sample() extracts the data to write from the evaluated object. It is called in
+   * parallel with other writers, so it must not access the Alembic archive.
+   *
+   * write_sample() writes the prepared data to the archive. It may run while the depsgraph
+   * evaluates the next frame, so it must not access any Blender data. */
+  virtual void prepare_sample();
+  virtual void write_sample();
+
  protected:
   virtual void do_write(HierarchyContext &context) = 0;
 
@@ -140,10 +140,32 @@ void ABCGenericMeshWriter::do_write(HierarchyContext &context)
   if (mesh == nullptr) {
     return;
   }
+  ExportMeshPtr mesh_owner(needsfree ? mesh : nullptr, ExportMeshDeleter{this});
 
   /* Ensure data exists if currently in edit mode. */
   BKE_mesh_wrapper_ensure_mdata(mesh);
 
+  if (args_.export_params->orcos) {
+    /* The texture space may be computed lazily, which is not thread-safe when the mesh is shared
+     * by multiple objects. */
+    BKE_mesh_texspace_ensure(mesh->texcomesh ? mesh->texcomesh : mesh);
+  }
+
+  export_object_ = object;
+  export_mesh_ = mesh;
+  export_mesh_owner_ = std::move(mesh_owner);
+  sample_.write_face_sets = !frame_has_been_written_ && args_.export_params->face_sets;
+
+  /* Triangulating and extracting the mesh data is done in parallel with other writers. */
+  args_.write_queue->add(this);
+}
+
+void ABCGenericMeshWriter::prepare_sample()
+{
+  Mesh *mesh = export_mesh_;
+  ExportMeshPtr mesh_owner = std::move(export_mesh_owner_);
+  export_mesh_ = nullptr;
+
   if (args_.export_params->triangulate) {
     const bool tag_only = false;
     const int quad_method = args_.export_params->quad_method;
@@ -160,40 +182,45 @@ void ABCGenericMeshWriter::do_write(HierarchyContext &context)
     Mesh *triangulated_mesh = BKE_mesh_from_bmesh_for_eval_nomain(bm, nullptr, mesh);
     BM_mesh_free(bm);
 
-    if (needsfree) {
-      free_export_mesh(mesh);
-    }
     mesh = triangulated_mesh;
-    needsfree = true;
+    mesh_owner.reset(triangulated_mesh);
   }
 
   m_custom_data_config.pack_uvs = args_.export_params->packuv;
   m_custom_data_config.mesh = mesh;
-  m_custom_data_config.face_offsets = mesh->face_offsets_for_write().data();
-  m_custom_data_config.corner_verts = mesh->corner_verts_for_write().data();
   m_custom_data_config.faces_num = mesh->faces_num;
   m_custom_data_config.totloop = mesh->corners_num;
   m_custom_data_config.totvert = mesh->verts_num;
   m_custom_data_config.timesample_index = timesample_index_;
 
-  try {
-    if (is_subd_) {
-      write_subd(context, mesh);
-    }
-    else {
-      write_mesh(context, mesh);
-    }
+  if (is_subd_) {
+    prepare_subd_sample(mesh);
+  }
+  else {
+    prepare_mesh_sample(mesh);
+  }
 
-    if (needsfree) {
-      free_export_mesh(mesh);
-    }
+  if (sample_.write_face_sets) {
+    sample_.face_sets.clear();
+    get_geo_groups(export_object_, mesh, sample_.face_sets);
   }
-  catch (...) {
-    if (needsfree) {
-      free_export_mesh(mesh);
-    }
-    throw;
+
+  update_bounding_box(export_object_);
+
+  m_custom_data_config.mesh = nullptr;
+}
+
+void ABCGenericMeshWriter::write_sample()
+{
+  if (is_subd_) {
+    write_subd_sample();
+  }
+  else {
+    write_mesh_sample();
   }
+
+  /* The archive has its own copy of the data now, so don't keep it around until the next frame. */
+  sample_ = {};
 }
 
 void ABCGenericMeshWriter::free_export_mesh(Mesh *mesh)
@@ -201,144 +228,179 @@ void ABCGenericMeshWriter::free_export_mesh(Mesh *mesh)
   BKE_id_free(nullptr, mesh);
 }
 
-void ABCGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
+void ABCGenericMeshWriter::prepare_mesh_sample(Mesh *mesh)
 {
-  std::vector<Imath::V3f> points, normals;
-  std::vector<int32_t> face_verts, loop_counts;
-  std::vector<Imath::V3f> velocities;
+  MeshSample &sample = sample_;
 
-  get_vertices(mesh, points);
-  get_topology(mesh, face_verts, loop_counts);
+  get_vertices(mesh, sample.points);
+  get_topology(mesh, sample.face_verts, sample.loop_counts);
 
-  if (!frame_has_been_written_ && args_.export_params->face_sets) {
-    write_face_sets(context.object, mesh, abc_poly_mesh_schema_);
+  if (args_.export_params->uvs) {
+    sample.uv_map_name = get_uv_sample(sample.uvs, m_custom_data_config, *mesh);
+    get_custom_data(sample.custom_data, m_custom_data_config, *mesh, CD_PROP_FLOAT2);
   }
 
-  OPolyMeshSchema::Sample mesh_sample = OPolyMeshSchema::Sample(
-      V3fArraySample(points), Int32ArraySample(face_verts), Int32ArraySample(loop_counts));
+  if (args_.export_params->normals) {
+    get_loop_normals(mesh, sample.normals);
+  }
+
+  if (args_.export_params->orcos) {
+    get_generated_coordinates(sample.custom_data, m_custom_data_config);
+  }
+
+  sample.has_velocities = get_velocities(mesh, sample.velocities);
+
+  if (args_.export_params->vcolors) {
+    get_custom_data(sample.custom_data, m_custom_data_config, *mesh, CD_PROP_BYTE_COLOR);
+  }
+}
+
+void ABCGenericMeshWriter::prepare_subd_sample(Mesh *mesh)
+{
+  MeshSample &sample = sample_;
 
-  UVSample uvs_and_indices;
+  get_vertices(mesh, sample.points);
+  get_topology(mesh, sample.face_verts, sample.loop_counts);
+  get_edge_creases(mesh,
+                   sample.edge_crease_indices,
+                   sample.edge_crease_lengths,
+                   sample.edge_crease_sharpness);
+  get_vert_creases(mesh, sample.vert_crease_indices, sample.vert_crease_sharpness);
 
   if (args_.export_params->uvs) {
-    const char *name = get_uv_sample(uvs_and_indices, m_custom_data_config, *mesh);
+    sample.uv_map_name = get_uv_sample(sample.uvs, m_custom_data_config, *mesh);
+    get_custom_data(sample.custom_data, m_custom_data_config, *mesh, CD_PROP_FLOAT2);
+  }
+
+  if (args_.export_params->orcos) {
+    get_generated_coordinates(sample.custom_data, m_custom_data_config);
+  }
 
-    if (!uvs_and_indices.indices.empty() && !uvs_and_indices.uvs.empty()) {
+  if (args_.export_params->vcolors) {
+    get_custom_data(sample.custom_data, m_custom_data_config, *mesh, CD_PROP_BYTE_COLOR);
+  }
+}
+
+void ABCGenericMeshWriter::write_mesh_sample()
+{
+  MeshSample &sample = sample_;
+
+  if (sample.write_face_sets) {
+    write_face_sets(abc_poly_mesh_schema_);
+  }
+
+  OPolyMeshSchema::Sample mesh_sample = OPolyMeshSchema::Sample(
+      V3fArraySample(sample.points),
+      Int32ArraySample(sample.face_verts),
+      Int32ArraySample(sample.loop_counts));
+
+  if (args_.export_params->uvs) {
+    if (!sample.uvs.indices.empty() && !sample.uvs.uvs.empty()) {
       OV2fGeomParam::Sample uv_sample;
-      uv_sample.setVals(V2fArraySample(uvs_and_indices.uvs));
-      uv_sample.setIndices(UInt32ArraySample(uvs_and_indices.indices));
+      uv_sample.setVals(V2fArraySample(sample.uvs.uvs));
+      uv_sample.setIndices(UInt32ArraySample(sample.uvs.indices));
       uv_sample.setScope(kFacevaryingScope);
 
-      abc_poly_mesh_schema_.setUVSourceName(name);
+      abc_poly_mesh_schema_.setUVSourceName(sample.uv_map_name);
       mesh_sample.setUVs(uv_sample);
     }
 
-    write_custom_data(
-        abc_poly_mesh_schema_.getArbGeomParams(), m_custom_data_config, *mesh, CD_PROP_FLOAT2);
+    write_custom_data(abc_poly_mesh_schema_.getArbGeomParams(),
+                      m_custom_data_config,
+                      sample.custom_data,
+                      CD_PROP_FLOAT2);
   }
 
   if (args_.export_params->normals) {
-    get_loop_normals(mesh, normals);
-
     ON3fGeomParam::Sample normals_sample;
-    if (!normals.empty()) {
+    if (!sample.normals.empty()) {
       normals_sample.setScope(kFacevaryingScope);
-      normals_sample.setVals(V3fArraySample(normals));
+      normals_sample.setVals(V3fArraySample(sample.normals));
     }
 
     mesh_sample.setNormals(normals_sample);
   }
 
   if (args_.export_params->orcos) {
-    write_generated_coordinates(abc_poly_mesh_schema_.getArbGeomParams(), m_custom_data_config);
+    write_generated_coordinates(
+        abc_poly_mesh_schema_.getArbGeomParams(), m_custom_data_config, sample.custom_data);
   }
 
-  if (get_velocities(mesh, velocities)) {
-    mesh_sample.setVelocities(V3fArraySample(velocities));
+  if (sample.has_velocities) {
+    mesh_sample.setVelocities(V3fArraySample(sample.velocities));
   }
 
-  update_bounding_box(context.object);
   mesh_sample.setSelfBounds(bounding_box_);
 
   abc_poly_mesh_schema_.set(mesh_sample);
 
-  write_arb_geo_params(mesh);
+  write_arb_geo_params();
 }
 
-void ABCGenericMeshWriter::write_subd(HierarchyContext &context, Mesh *mesh)
+void ABCGenericMeshWriter::write_subd_sample()
 {
-  std::vector<float> edge_crease_sharpness, vert_crease_sharpness;
-  std::vector<Imath::V3f> points;
-  std::vector<int32_t> face_verts, loop_counts;
-  std::vector<int32_t> edge_crease_indices, edge_crease_lengths, vert_crease_indices;
+  MeshSample &sample = sample_;
 
-  get_vertices(mesh, points);
-  get_topology(mesh, face_verts, loop_counts);
-  get_edge_creases(mesh, edge_crease_indices, edge_crease_lengths, edge_crease_sharpness);
-  get_vert_creases(mesh, vert_crease_indices, vert_crease_sharpness);
-
-  if (!frame_has_been_written_ && args_.export_params->face_sets) {
-    write_face_sets(context.object, mesh, abc_subdiv_schema_);
+  if (sample.write_face_sets) {
+    write_face_sets(abc_subdiv_schema_);
   }
 
-  OSubDSchema::Sample subdiv_sample = OSubDSchema::Sample(
-      V3fArraySample(points), Int32ArraySample(face_verts), Int32ArraySample(loop_counts));
+  OSubDSchema::Sample subdiv_sample = OSubDSchema::Sample(V3fArraySample(sample.points),
+                                                          Int32ArraySample(sample.face_verts),
+                                                          Int32ArraySample(sample.loop_counts));
 
-  UVSample sample;
   if (args_.export_params->uvs) {
-    const char *name = get_uv_sample(sample, m_custom_data_config, *mesh);
-
-    if (!sample.indices.empty() && !sample.uvs.empty()) {
+    if (!sample.uvs.indices.empty() && !sample.uvs.uvs.empty()) {
       OV2fGeomParam::Sample uv_sample;
-      uv_sample.setVals(V2fArraySample(sample.uvs));
-      uv_sample.setIndices(UInt32ArraySample(sample.indices));
+      uv_sample.setVals(V2fArraySample(sample.uvs.uvs));
+      uv_sample.setIndices(UInt32ArraySample(sample.uvs.indices));
       uv_sample.setScope(kFacevaryingScope);
 
-      abc_subdiv_schema_.setUVSourceName(name);
+      abc_subdiv_schema_.setUVSourceName(sample.uv_map_name);
       subdiv_sample.setUVs(uv_sample);
     }
 
-    write_custom_data(
-        abc_subdiv_schema_.getArbGeomParams(), m_custom_data_config, *mesh, CD_PROP_FLOAT2);
+    write_custom_data(abc_subdiv_schema_.getArbGeomParams(),
+                      m_custom_data_config,
+                      sample.custom_data,
+                      CD_PROP_FLOAT2);
   }
 
   if (args_.export_params->orcos) {
-    write_generated_coordinates(abc_subdiv_schema_.getArbGeomParams(), m_custom_data_config);
+    write_generated_coordinates(
+        abc_subdiv_schema_.getArbGeomParams(), m_custom_data_config, sample.custom_data);
   }
 
-  if (!edge_crease_indices.empty()) {
-    subdiv_sample.setCreaseIndices(Int32ArraySample(edge_crease_indices));
-    subdiv_sample.setCreaseLengths(Int32ArraySample(edge_crease_lengths));
-    subdiv_sample.setCreaseSharpnesses(FloatArraySample(edge_crease_sharpness));
+  if (!sample.edge_crease_indices.empty()) {
+    subdiv_sample.setCreaseIndices(Int32ArraySample(sample.edge_crease_indices));
+    subdiv_sample.setCreaseLengths(Int32ArraySample(sample.edge_crease_lengths));
+    subdiv_sample.setCreaseSharpnesses(FloatArraySample(sample.edge_crease_sharpness));
   }
 
-  if (!vert_crease_indices.empty()) {
-    subdiv_sample.setCornerIndices(Int32ArraySample(vert_crease_indices));
-    subdiv_sample.setCornerSharpnesses(FloatArraySample(vert_crease_sharpness));
+  if (!sample.vert_crease_indices.empty()) {
+    subdiv_sample.setCornerIndices(Int32ArraySample(sample.vert_crease_indices));
+    subdiv_sample.setCornerSharpnesses(FloatArraySample(sample.vert_crease_sharpness));
   }
 
-  update_bounding_box(context.object);
   subdiv_sample.setSelfBounds(bounding_box_);
   abc_subdiv_schema_.set(subdiv_sample);
 
-  write_arb_geo_params(mesh);
+  write_arb_geo_params();
 }
 
-template<typename Schema>
-void ABCGenericMeshWriter::write_face_sets(Object *object, Mesh *mesh, Schema &schema)
+template<typename Schema> void ABCGenericMeshWriter::write_face_sets(Schema &schema)
 {
-  std::map<std::string, std::vector<int32_t>> geo_groups;
-  get_geo_groups(object, mesh, geo_groups);
-
   std::map<std::string, std::vector<int32_t>>::iterator it;
-  for (it = geo_groups.begin(); it != geo_groups.end(); ++it) {
+  for (it = sample_.face_sets.begin(); it != sample_.face_sets.end(); ++it) {
     OFaceSet face_set = schema.createFaceSet(it->first);
     OFaceSetSchema::Sample samp;
     samp.setFaces(Int32ArraySample(it->second));
     face_set.getSchema().set(samp);
   }
+  sample_.face_sets.clear();
 }
 
-void ABCGenericMeshWriter::write_arb_geo_params(Mesh *mesh)
+void ABCGenericMeshWriter::write_arb_geo_params()
 {
   if (!args_.export_params->vcolors) {
     return;
@@ -351,7 +413,8 @@ void ABCGenericMeshWriter::write_arb_geo_params(Mesh *mesh)
   else {
     arb_geom_params = abc_poly_mesh_.getSchema().getArbGeomParams();
   }
-  write_custom_data(arb_geom_params, m_custom_data_config, *mesh, CD_PROP_BYTE_COLOR);
+  write_custom_data(
+      arb_geom_params, m_custom_data_config, sample_.custom_data, CD_PROP_BYTE_COLOR);
 }
 
 bool ABCGenericMeshWriter::get_velocities(Mesh *mesh, std::vector<Imath::V3f> &vels)
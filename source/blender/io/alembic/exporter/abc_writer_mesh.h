@@ -13,6 +13,11 @@
 #include <Alembic/AbcGeom/OPolyMesh.h>
 #include <Alembic/AbcGeom/OSubD.h>
 
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
 struct ModifierData;
 
 namespace blender::io::alembic {
@@ -20,6 +25,30 @@ namespace blender::io::alembic {
 /* Writer for Alembic geometry. Does not assume the object is a mesh object. */
 class ABCGenericMeshWriter : public ABCAbstractWriter {
  private:
+  /* Data of one frame, extracted from the evaluated mesh by prepare_sample(). */
+  struct MeshSample {
+    std::vector<Imath::V3f> points;
+    std::vector<int32_t> face_verts;
+    std::vector<int32_t> loop_counts;
+    std::vector<Imath::V3f> normals;
+    std::vector<Imath::V3f> velocities;
+    bool has_velocities = false;
+
+    std::vector<int32_t> edge_crease_indices;
+    std::vector<int32_t> edge_crease_lengths;
+    std::vector<float> edge_crease_sharpness;
+    std::vector<int32_t> vert_crease_indices;
+    std::vector<float> vert_crease_sharpness;
+
+    std::string uv_map_name;
+    UVSample uvs;
+    CustomDataSample custom_data;
+
+    /* Face sets are only written once, with the first frame. */
+    bool write_face_sets = false;
+    std::map<std::string, std::vector<int32_t>> face_sets;
+  };
+
   /* Either poly-mesh or subdivision-surface is used, depending on is_subd_.
    * References to the schema must be kept, or Alembic will not properly write. */
   Alembic::AbcGeom::OPolyMesh abc_poly_mesh_;
@@ -36,6 +65,25 @@ class ABCGenericMeshWriter : public ABCAbstractWriter {
 
   CDStreamConfig m_custom_data_config;
 
+  /* Frees meshes created for the export with free_export_mesh(), also when exporting them throws
+   * an exception. */
+  struct ExportMeshDeleter {
+    ABCGenericMeshWriter *writer;
+    void operator()(Mesh *mesh) const
+    {
+      writer->free_export_mesh(mesh);
+    }
+  };
+  using ExportMeshPtr = std::unique_ptr<Mesh, ExportMeshDeleter>;
+
+  /* The mesh to export, from do_write() until its data is extracted by prepare_sample(). The owner
+   * is only set when the mesh was created for the export. */
+  Object *export_object_ = nullptr;
+  Mesh *export_mesh_ = nullptr;
+  ExportMeshPtr export_mesh_owner_{nullptr, ExportMeshDeleter{this}};
+
+  MeshSample sample_;
+
  public:
   explicit ABCGenericMeshWriter(const ABCWriterConstructorArgs &args);
 
@@ -43,6 +91,9 @@ class ABCGenericMeshWriter : public ABCAbstractWriter {
   Alembic::Abc::OObject get_alembic_object() const override;
   Alembic::Abc::OCompoundProperty abc_prop_for_custom_props() override;
 
+  void prepare_sample() override;
+  void write_sample() override;
+
  protected:
   bool is_supported(const HierarchyContext *context) const override;
   void do_write(HierarchyContext &context) override;
@@ -53,11 +104,13 @@ class ABCGenericMeshWriter : public ABCAbstractWriter {
   virtual bool export_as_subdivision_surface(Object *ob_eval) const;
 
  private:
-  void write_mesh(HierarchyContext &context, Mesh *mesh);
-  void write_subd(HierarchyContext &context, Mesh *mesh);
-  template<typename Schema> void write_face_sets(Object *object, Mesh *mesh, Schema &schema);
+  void prepare_mesh_sample(Mesh *mesh);
+  void prepare_subd_sample(Mesh *mesh);
+  void write_mesh_sample();
+  void write_subd_sample();
+  template<typename Schema> void write_face_sets(Schema &schema);
 
-  void write_arb_geo_params(Mesh *mesh);
+  void write_arb_geo_params();
   bool get_velocities(Mesh *mesh, std::vector<Imath::V3f> &vels);
   void get_geo_groups(Object *object,
                       Mesh *mesh,
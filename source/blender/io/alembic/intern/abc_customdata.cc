@@ -63,7 +63,7 @@ static void get_uvs(const CDStreamConfig &config,
                     const Span<float2> uv_map_array)
 {
   const OffsetIndices faces = config.mesh->faces();
-  int *corner_verts = config.corner_verts;
+  const Span<int> corner_verts = config.mesh->corner_verts();
 
   if (!config.pack_uvs) {
     int count = 0;
@@ -91,7 +91,7 @@ static void get_uvs(const CDStreamConfig &config,
 
     for (const int i : faces.index_range()) {
       const IndexRange face = faces[i];
-      int *face_verts = corner_verts + face.start() + face.size();
+      const int *face_verts = corner_verts.data() + face.start() + face.size();
       const float2 *loopuv = uv_map_array.data() + face.start() + face.size();
 
       for (int j = 0; j < face.size(); j++) {
@@ -145,25 +145,17 @@ const char *get_uv_sample(UVSample &sample, const CDStreamConfig &config, const
  */
 static void write_uv(const OCompoundProperty &prop,
                      CDStreamConfig &config,
-                     const Span<float2> data,
+                     const UVSample &uv_sample,
                      const std::string &uv_map_name)
 {
-  std::vector<uint32_t> indices;
-  std::vector<Imath::V2f> uvs;
-
-  get_uvs(config, uvs, indices, data);
-
-  if (indices.empty() || uvs.empty()) {
-    return;
-  }
-
   OV2fGeomParam param = config.abc_uv_maps[uv_map_name];
 
   if (!param.valid()) {
     param = OV2fGeomParam(prop, uv_map_name, true, kFacevaryingScope, 1);
   }
-  OV2fGeomParam::Sample sample(V2fArraySample(&uvs.front(), uvs.size()),
-                               UInt32ArraySample(&indices.front(), indices.size()),
+  OV2fGeomParam::Sample sample(V2fArraySample(&uv_sample.uvs.front(), uv_sample.uvs.size()),
+                               UInt32ArraySample(&uv_sample.indices.front(),
+                                                 uv_sample.indices.size()),
                                kFacevaryingScope);
   param.set(sample);
   param.setTimeSampling(config.timesample_index);
@@ -209,27 +201,19 @@ static void get_cols(const CDStreamConfig &config,
  */
 static void write_mcol(const OCompoundProperty &prop,
                        CDStreamConfig &config,
-                       const void *data,
+                       const ColorSample &color_sample,
                        const std::string &vcol_name)
 {
-  std::vector<uint32_t> indices;
-  std::vector<Imath::C4f> buffer;
-
-  get_cols(config, buffer, indices, data);
-
-  if (indices.empty() || buffer.empty()) {
-    return;
-  }
-
   OC4fGeomParam param = config.abc_vertex_colors[vcol_name];
 
   if (!param.valid()) {
     param = OC4fGeomParam(prop, vcol_name, true, kFacevaryingScope, 1);
   }
 
-  OC4fGeomParam::Sample sample(C4fArraySample(&buffer.front(), buffer.size()),
-                               UInt32ArraySample(&indices.front(), indices.size()),
-                               kVertexScope);
+  OC4fGeomParam::Sample sample(
+      C4fArraySample(&color_sample.colors.front(), color_sample.colors.size()),
+      UInt32ArraySample(&color_sample.indices.front(), color_sample.indices.size()),
+      kVertexScope);
 
   param.set(sample);
   param.setTimeSampling(config.timesample_index);
@@ -237,7 +221,7 @@ static void write_mcol(const OCompoundProperty &prop,
   config.abc_vertex_colors[vcol_name] = param;
 }
 
-void write_generated_coordinates(const OCompoundProperty &prop, CDStreamConfig &config)
+void get_generated_coordinates(CustomDataSample &sample, const CDStreamConfig &config)
 {
   Mesh *mesh = config.mesh;
   const void *customdata = CustomData_get_layer(&mesh->vert_data, CD_ORCO);
@@ -248,7 +232,8 @@ void write_generated_coordinates(const OCompoundProperty &prop, CDStreamConfig &
   const float (*orcodata)[3] = static_cast<const float (*)[3]>(customdata);
 
   /* Convert 3D vertices from float[3] z=up to V3f y=up. */
-  std::vector<Imath::V3f> coords(config.totvert);
+  std::vector<Imath::V3f> &coords = sample.generated_coordinates;
+  coords.resize(config.totvert);
   float orco_yup[3];
   for (int vertex_idx = 0; vertex_idx < config.totvert; vertex_idx++) {
     copy_yup_from_zup(orco_yup, orcodata[vertex_idx]);
@@ -259,20 +244,29 @@ void write_generated_coordinates(const OCompoundProperty &prop, CDStreamConfig &
    * unnormalized, so we need to unnormalize (invert transform) them. */
   BKE_mesh_orco_verts_transform(
       mesh, reinterpret_cast<float (*)[3]>(coords.data()), mesh->verts_num, true);
+}
+
+void write_generated_coordinates(const OCompoundProperty &prop,
+                                 CDStreamConfig &config,
+                                 const CustomDataSample &sample)
+{
+  if (sample.generated_coordinates.empty()) {
+    return;
+  }
 
   if (!config.abc_orco.valid()) {
     /* Create the Alembic property and keep a reference so future frames can reuse it. */
     config.abc_orco = OV3fGeomParam(prop, propNameOriginalCoordinates, false, kVertexScope, 1);
   }
 
-  OV3fGeomParam::Sample sample(coords, kVertexScope);
-  config.abc_orco.set(sample);
+  OV3fGeomParam::Sample orco_sample(sample.generated_coordinates, kVertexScope);
+  config.abc_orco.set(orco_sample);
 }
 
-void write_custom_data(const OCompoundProperty &prop,
-                       CDStreamConfig &config,
-                       const Mesh &mesh,
-                       int data_type)
+void get_custom_data(CustomDataSample &sample,
+                     const CDStreamConfig &config,
+                     const Mesh &mesh,
+                     const int data_type)
 {
   const bke::AttributeAccessor attributes = mesh.attributes();
   if (data_type == CD_PROP_FLOAT2) {
@@ -283,7 +277,12 @@ void write_custom_data(const OCompoundProperty &prop,
         continue;
       }
       const VArraySpan uv_map = *attributes.lookup<float2>(name, bke::AttrDomain::Corner);
-      write_uv(prop, config, uv_map, get_valid_abc_name(name.c_str()));
+      UVSample uv_sample;
+      get_uvs(config, uv_sample.uvs, uv_sample.indices, uv_map);
+      if (uv_sample.indices.empty() || uv_sample.uvs.empty()) {
+        continue;
+      }
+      sample.uv_maps.emplace_back(get_valid_abc_name(name.c_str()), std::move(uv_sample));
     }
   }
   else if (data_type == CD_PROP_BYTE_COLOR) {
@@ -296,11 +295,34 @@ void write_custom_data(const OCompoundProperty &prop,
       }
       const VArraySpan attr = *attributes.lookup<ColorGeometry4b>(iter.name,
                                                                   bke::AttrDomain::Corner);
-      write_mcol(prop, config, attr.data(), get_valid_abc_name(iter.name.c_str()));
+      ColorSample color_sample;
+      get_cols(config, color_sample.colors, color_sample.indices, attr.data());
+      if (color_sample.indices.empty() || color_sample.colors.empty()) {
+        return;
+      }
+      sample.vertex_colors.emplace_back(get_valid_abc_name(iter.name.c_str()),
+                                        std::move(color_sample));
     });
   }
 }
 
+void write_custom_data(const OCompoundProperty &prop,
+                       CDStreamConfig &config,
+                       const CustomDataSample &sample,
+                       const int data_type)
+{
+  if (data_type == CD_PROP_FLOAT2) {
+    for (const auto &[name, uv_sample] : sample.uv_maps) {
+      write_uv(prop, config, uv_sample, name);
+    }
+  }
+  else if (data_type == CD_PROP_BYTE_COLOR) {
+    for (const auto &[name, color_sample] : sample.vertex_colors) {
+      write_mcol(prop, config, color_sample, name);
+    }
+  }
+}
+
 /* ************************************************************************** */
 
 using Alembic::Abc::C3fArraySamplePtr;
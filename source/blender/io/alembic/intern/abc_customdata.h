@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 struct CustomData;
@@ -37,6 +38,21 @@ struct UVSample {
   std::vector<uint32_t> indices;
 };
 
+struct ColorSample {
+  std::vector<Imath::C4f> colors;
+  std::vector<uint32_t> indices;
+};
+
+/* Custom data extracted from a mesh, so that it can be written to Alembic without accessing the
+ * mesh anymore. Layers are stored with their Alembic name. */
+struct CustomDataSample {
+  /* The second and subsequent UV maps; the active UV map is part of the mesh sample itself. */
+  std::vector<std::pair<std::string, UVSample>> uv_maps;
+  std::vector<std::pair<std::string, ColorSample>> vertex_colors;
+  /* Empty when the mesh has no generated coordinates. */
+  std::vector<Imath::V3f> generated_coordinates;
+};
+
 struct CDStreamConfig {
   int *corner_verts = nullptr;
   int totloop = 0;
@@ -82,7 +98,11 @@ struct CDStreamConfig {
  * For now the active layer is used, maybe needs a better way to choose this. */
 const char *get_uv_sample(UVSample &sample, const CDStreamConfig &config, const Mesh &mesh);
 
-void write_generated_coordinates(const OCompoundProperty &prop, CDStreamConfig &config);
+void get_generated_coordinates(CustomDataSample &sample, const CDStreamConfig &config);
+
+void write_generated_coordinates(const OCompoundProperty &prop,
+                                 CDStreamConfig &config,
+                                 const CustomDataSample &sample);
 
 void read_velocity(const V3fArraySamplePtr &velocities,
                    const CDStreamConfig &config,
@@ -92,9 +112,16 @@ void read_generated_coordinates(const ICompoundProperty &prop,
                                 const CDStreamConfig &config,
                                 const Alembic::Abc::ISampleSelector &iss);
 
+/* Extract the UV maps (#CD_PROP_FLOAT2) or the vertex colors (#CD_PROP_BYTE_COLOR) of the
+ * mesh into the sample. */
+void get_custom_data(CustomDataSample &sample,
+                     const CDStreamConfig &config,
+                     const Mesh &mesh,
+                     int data_type);
+
 void write_custom_data(const OCompoundProperty &prop,
                        CDStreamConfig &config,
-                       const Mesh &mesh,
+                       const CustomDataSample &sample,
                        int data_type);
 
 void read_custom_data(const std::string &iobject_full_name,
@@ -273,6 +273,11 @@ class AbstractHierarchyIterator {
    * previous iteration. */
   void set_export_subset(ExportSubset export_subset);
 
+  /* Use another dependency graph for the following iterations, for example one evaluated at the
+   * next (sub)frame by #blender::deg::parallel_frames::evaluate(). The graph must be built from
+   * the same data as the one the iterator was constructed with. Existing writers are kept. */
+  virtual void set_depsgraph(Depsgraph *depsgraph);
+
   /* Convert the given name to something that is valid for the exported file format.
    * This base implementation is a no-op; override in a concrete subclass. */
   virtual std::string make_valid_name(const std::string &name) const;
@@ -0,0 +1,45 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <cstdint>
+
+#include "BLI_function_ref.hh"
+
+/*
+ * Bounded memory output of large files, used by the OBJ, PLY and STL exporters.
+ *
+ * The file is split into chunks that are formatted in parallel into a fixed ring of buffers
+ * ("slots"), and written in order by a dedicated writer thread. A chunk is only formatted once
+ * its slot has been written, so the memory used for formatted data does not depend on the size
+ * of the file.
+ */
+
+namespace blender::io {
+
+/** Default amount of memory for formatted chunks that wait to be written. */
+inline constexpr int64_t chunked_write_default_memory_budget = 64 * 1024 * 1024;
+
+/**
+ * Number of slots for #parallel_chunked_write that fit into `memory_budget`,
+ * when every chunk is formatted into about `chunk_bytes` bytes. This is at least two,
+ * so that formatting and writing can overlap.
+ */
+int chunked_write_slots_num(int64_t memory_budget, int64_t chunk_bytes);
+
+/**
+ * Format `chunks_num` chunks in parallel and write them in order.
+ *
+ * \param format_fn: Formats a chunk into the buffer of the given slot. Chunks are formatted
+ * concurrently, each into a different slot.
+ * \param write_fn: Writes the buffer of the given slot to the file and clears it. Called for every
+ * chunk in order, from a single thread, while later chunks are being formatted.
+ */
+void parallel_chunked_write(int64_t chunks_num,
+                            int slots_num,
+                            FunctionRef<void(int64_t chunk, int slot)> format_fn,
+                            FunctionRef<void(int slot)> write_fn);
+
+}  // namespace blender::io
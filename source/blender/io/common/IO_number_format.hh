@@ -0,0 +1,50 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <cstdint>
+
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
+#include "BLI_string_ref.hh"
+
+/*
+ * Number formatting used by text based exporters.
+ *
+ * The output is identical to formatting with `fmt` using `{}` for integers and `{:.Nf}` for
+ * floats, but much faster for the fixed precisions these formats use: the value is rounded to an
+ * integer number of units with exact integer arithmetic, and the digits are generated from that.
+ * Values that do not fit (very large or not finite) fall back to `fmt`.
+ *
+ * All functions write into `dst` without a null terminator and return the end of the written
+ * characters.
+ */
+
+namespace blender::io {
+
+/** Maximum precision supported by #format_fixed. */
+inline constexpr int format_fixed_max_precision = 9;
+/** Maximum number of characters written for a single number. */
+inline constexpr int format_number_max_len = 64;
+
+/**
+ * Write `value` in fixed-point notation with `precision` digits after the decimal point,
+ * like `fmt::format("{:.{}f}", value, precision)`.
+ */
+char *format_fixed(char *dst, float value, int precision);
+
+/** Write `value` in decimal notation, like `fmt::format("{}", value)`. */
+char *format_int(char *dst, int64_t value);
+
+/**
+ * Write a line for every vector: the prefix followed by the components in fixed-point notation,
+ * separated by spaces. E.g. `vn 0.0000 1.0000 0.0000\n` for a prefix of `vn`.
+ * `dst` must have room for `values.size() * (prefix.size() + 3 * format_number_max_len + 4)`
+ * characters.
+ */
+char *format_fixed_lines(char *dst, StringRef prefix, Span<float3> values, int precision);
+char *format_fixed_lines(char *dst, StringRef prefix, Span<float2> values, int precision);
+
+}  // namespace blender::io
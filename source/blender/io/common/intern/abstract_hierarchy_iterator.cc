@@ -210,6 +210,11 @@ void AbstractHierarchyIterator::set_export_subset(ExportSubset export_subset)
   export_subset_ = export_subset;
 }
 
+void AbstractHierarchyIterator::set_depsgraph(Depsgraph *depsgraph)
+{
+  depsgraph_ = depsgraph;
+}
+
 std::string AbstractHierarchyIterator::make_valid_name(const std::string &name) const
 {
   return name;
@@ -0,0 +1,91 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "IO_chunked_write.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "BLI_array.hh"
+#include "BLI_task.h"
+#include "BLI_task.hh"
+
+namespace blender::io {
+
+int chunked_write_slots_num(const int64_t memory_budget, const int64_t chunk_bytes)
+{
+  const int64_t slots_num = memory_budget / std::max<int64_t>(chunk_bytes, 1);
+  return int(std::clamp<int64_t>(slots_num, 2, 1024));
+}
+
+void parallel_chunked_write(const int64_t chunks_num,
+                            const int slots_num,
+                            const FunctionRef<void(int64_t chunk, int slot)> format_fn,
+                            const FunctionRef<void(int slot)> write_fn)
+{
+  BLI_assert(slots_num > 0);
+  const int workers_num = int(
+      std::min<int64_t>({chunks_num, slots_num, BLI_task_scheduler_num_threads()}));
+  if (workers_num <= 1) {
+    for (const int64_t chunk : IndexRange(chunks_num)) {
+      format_fn(chunk, 0);
+      write_fn(0);
+    }
+    return;
+  }
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  /* Chunk that was last formatted into every slot. */
+  Array<int64_t> slot_chunks(slots_num, -1);
+  int64_t written_chunks_num = 0;
+  /* Chunks are claimed in order, so the next chunk to write is always being formatted by a thread
+   * that does not wait for a slot. */
+  std::atomic<int64_t> next_chunk = 0;
+
+  /* The writer is not a task, so that it keeps running while all task threads format chunks. */
+  std::thread writer([&]() {
+    for (const int64_t chunk : IndexRange(chunks_num)) {
+      const int slot = int(chunk % slots_num);
+      {
+        std::unique_lock lock(mutex);
+        cond.wait(lock, [&]() { return slot_chunks[slot] == chunk; });
+      }
+      write_fn(slot);
+      {
+        std::lock_guard lock(mutex);
+        written_chunks_num = chunk + 1;
+      }
+      cond.notify_all();
+    }
+  });
+
+  threading::parallel_for(IndexRange(workers_num), 1, [&](const IndexRange range) {
+    for ([[maybe_unused]] const int64_t worker : range) {
+      while (true) {
+        const int64_t chunk = next_chunk.fetch_add(1);
+        if (chunk >= chunks_num) {
+          break;
+        }
+        const int slot = int(chunk % slots_num);
+        {
+          std::unique_lock lock(mutex);
+          cond.wait(lock, [&]() { return chunk < written_chunks_num + slots_num; });
+        }
+        format_fn(chunk, slot);
+        {
+          std::lock_guard lock(mutex);
+          slot_chunks[slot] = chunk;
+        }
+        cond.notify_all();
+      }
+    }
+  });
+  writer.join();
+}
+
+}  // namespace blender::io
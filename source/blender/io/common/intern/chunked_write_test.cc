@@ -0,0 +1,60 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "IO_chunked_write.hh"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+
+#include "BLI_array.hh"
+
+#include "testing/testing.h"
+
+namespace blender::io {
+
+TEST(io_common_chunked_write, slots_num)
+{
+  EXPECT_EQ(chunked_write_slots_num(1024, 2048), 2);
+  EXPECT_EQ(chunked_write_slots_num(64 * 1024, 1024), 64);
+  EXPECT_EQ(chunked_write_slots_num(1024, 0), 1024);
+}
+
+TEST(io_common_chunked_write, in_order)
+{
+  const int64_t chunks_num = 2000;
+  const int slots_num = 3;
+  Array<std::string> slots(slots_num);
+  std::string output;
+  std::string expected;
+  /* Number of chunks that are formatted but not written. */
+  int pending_num = 0;
+  int max_pending_num = 0;
+  std::mutex mutex;
+
+  parallel_chunked_write(
+      chunks_num,
+      slots_num,
+      [&](const int64_t chunk, const int slot) {
+        EXPECT_TRUE(slots[slot].empty());
+        slots[slot] = std::to_string(chunk) + ",";
+        std::lock_guard lock(mutex);
+        pending_num++;
+        max_pending_num = std::max(max_pending_num, pending_num);
+      },
+      [&](const int slot) {
+        output += slots[slot];
+        slots[slot].clear();
+        std::lock_guard lock(mutex);
+        pending_num--;
+      });
+
+  for (const int64_t chunk : IndexRange(chunks_num)) {
+    expected += std::to_string(chunk) + ",";
+  }
+  EXPECT_EQ(output, expected);
+  EXPECT_LE(max_pending_num, slots_num);
+}
+
+}  // namespace blender::io
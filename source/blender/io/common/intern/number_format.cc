@@ -0,0 +1,164 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "IO_number_format.hh"
+
+#include <cstring>
+
+#include "BLI_assert.h"
+
+/* SEP macro from BLI path utils clashes with SEP symbol in fmt headers. */
+#undef SEP
+#include <fmt/format.h>
+
+namespace blender::io {
+
+static constexpr uint64_t powers_of_ten[format_fixed_max_precision + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+/* Pairs of decimal digits, to generate two digits per division. */
+static constexpr char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static int count_digits(uint64_t value)
+{
+  int digits = 1;
+  while (value >= 100) {
+    value /= 100;
+    digits += 2;
+  }
+  return digits + (value >= 10);
+}
+
+/* Write exactly `digits` digits of `value`, including leading zeros. */
+static char *write_digits(char *dst, uint64_t value, const int digits)
+{
+  char *p = dst + digits;
+  while (p - dst >= 2) {
+    p -= 2;
+    memcpy(p, &digit_pairs[(value % 100) * 2], 2);
+    value /= 100;
+  }
+  if (p != dst) {
+    *--p = char('0' + value % 10);
+  }
+  return dst + digits;
+}
+
+static char *write_uint(char *dst, const uint64_t value)
+{
+  return write_digits(dst, value, count_digits(value));
+}
+
+char *format_int(char *dst, const int64_t value)
+{
+  if (value < 0) {
+    *dst++ = '-';
+    return write_uint(dst, ~uint64_t(value) + 1);
+  }
+  return write_uint(dst, uint64_t(value));
+}
+
+static char *format_fixed_fallback(char *dst, const float value, const int precision)
+{
+  return fmt::format_to_n(dst, format_number_max_len, "{:.{}f}", value, precision).out;
+}
+
+char *format_fixed(char *dst, const float value, const int precision)
+{
+  BLI_assert(precision >= 0 && precision <= format_fixed_max_precision);
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint32_t biased_exponent = (bits >> 23) & 0xff;
+  if (biased_exponent == 0xff) {
+    return format_fixed_fallback(dst, value, precision);
+  }
+  /* The value is `mantissa * 2^exponent`. */
+  uint64_t mantissa = bits & 0x7fffff;
+  int exponent = -149;
+  if (biased_exponent != 0) {
+    mantissa |= 0x800000;
+    exponent = int(biased_exponent) - 150;
+  }
+
+  /* Round `|value| * 10^precision` to the nearest integer, ties to even. The product of the
+   * mantissa and the power of ten takes at most 54 bits, so it is exact. */
+  const uint64_t scale = powers_of_ten[precision];
+  const uint64_t scaled = mantissa * scale;
+  uint64_t units;
+  if (exponent >= 0) {
+    if (exponent > 9) {
+      return format_fixed_fallback(dst, value, precision);
+    }
+    units = scaled << exponent;
+  }
+  else if (exponent > -64) {
+    const int shift = -exponent;
+    units = scaled >> shift;
+    const uint64_t remainder = scaled & ((uint64_t(1) << shift) - 1);
+    const uint64_t half = uint64_t(1) << (shift - 1);
+    if (remainder > half || (remainder == half && (units & 1))) {
+      units++;
+    }
+  }
+  else {
+    /* Less than half a unit. */
+    units = 0;
+  }
+
+  if (bits >> 31) {
+    *dst++ = '-';
+  }
+  dst = write_uint(dst, units / scale);
+  if (precision > 0) {
+    *dst++ = '.';
+    dst = write_digits(dst, units % scale, precision);
+  }
+  return dst;
+}
+
+template<typename VecT>
+static char *format_fixed_lines_impl(char *dst,
+                                     const StringRef prefix,
+                                     const Span<VecT> values,
+                                     const int precision)
+{
+  for (const VecT &value : values) {
+    memcpy(dst, prefix.data(), prefix.size());
+    dst += prefix.size();
+    for (int i = 0; i < VecT::type_length; i++) {
+      *dst++ = ' ';
+      dst = format_fixed(dst, value[i], precision);
+    }
+    *dst++ = '\n';
+  }
+  return dst;
+}
+
+char *format_fixed_lines(char *dst,
+                         const StringRef prefix,
+                         const Span<float3> values,
+                         const int precision)
+{
+  return format_fixed_lines_impl(dst, prefix, values, precision);
+}
+
+char *format_fixed_lines(char *dst,
+                         const StringRef prefix,
+                         const Span<float2> values,
+                         const int precision)
+{
+  return format_fixed_lines_impl(dst, prefix, values, precision);
+}
+
+}  // namespace blender::io
@@ -0,0 +1,159 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "IO_number_format.hh"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "BLI_rand.hh"
+#include "BLI_timeit.hh"
+#include "BLI_vector.hh"
+
+#undef SEP
+#include <fmt/format.h>
+
+#include "testing/testing.h"
+
+namespace blender::io {
+
+static std::string fixed_str(const float value, const int precision)
+{
+  char buf[format_number_max_len];
+  return std::string(buf, format_fixed(buf, value, precision));
+}
+
+static std::string int_str(const int64_t value)
+{
+  char buf[format_number_max_len];
+  return std::string(buf, format_int(buf, value));
+}
+
+static void expect_fixed_matches_fmt(const float value)
+{
+  for (int precision = 0; precision <= format_fixed_max_precision; precision++) {
+    EXPECT_EQ(fixed_str(value, precision), fmt::format("{:.{}f}", value, precision))
+        << "value bits: " << fmt::format("{:#x}", *reinterpret_cast<const uint32_t *>(&value));
+  }
+}
+
+TEST(io_common_number_format, fixed_special)
+{
+  EXPECT_EQ(fixed_str(1.0f, 6), "1.000000");
+  EXPECT_EQ(fixed_str(-0.5f, 4), "-0.5000");
+  EXPECT_EQ(fixed_str(-0.0f, 6), "-0.000000");
+  EXPECT_EQ(fixed_str(-1e-9f, 6), "-0.000000");
+  EXPECT_EQ(fixed_str(2.5f, 0), "2");
+  EXPECT_EQ(fixed_str(3.5f, 0), "4");
+  const float specials[] = {0.0f,
+                            -0.0f,
+                            0.5f,
+                            1.5f,
+                            0.125f,
+                            0.0000005f,
+                            123456.789f,
+                            -98765.4321f,
+                            1e10f,
+                            -3e25f,
+                            std::numeric_limits<float>::max(),
+                            std::numeric_limits<float>::lowest(),
+                            std::numeric_limits<float>::min(),
+                            std::numeric_limits<float>::denorm_min(),
+                            std::numeric_limits<float>::infinity(),
+                            -std::numeric_limits<float>::infinity(),
+                            std::numeric_limits<float>::quiet_NaN()};
+  for (const float value : specials) {
+    expect_fixed_matches_fmt(value);
+  }
+}
+
+TEST(io_common_number_format, fixed_random)
+{
+  RandomNumberGenerator rng(42);
+  for ([[maybe_unused]] const int i : IndexRange(100000)) {
+    /* Random bit patterns cover all exponents, values in a typical range cover many ties. */
+    const uint32_t bits = rng.get_uint32();
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    expect_fixed_matches_fmt(value);
+    expect_fixed_matches_fmt(rng.get_float() * 2000.0f - 1000.0f);
+    expect_fixed_matches_fmt(float(rng.get_int32(1 << 20)) / 1024.0f);
+  }
+}
+
+TEST(io_common_number_format, ints)
+{
+  const int64_t values[] = {0,
+                            7,
+                            -7,
+                            10,
+                            99,
+                            100,
+                            -1000,
+                            123456789,
+                            std::numeric_limits<int32_t>::max(),
+                            std::numeric_limits<int32_t>::min(),
+                            std::numeric_limits<uint32_t>::max(),
+                            std::numeric_limits<int64_t>::max(),
+                            std::numeric_limits<int64_t>::min()};
+  for (const int64_t value : values) {
+    EXPECT_EQ(int_str(value), fmt::format("{}", value));
+  }
+  RandomNumberGenerator rng(7);
+  for ([[maybe_unused]] const int i : IndexRange(10000)) {
+    const int64_t value = int64_t(rng.get_uint64()) >> rng.get_int32(64);
+    EXPECT_EQ(int_str(value), fmt::format("{}", value));
+  }
+}
+
+TEST(io_common_number_format, fixed_lines)
+{
+  const float3 values[] = {{1.0f, -2.5f, 0.0f}, {0.25f, 1e6f, -0.001f}};
+  char buf[2 * (3 + 3 * format_number_max_len + 4)];
+  char *end = format_fixed_lines(buf, "vn", Span<float3>(values, 2), 4);
+  EXPECT_EQ(std::string(buf, end),
+            "vn 1.0000 -2.5000 0.0000\n"
+            "vn 0.2500 1000000.0000 -0.0010\n");
+}
+
+#if 0
+/* Compare the throughput with `fmt`, in megabytes of output per second. */
+TEST(io_common_number_format, benchmark)
+{
+  RandomNumberGenerator rng(0);
+  Vector<float> values;
+  for ([[maybe_unused]] const int i : IndexRange(10000000)) {
+    values.append(rng.get_float() * 200.0f - 100.0f);
+  }
+  const auto megabytes_per_second = [](const int64_t bytes, const timeit::Nanoseconds time) {
+    return double(bytes) / (double(time.count()) * 1e-3);
+  };
+  for (const int precision : {4, 6}) {
+    fmt::memory_buffer fmt_buf;
+    const timeit::TimePoint fmt_start = timeit::Clock::now();
+    for (const float value : values) {
+      fmt::format_to(fmt::appender(fmt_buf), " {:.{}f}", value, precision);
+    }
+    const timeit::Nanoseconds fmt_time = timeit::Clock::now() - fmt_start;
+
+    Vector<char> buf(values.size() * (format_number_max_len + 1));
+    const timeit::TimePoint start = timeit::Clock::now();
+    char *end = buf.data();
+    for (const float value : values) {
+      *end++ = ' ';
+      end = format_fixed(end, value, precision);
+    }
+    const timeit::Nanoseconds time = timeit::Clock::now() - start;
+
+    std::cout << "Precision " << precision << ": fmt "
+              << megabytes_per_second(fmt_buf.size(), fmt_time) << " MB/s, format_fixed "
+              << megabytes_per_second(end - buf.data(), time) << " MB/s\n";
+    EXPECT_EQ(std::string(buf.data(), end), fmt::to_string(fmt_buf));
+  }
+}
+#endif
+
+}  // namespace blender::io
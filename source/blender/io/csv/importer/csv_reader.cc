@@ -8,8 +8,14 @@
 
 #include <atomic>
 #include <charconv>
+#include <fcntl.h>
 #include <optional>
 #include <variant>
+#ifndef WIN32
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
 
 #include "BLI_array_utils.hh"
 #include "fast_float.h"
@@ -22,6 +28,7 @@
 #include "BLI_csv_parse.hh"
 #include "BLI_fileops.hh"
 #include "BLI_implicit_sharing.hh"
+#include "BLI_mmap.h"
 #include "BLI_vector.hh"
 
 #include "IO_csv.hh"
@@ -178,6 +185,72 @@ static ChunkResult parse_records_chunk(const csv_parse::CsvRecords &records,
   return chunk_result;
 }
 
+/**
+ * Find the columns which contain floats in the records at the start of the file. Otherwise, every
+ * chunk that is parsed before the first float has been found elsewhere parses these columns as
+ * integers first, only to parse them again as floats.
+ */
+static void infer_float_columns_from_sample(const Span<char> buffer,
+                                            const csv_parse::CsvParseOptions &parse_options,
+                                            MutableSpan<ColumnInfo> columns_info)
+{
+  /* Only use complete lines, so that the last record in the sample is not cut off. */
+  const int64_t sample_size = 1024 * 1024;
+  const Span<char> sample = buffer.take_front(sample_size);
+  const int64_t sample_end = StringRef(sample.data(), sample.size()).rfind('\n');
+  if (sample_end == StringRef::not_found) {
+    return;
+  }
+
+  const auto parse_sample_chunk = [&](const csv_parse::CsvRecords &records) {
+    for (const int column_i : columns_info.index_range()) {
+      ColumnInfo &column_info = columns_info[column_i];
+      if (column_info.has_invalid_name || column_info.found_float.load(std::memory_order_relaxed))
+      {
+        continue;
+      }
+      if (parse_column_as_ints(records, column_i).found_float) {
+        column_info.found_float.store(true, std::memory_order_relaxed);
+      }
+    }
+    return 0;
+  };
+
+  /* The sample may end within a quoted field, in which case parsing fails and the column types
+   * are only determined while parsing the whole file. */
+  csv_parse::parse_csv_in_chunks<int>(
+      sample.take_front(sample_end + 1),
+      parse_options,
+      [](const csv_parse::CsvRecord & /*record*/) {},
+      parse_sample_chunk);
+}
+
+/**
+ * Get the contents of the file, mapped into memory if possible. That avoids copying the whole
+ * file upfront, and allows the OS to drop pages that have been parsed already when the file is
+ * larger than the available memory.
+ */
+static std::optional<Span<char>> map_or_read_file(const char *filepath,
+                                                  int &r_file,
+                                                  BLI_mmap_file *&r_mmap_file,
+                                                  void *&r_buffer)
+{
+  r_file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+  if (r_file != -1) {
+    r_mmap_file = BLI_mmap_open(r_file);
+    if (r_mmap_file) {
+      return Span<char>(static_cast<const char *>(BLI_mmap_get_pointer(r_mmap_file)),
+                        int64_t(BLI_mmap_get_length(r_mmap_file)));
+    }
+  }
+  size_t buffer_len;
+  r_buffer = BLI_file_read_text_as_mem(filepath, 0, &buffer_len);
+  if (r_buffer == nullptr) {
+    return std::nullopt;
+  }
+  return Span<char>(static_cast<const char *>(r_buffer), int64_t(buffer_len));
+}
+
 /**
  * So far, the parsed data is still split into many chunks. This function flattens the chunks into
  * continuous buffers that can be used as attributes.
@@ -215,7 +288,8 @@ static Array<std::optional<GArray<>>> flatten_valid_attribute_chunks(
               /* This chunk was read entirely as integers, so it still has to be converted to
                * floats. */
               BLI_assert(int_vec->size() == dst_range.size());
-              uninitialized_convert_n(int_vec->data(), dst_range.size(), attribute_buffer);
+              uninitialized_convert_n(
+                  int_vec->data(), dst_range.size(), attribute_buffer + dst_range.first());
             }
             else {
               /* Expected data to be available, because the `found_invalid` flag was not
@@ -262,17 +336,28 @@ static Array<std::optional<GArray<>>> flatten_valid_attribute_chunks(
 
 PointCloud *import_csv_as_pointcloud(const CSVImportParams &import_params)
 {
-  size_t buffer_len;
-  void *buffer = BLI_file_read_text_as_mem(import_params.filepath, 0, &buffer_len);
-  if (buffer == nullptr) {
+  int file = -1;
+  BLI_mmap_file *mmap_file = nullptr;
+  void *buffer = nullptr;
+  const std::optional<Span<char>> buffer_span = map_or_read_file(
+      import_params.filepath, file, mmap_file, buffer);
+  BLI_SCOPED_DEFER([&]() {
+    if (mmap_file) {
+      BLI_mmap_free(mmap_file);
+    }
+    if (file != -1) {
+      close(file);
+    }
+    MEM_SAFE_FREE(buffer);
+  });
+  if (!buffer_span.has_value()) {
     BKE_reportf(import_params.reports,
                 RPT_ERROR,
                 "CSV Import: Cannot open file '%s'",
                 import_params.filepath);
     return nullptr;
   }
-  BLI_SCOPED_DEFER([&]() { MEM_freeN(buffer); });
-  if (buffer_len == 0) {
+  if (buffer_span->is_empty()) {
     BKE_reportf(
         import_params.reports, RPT_ERROR, "CSV Import: empty file '%s'", import_params.filepath);
     return nullptr;
@@ -283,6 +368,11 @@ PointCloud *import_csv_as_pointcloud(const CSVImportParams &import_params)
   csv_parse::CsvParseOptions parse_options;
   parse_options.delimiter = import_params.delimiter;
 
+  /* Inferring the column types from a sample requires parsing the first records twice, which is
+   * not worth it for small files. */
+  const int64_t min_size_for_sample = 16 * 1024 * 1024;
+  const bool use_sample = buffer_span->size() >= min_size_for_sample;
+
   const auto parse_header = [&](const csv_parse::CsvRecord &record) {
     columns_info.reinitialize(record.size());
     for (const int i : record.index_range()) {
@@ -297,16 +387,18 @@ PointCloud *import_csv_as_pointcloud(const CSVImportParams &import_params)
         continue;
       }
     }
+    if (use_sample) {
+      infer_float_columns_from_sample(*buffer_span, parse_options, columns_info);
+    }
   };
   const auto parse_data_chunk = [&](const csv_parse::CsvRecords &records) {
     return parse_records_chunk(records, columns_info);
   };
 
-  const Span<char> buffer_span{static_cast<char *>(buffer), int64_t(buffer_len)};
   std::optional<Vector<ChunkResult>> parsed_chunks = csv_parse::parse_csv_in_chunks<ChunkResult>(
-      buffer_span, parse_options, parse_header, parse_data_chunk);
+      *buffer_span, parse_options, parse_header, parse_data_chunk);
 
-  if (!parsed_chunks.has_value()) {
+  if (!parsed_chunks.has_value() || (mmap_file && BLI_mmap_any_io_error(mmap_file))) {
     BKE_reportf(import_params.reports,
                 RPT_ERROR,
                 "CSV import: failed to parse file '%s'",
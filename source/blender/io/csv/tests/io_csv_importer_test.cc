@@ -0,0 +1,78 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_fileops.h"
+#include "BLI_string.h"
+
+#include "BKE_appdir.hh"
+#include "BKE_attribute.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_pointcloud.hh"
+
+#include "CLG_log.h"
+
+#include "DNA_pointcloud_types.h"
+
+#include "IO_csv.hh"
+
+namespace blender::io::csv {
+
+class CSVImportTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+    BKE_tempdir_init(nullptr);
+  }
+
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+};
+
+TEST_F(CSVImportTest, FloatColumnWithIntegerChunks)
+{
+  /* Enough rows to be split into many chunks. The `value` column only contains a float in the
+   * last row, so the chunks before it are parsed as integers and have to be converted to floats,
+   * each into its own range of the attribute. */
+  constexpr int rows_num = 100000;
+  const std::string csv_path = std::string(BKE_tempdir_base()) + "float_column.csv";
+  FILE *file = BLI_fopen(csv_path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  fprintf(file, "index,value\n");
+  for (const int i : IndexRange(rows_num - 1)) {
+    fprintf(file, "%d,%d\n", i, i);
+  }
+  fprintf(file, "%d,0.5\n", rows_num - 1);
+  fclose(file);
+
+  CSVImportParams params;
+  STRNCPY(params.filepath, csv_path.c_str());
+  PointCloud *pointcloud = import_csv_as_pointcloud(params);
+  BLI_delete(csv_path.c_str(), false, false);
+  ASSERT_NE(pointcloud, nullptr);
+  ASSERT_EQ(pointcloud->totpoint, rows_num);
+
+  const bke::AttributeAccessor attributes = pointcloud->attributes();
+  const VArraySpan<int> indices = *attributes.lookup<int>("index", bke::AttrDomain::Point);
+  const VArraySpan<float> values = *attributes.lookup<float>("value", bke::AttrDomain::Point);
+  Array<int> expected_indices(rows_num);
+  Array<float> expected_values(rows_num);
+  for (const int i : IndexRange(rows_num)) {
+    expected_indices[i] = i;
+    expected_values[i] = float(i);
+  }
+  expected_values.last() = 0.5f;
+  EXPECT_EQ_SPAN<int>(expected_indices, indices);
+  EXPECT_EQ_SPAN<float>(expected_values, values);
+
+  BKE_id_free(nullptr, pointcloud);
+}
+
+}  // namespace blender::io::csv
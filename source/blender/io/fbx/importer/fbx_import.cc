@@ -7,6 +7,7 @@
  */
 
 #include "BKE_camera.h"
+#include "BKE_global.hh"
 #include "BKE_layer.hh"
 #include "BKE_lib_id.hh"
 #include "BKE_light.h"
@@ -14,8 +15,10 @@
 #include "BKE_report.hh"
 
 #include "BLI_fileops.h"
+#include "BLI_function_ref.hh"
 #include "BLI_math_rotation.h"
 #include "BLI_task.hh"
+#include "BLI_timeit.hh"
 
 #include "DEG_depsgraph.hh"
 #include "DEG_depsgraph_build.hh"
@@ -35,6 +38,8 @@
 #include "fbx_import_mesh.hh"
 #include "fbx_import_util.hh"
 
+#include <fmt/core.h>
+
 #include "CLG_log.h"
 static CLG_LogRef LOG = {"io.fbx"};
 
@@ -329,6 +334,21 @@ static void fbx_task_wait_fn(void * /* user */,
    * This means that only one fbx "task group" is effectively scheduled at once. */
 }
 
+/**
+ * Run one step of the import. With `--debug-io`, the time it took is printed, which gives a
+ * breakdown of the total import time.
+ */
+static void run_import_step(const char *name, const FunctionRef<void()> fn)
+{
+  const timeit::TimePoint start_time = timeit::Clock::now();
+  fn();
+  if (G.debug & G_DEBUG_IO) {
+    fmt::print("  FBX import step '{}' took ", name);
+    timeit::print_duration(timeit::Clock::now() - start_time);
+    fmt::print("\n");
+  }
+}
+
 void importer_main(Main *bmain, Scene *scene, ViewLayer *view_layer, const FBXImportParams &params)
 {
   FILE *file = BLI_fopen(params.filepath, "rb");
@@ -368,7 +388,8 @@ void importer_main(Main *bmain, Scene *scene, ViewLayer *view_layer, const FBXIm
   opts.thread_opts.pool.wait_fn = fbx_task_wait_fn;
 
   ufbx_error fbx_error;
-  ufbx_scene *fbx = ufbx_load_stdio(file, &opts, &fbx_error);
+  ufbx_scene *fbx = nullptr;
+  run_import_step("Load file", [&]() { fbx = ufbx_load_stdio(file, &opts, &fbx_error); });
   fclose(file);
 
   if (!fbx) {
@@ -418,13 +439,13 @@ void importer_main(Main *bmain, Scene *scene, ViewLayer *view_layer, const FBXIm
   }
 #endif
 
-  ctx.import_materials();
-  ctx.import_armatures();
-  ctx.import_meshes();
-  ctx.import_cameras();
-  ctx.import_lights();
-  ctx.import_empties();
-  ctx.import_animation(scene->frames_per_second());
+  run_import_step("Materials", [&]() { ctx.import_materials(); });
+  run_import_step("Armatures", [&]() { ctx.import_armatures(); });
+  run_import_step("Meshes", [&]() { ctx.import_meshes(); });
+  run_import_step("Cameras", [&]() { ctx.import_cameras(); });
+  run_import_step("Lights", [&]() { ctx.import_lights(); });
+  run_import_step("Empties", [&]() { ctx.import_empties(); });
+  run_import_step("Animation", [&]() { ctx.import_animation(scene->frames_per_second()); });
   ctx.setup_hierarchy();
 
   ufbx_free_scene(fbx);
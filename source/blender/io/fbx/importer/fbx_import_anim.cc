@@ -22,6 +22,7 @@
 #include "BLI_math_quaternion.hh"
 #include "BLI_set.hh"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 #include "BLI_vector_set.hh"
 
@@ -252,6 +253,33 @@ static void create_transform_curve_desc(const FbxElementMapping &mapping,
   }
 }
 
+/**
+ * Hack: force cubic keyframes of transform curves to be linear, to match Python importer
+ * behavior. This modifies the ufbx curves, so it has to be done for all of them before any
+ * transform is evaluated, as evaluating the transform of a node can also read the curves of its
+ * parents.
+ */
+static void force_linear_transform_keyframes(const Span<ElementAnimations> animations)
+{
+  for (const ElementAnimations &anim : animations) {
+    for (const ufbx_anim_prop *prop : {anim.prop_position, anim.prop_rotation, anim.prop_scale}) {
+      if (prop == nullptr) {
+        continue;
+      }
+      for (const ufbx_anim_curve *curve : prop->anim_value->curves) {
+        if (curve == nullptr) {
+          continue;
+        }
+        for (const ufbx_keyframe &key : curve->keyframes) {
+          if (key.interpolation == UFBX_INTERPOLATION_CUBIC) {
+            const_cast<ufbx_keyframe &>(key).interpolation = UFBX_INTERPOLATION_LINEAR;
+          }
+        }
+      }
+    }
+  }
+}
+
 static void create_transform_curve_data(const FbxElementMapping &mapping,
                                         const ufbx_anim *fbx_anim,
                                         const ElementAnimations &anim,
@@ -325,10 +353,6 @@ static void create_transform_curve_data(const FbxElementMapping &mapping,
   for (int i = 0; i < 9; i++) {
     if (input_curves[i] != nullptr) {
       for (const ufbx_keyframe &key : input_curves[i]->keyframes) {
-        if (key.interpolation == UFBX_INTERPOLATION_CUBIC) {
-          /* Hack: force cubic keyframes to be linear, to match Python importer behavior. */
-          const_cast<ufbx_keyframe &>(key).interpolation = UFBX_INTERPOLATION_LINEAR;
-        }
         unique_key_times.add(key.time);
       }
     }
@@ -507,6 +531,7 @@ void import_animations(Main &bmain,
       if (animations.is_empty()) {
         continue;
       }
+      force_linear_transform_keyframes(animations);
 
       /* Create action for this layer. */
       std::string action_name = fstack->name.data;
@@ -578,17 +603,32 @@ void import_animations(Main &bmain,
           transform_curves = channelbag.fcurve_create_many(nullptr, curve_desc.as_span());
         }
 
-        for (const int64_t index : id_anims.index_range()) {
-          const ElementAnimations *anim = id_anims[index];
-          if (anim->prop_position || anim->prop_rotation || anim->prop_scale) {
+        /* Evaluating the transforms at every key time dominates the import time of animations
+         * with many animated bones. The curves of every element are independent of the other
+         * elements, and the ufbx data is only read here, so their data can be filled in
+         * parallel. */
+        threading::parallel_for(id_anims.index_range(), 1, [&](const IndexRange range) {
+          for (const int64_t index : range) {
+            if (anim_transform_curve_index[index] == -1) {
+              continue;
+            }
             create_transform_curve_data(mapping,
                                         flayer->anim,
-                                        *anim,
+                                        *id_anims[index],
                                         fps,
                                         anim_offset,
                                         transform_curves.data() +
                                             anim_transform_curve_index[index]);
           }
+        });
+        threading::parallel_for(transform_curves.index_range(), 16, [&](const IndexRange range) {
+          for (const int64_t index : range) {
+            finalize_curve(transform_curves[index]);
+          }
+        });
+
+        /* Other curves are added to the channel-bag one by one, which is not thread-safe. */
+        for (const ElementAnimations *anim : id_anims) {
           if (anim->prop_focal_length || anim->prop_focus_dist) {
             create_camera_curves(fbx.metadata, *anim, channelbag, fps, anim_offset);
           }
@@ -599,10 +639,6 @@ void import_animations(Main &bmain,
             create_blend_shape_curves(*anim, channelbag, fps, anim_offset);
           }
         }
-
-        for (FCurve *curve : transform_curves) {
-          finalize_curve(curve);
-        }
       }
     }
   }
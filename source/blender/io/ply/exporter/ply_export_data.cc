@@ -10,54 +10,115 @@
 #include "ply_data.hh"
 #include "ply_file_buffer.hh"
 
+#include "BLI_array.hh"
+#include "BLI_function_ref.hh"
 #include "BLI_math_vector.hh"
 
+#include "IO_chunked_write.hh"
+
 namespace blender::io::ply {
 
+/* Split up large meshes into multi-threaded jobs; each job writes this amount of items. */
+static constexpr int64_t chunk_size = 32768;
+/* Rough size of a formatted chunk, used to fit the chunk buffers into the memory budget. */
+static constexpr int64_t chunk_bytes = chunk_size * 64;
+
+/**
+ * Write `items_num` items to the file, formatting chunks of them in parallel with `write_fn`.
+ * Only a limited number of formatted chunks is kept in memory at any time.
+ */
+static void write_chunked(FileBuffer &buffer,
+                          const int64_t items_num,
+                          const FunctionRef<void(FileBuffer &chunk_buffer, IndexRange range)>
+                              write_fn)
+{
+  /* Data written before, such as the header, goes first. */
+  buffer.write_to_file();
+
+  const int64_t chunks_num = (items_num + chunk_size - 1) / chunk_size;
+  if (chunks_num == 0) {
+    return;
+  }
+  const int slots_num = int(std::min<int64_t>(
+      chunked_write_slots_num(chunked_write_default_memory_budget, chunk_bytes), chunks_num));
+  Array<std::unique_ptr<FileBuffer>> chunk_buffers(slots_num);
+  for (std::unique_ptr<FileBuffer> &chunk_buffer : chunk_buffers) {
+    chunk_buffer = buffer.create_chunk_buffer();
+  }
+  parallel_chunked_write(
+      chunks_num,
+      slots_num,
+      [&](const int64_t chunk, const int slot) {
+        const IndexRange range = IndexRange(items_num).slice(
+            chunk * chunk_size, std::min(chunk_size, items_num - chunk * chunk_size));
+        write_fn(*chunk_buffers[slot], range);
+      },
+      [&](const int slot) { buffer.write_to_file(*chunk_buffers[slot]); });
+}
+
 void write_vertices(FileBuffer &buffer, const PlyData &ply_data)
 {
-  for (int i = 0; i < ply_data.vertices.size(); i++) {
-    buffer.write_vertex(ply_data.vertices[i].x, ply_data.vertices[i].y, ply_data.vertices[i].z);
+  const int64_t vertices_num = ply_data.vertices.size();
+  write_chunked(buffer, vertices_num, [&](FileBuffer &chunk_buffer, IndexRange range) {
+    for (const int64_t i : range) {
+      const float3 &vertex = ply_data.vertices[i];
+      chunk_buffer.write_vertex(vertex.x, vertex.y, vertex.z);
 
-    if (!ply_data.vertex_normals.is_empty()) {
-      buffer.write_vertex_normal(ply_data.vertex_normals[i].x,
-                                 ply_data.vertex_normals[i].y,
-                                 ply_data.vertex_normals[i].z);
-    }
+      if (!ply_data.vertex_normals.is_empty()) {
+        const float3 &normal = ply_data.vertex_normals[i];
+        chunk_buffer.write_vertex_normal(normal.x, normal.y, normal.z);
+      }
 
-    if (!ply_data.vertex_colors.is_empty()) {
-      /* PLY colors currently are exported as bytes, make sure inputs are clamped. */
-      float4 color = math::clamp(ply_data.vertex_colors[i], 0.0f, 1.0f) * 255.0f;
-      buffer.write_vertex_color(uchar(color.x), uchar(color.y), uchar(color.z), uchar(color.w));
-    }
+      if (!ply_data.vertex_colors.is_empty()) {
+        /* PLY colors currently are exported as bytes, make sure inputs are clamped. */
+        float4 color = math::clamp(ply_data.vertex_colors[i], 0.0f, 1.0f) * 255.0f;
+        chunk_buffer.write_vertex_color(
+            uchar(color.x), uchar(color.y), uchar(color.z), uchar(color.w));
+      }
 
-    if (!ply_data.uv_coordinates.is_empty()) {
-      buffer.write_UV(ply_data.uv_coordinates[i].x, ply_data.uv_coordinates[i].y);
-    }
+      if (!ply_data.uv_coordinates.is_empty()) {
+        chunk_buffer.write_UV(ply_data.uv_coordinates[i].x, ply_data.uv_coordinates[i].y);
+      }
 
-    for (const PlyCustomAttribute &attr : ply_data.vertex_custom_attr) {
-      buffer.write_data(attr.data[i]);
-    }
+      for (const PlyCustomAttribute &attr : ply_data.vertex_custom_attr) {
+        chunk_buffer.write_data(attr.data[i]);
+      }
 
-    buffer.write_vertex_end();
-  }
-  buffer.write_to_file();
+      chunk_buffer.write_vertex_end();
+    }
+  });
 }
 
 void write_faces(FileBuffer &buffer, const PlyData &ply_data)
 {
-  const uint32_t *indices = ply_data.face_vertices.data();
-  for (uint32_t face_size : ply_data.face_sizes) {
-    buffer.write_face(char(face_size), Span<uint32_t>(indices, face_size));
-    indices += face_size;
+  /* Offset of the first index of every chunk of faces. */
+  const int64_t faces_num = ply_data.face_sizes.size();
+  Array<int64_t> chunk_offsets((faces_num + chunk_size - 1) / chunk_size);
+  int64_t offset = 0;
+  for (const int64_t i : ply_data.face_sizes.index_range()) {
+    if (i % chunk_size == 0) {
+      chunk_offsets[i / chunk_size] = offset;
+    }
+    offset += ply_data.face_sizes[i];
   }
-  buffer.write_to_file();
+
+  write_chunked(buffer, faces_num, [&](FileBuffer &chunk_buffer, IndexRange range) {
+    const int64_t chunk = range.first() / chunk_size;
+    const uint32_t *indices = ply_data.face_vertices.data() + chunk_offsets[chunk];
+    for (const uint32_t face_size : ply_data.face_sizes.as_span().slice(range)) {
+      chunk_buffer.write_face(char(face_size), Span<uint32_t>(indices, face_size));
+      indices += face_size;
+    }
+  });
 }
+
 void write_edges(FileBuffer &buffer, const PlyData &ply_data)
 {
-  for (const std::pair<int, int> &edge : ply_data.edges) {
-    buffer.write_edge(edge.first, edge.second);
-  }
-  buffer.write_to_file();
+  write_chunked(buffer, ply_data.edges.size(), [&](FileBuffer &chunk_buffer, IndexRange range) {
+    for (const std::pair<int, int> &edge : ply_data.edges.as_span().slice(range)) {
+      chunk_buffer.write_edge(edge.first, edge.second);
+    }
+  });
 }
+
 }  // namespace blender::io::ply
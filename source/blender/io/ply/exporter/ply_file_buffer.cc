@@ -27,12 +27,23 @@ FileBuffer::FileBuffer(const char *filepath, size_t buffer_chunk_size)
   }
 }
 
+FileBuffer::FileBuffer(size_t buffer_chunk_size)
+    : buffer_chunk_size_(buffer_chunk_size), filepath_(nullptr), outfile_(nullptr)
+{
+}
+
 void FileBuffer::write_to_file()
 {
-  for (const VectorChar &b : blocks_) {
+  write_to_file(*this);
+}
+
+void FileBuffer::write_to_file(FileBuffer &chunk)
+{
+  BLI_assert(this->outfile_ != nullptr);
+  for (const VectorChar &b : chunk.blocks_) {
     fwrite(b.data(), 1, b.size(), this->outfile_);
   }
-  blocks_.clear();
+  chunk.blocks_.clear();
 }
 
 void FileBuffer::close_file()
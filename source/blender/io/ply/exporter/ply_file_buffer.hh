@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "BLI_string_ref.hh"
 #include "BLI_utility_mixins.hh"
 #include "BLI_vector.hh"
@@ -35,11 +37,21 @@ class FileBuffer : private NonMovable {
  public:
   FileBuffer(const char *filepath, size_t buffer_chunk_size = 64 * 1024);
 
+  /* Buffer that is not associated with any file, see #create_chunk_buffer. */
+  FileBuffer(size_t buffer_chunk_size = 64 * 1024);
+
   virtual ~FileBuffer() = default;
 
   /* Write contents to the buffer(s) into a file, and clear the buffers. */
   void write_to_file();
 
+  /* Write contents of the chunk buffer into the file of this buffer, and clear the chunk. */
+  void write_to_file(FileBuffer &chunk);
+
+  /* Create a buffer with the same format, that is not associated with any file. Chunks of the
+   * file can be formatted into such buffers in parallel. */
+  virtual std::unique_ptr<FileBuffer> create_chunk_buffer() const = 0;
+
   void close_file();
 
   virtual void write_vertex(float x, float y, float z) = 0;
@@ -90,6 +102,16 @@ class FileBuffer : private NonMovable {
     bb.insert(bb.end(), buf.begin(), buf.end());
   }
 
+  /* Write at most `max_len` characters with `fn`, which formats them into the given memory and
+   * returns their end, see #IO_number_format.hh. */
+  template<typename Fn> void write_direct(int64_t max_len, const Fn &fn)
+  {
+    ensure_space(max_len);
+    VectorChar &bb = blocks_.last();
+    char *end = fn(bb.end());
+    bb.increase_size_by_unchecked(end - bb.end());
+  }
+
   void write_bytes(Span<char> bytes);
 };
 
@@ -8,6 +8,8 @@
 
 #include "ply_file_buffer_ascii.hh"
 
+#include "IO_number_format.hh"
+
 namespace blender::io::ply {
 
 void FileBufferAscii::write_vertex(float x, float y, float z)
@@ -32,7 +34,13 @@ void FileBufferAscii::write_vertex_normal(float nx, float ny, float nz)
 
 void FileBufferAscii::write_vertex_color(uchar r, uchar g, uchar b, uchar a)
 {
-  write_fstring(" {} {} {} {}", r, g, b, a);
+  write_direct(16, [&](char *p) {
+    for (const uchar value : {r, g, b, a}) {
+      *p++ = ' ';
+      p = format_int(p, value);
+    }
+    return p;
+  });
 }
 
 void FileBufferAscii::write_vertex_end()
@@ -42,17 +50,32 @@ void FileBufferAscii::write_vertex_end()
 
 void FileBufferAscii::write_face(char count, Span<uint32_t> const &vertex_indices)
 {
-  write_fstring("{}", int(count));
-
-  for (const uint32_t v : vertex_indices) {
-    write_fstring(" {}", v);
-  }
-  write_newline();
+  /* At most 10 digits for every index. */
+  write_direct(5 + vertex_indices.size() * 11, [&](char *p) {
+    p = format_int(p, int(count));
+    for (const uint32_t v : vertex_indices) {
+      *p++ = ' ';
+      p = format_int(p, v);
+    }
+    *p++ = '\n';
+    return p;
+  });
 }
 
 void FileBufferAscii::write_edge(int first, int second)
 {
-  write_fstring("{} {}", first, second);
-  write_newline();
+  write_direct(2 * format_number_max_len + 2, [&](char *p) {
+    p = format_int(p, first);
+    *p++ = ' ';
+    p = format_int(p, second);
+    *p++ = '\n';
+    return p;
+  });
+}
+
+std::unique_ptr<FileBuffer> FileBufferAscii::create_chunk_buffer() const
+{
+  return std::make_unique<FileBufferAscii>();
 }
+
 }  // namespace blender::io::ply
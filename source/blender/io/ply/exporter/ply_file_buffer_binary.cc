@@ -75,4 +75,10 @@ void FileBufferBinary::write_edge(int first, int second)
 
   write_bytes(span);
 }
+
+std::unique_ptr<FileBuffer> FileBufferBinary::create_chunk_buffer() const
+{
+  return std::make_unique<FileBufferBinary>();
+}
+
 }  // namespace blender::io::ply
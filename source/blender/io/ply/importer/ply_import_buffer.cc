@@ -4,10 +4,18 @@
 
 #include "ply_import_buffer.hh"
 
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
 #include "BLI_fileops.h"
+#include "BLI_mmap.h"
 
 #include <algorithm>
 #include <cstdio>
+#include <fcntl.h>
 #include <cstring>
 #include <stdexcept>
 
@@ -19,7 +27,7 @@ static inline bool is_newline(char ch)
 namespace blender::io::ply {
 
 PlyReadBuffer::PlyReadBuffer(const char *file_path, size_t read_buffer_size)
-    : buffer_(read_buffer_size), read_buffer_size_(read_buffer_size)
+    : file_path_(file_path), buffer_(read_buffer_size), read_buffer_size_(read_buffer_size)
 {
   file_ = BLI_fopen(file_path, "rb");
 }
@@ -29,6 +37,12 @@ PlyReadBuffer::~PlyReadBuffer()
   if (file_ != nullptr) {
     fclose(file_);
   }
+  if (mmap_file_ != nullptr) {
+    BLI_mmap_free(mmap_file_);
+  }
+  if (mmap_fd_ != -1) {
+    close(mmap_fd_);
+  }
 }
 
 void PlyReadBuffer::after_header(bool is_binary)
@@ -79,6 +93,42 @@ bool PlyReadBuffer::read_bytes(void *dst, size_t size)
   return true;
 }
 
+const uint8_t *PlyReadBuffer::map_bytes(size_t size)
+{
+  if (!is_binary_ || file_ == nullptr || mmap_failed_) {
+    return nullptr;
+  }
+  if (mmap_file_ == nullptr) {
+    mmap_fd_ = BLI_open(file_path_.c_str(), O_BINARY | O_RDONLY, 0);
+    if (mmap_fd_ != -1) {
+      mmap_file_ = BLI_mmap_open(mmap_fd_);
+    }
+    if (mmap_file_ == nullptr) {
+      mmap_failed_ = true;
+      return nullptr;
+    }
+  }
+
+  const int64_t offset = buffer_file_offset_ + pos_;
+  if (offset + size > BLI_mmap_get_length(mmap_file_)) {
+    return nullptr;
+  }
+  /* Continue buffered reading after the mapped bytes. */
+  if (BLI_fseek(file_, offset + size, SEEK_SET) != 0) {
+    return nullptr;
+  }
+  buffer_file_offset_ = offset + size;
+  pos_ = 0;
+  buf_used_ = 0;
+  at_eof_ = false;
+  return static_cast<const uint8_t *>(BLI_mmap_get_pointer(mmap_file_)) + offset;
+}
+
+bool PlyReadBuffer::mapped_io_error() const
+{
+  return mmap_file_ != nullptr && BLI_mmap_any_io_error(mmap_file_);
+}
+
 bool PlyReadBuffer::refill_buffer()
 {
   BLI_assert(pos_ <= buf_used_);
@@ -90,6 +140,7 @@ bool PlyReadBuffer::refill_buffer()
   }
 
   /* Move any leftover to start of buffer. */
+  buffer_file_offset_ += pos_;
   int keep = buf_used_ - pos_;
   if (keep > 0) {
     memmove(buffer_.data(), buffer_.data() + pos_, keep);
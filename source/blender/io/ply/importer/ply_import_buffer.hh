@@ -9,10 +9,13 @@
 #pragma once
 
 #include <cstdio>
+#include <string>
 
 #include "BLI_array.hh"
 #include "BLI_span.hh"
 
+struct BLI_mmap_file;
+
 namespace blender::io::ply {
 
 /**
@@ -38,10 +41,26 @@ class PlyReadBuffer {
    */
   bool read_bytes(void *dst, size_t size);
 
+  /**
+   * Returns the next \a size bytes of a binary file directly from a memory mapping of the file,
+   * and moves the read position past them. The memory stays valid as long as the buffer exists.
+   * Returns null if the file can not be mapped or is too short, without reading anything.
+   */
+  const uint8_t *map_bytes(size_t size);
+
+  /** Whether reading from the memory mapping failed, meaning mapped data can not be trusted. */
+  bool mapped_io_error() const;
+
  private:
   bool refill_buffer();
 
+  std::string file_path_;
   FILE *file_ = nullptr;
+  /* Offset in the file of the start of the buffer. */
+  int64_t buffer_file_offset_ = 0;
+  int mmap_fd_ = -1;
+  BLI_mmap_file *mmap_file_ = nullptr;
+  bool mmap_failed_ = false;
   Array<char> buffer_;
   int pos_ = 0;
   int buf_used_ = 0;
@@ -10,11 +10,14 @@
 #include "ply_data.hh"
 #include "ply_import_buffer.hh"
 
+#include "BLI_array.hh"
 #include "BLI_endian_switch.h"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 
 #include "fast_float.h"
 
+#include <array>
 #include <charconv>
 
 #include "CLG_log.h"
@@ -232,6 +235,125 @@ static const char *parse_row_binary(PlyReadBuffer &file,
   return nullptr;
 }
 
+/* Decoding of binary elements with fixed size rows straight from a memory mapping of the file.
+ * Each needed property is decoded as a column into its destination array, with the rows split
+ * between threads. */
+
+struct BinaryColumn {
+  /* Offset of the property in the row. */
+  int offset;
+  PlyDataTypes type;
+  float divisor;
+  float *dst;
+  int dst_stride;
+};
+
+template<typename T, bool SwapEndian> static T load_binary_value(const uint8_t *ptr)
+{
+  T value;
+  memcpy(&value, ptr, sizeof(T));
+  if constexpr (SwapEndian && sizeof(T) == 2) {
+    BLI_endian_switch_uint16(reinterpret_cast<uint16_t *>(&value));
+  }
+  else if constexpr (SwapEndian && sizeof(T) == 4) {
+    BLI_endian_switch_uint32(reinterpret_cast<uint32_t *>(&value));
+  }
+  else if constexpr (SwapEndian && sizeof(T) == 8) {
+    BLI_endian_switch_uint64(reinterpret_cast<uint64_t *>(&value));
+  }
+  return value;
+}
+
+template<typename T, bool SwapEndian>
+static void decode_column_values(const uint8_t *src,
+                                 const int stride,
+                                 const BinaryColumn &column,
+                                 const IndexRange rows)
+{
+  for (const int64_t i : rows) {
+    const float value = float(load_binary_value<T, SwapEndian>(src + i * stride));
+    column.dst[i * column.dst_stride] = value / column.divisor;
+  }
+}
+
+template<bool SwapEndian>
+static void decode_column(const uint8_t *data,
+                          const int stride,
+                          const BinaryColumn &column,
+                          const IndexRange rows)
+{
+  const uint8_t *src = data + column.offset;
+  switch (column.type) {
+    case CHAR:
+      decode_column_values<int8_t, SwapEndian>(src, stride, column, rows);
+      break;
+    case UCHAR:
+      decode_column_values<uint8_t, SwapEndian>(src, stride, column, rows);
+      break;
+    case SHORT:
+      decode_column_values<int16_t, SwapEndian>(src, stride, column, rows);
+      break;
+    case USHORT:
+      decode_column_values<uint16_t, SwapEndian>(src, stride, column, rows);
+      break;
+    case INT:
+    /* Same conversion as #get_binary_value. */
+    case UINT:
+      decode_column_values<int32_t, SwapEndian>(src, stride, column, rows);
+      break;
+    case FLOAT:
+      decode_column_values<float, SwapEndian>(src, stride, column, rows);
+      break;
+    case DOUBLE:
+      decode_column_values<double, SwapEndian>(src, stride, column, rows);
+      break;
+    default:
+      BLI_assert_msg(false, "Unknown property type");
+  }
+}
+
+/**
+ * Try to map the rows of a binary element with fixed size rows, returns null if that is not
+ * possible and the element has to be read row by row.
+ */
+static const uint8_t *map_binary_element(PlyReadBuffer &file,
+                                         const PlyHeader &header,
+                                         const PlyElement &element)
+{
+  if (header.type == PlyFormatType::ASCII || element.stride == 0) {
+    return nullptr;
+  }
+  return file.map_bytes(size_t(element.stride) * size_t(element.count));
+}
+
+static void decode_binary_columns(const uint8_t *data,
+                                  const PlyHeader &header,
+                                  const PlyElement &element,
+                                  const Span<BinaryColumn> columns)
+{
+  threading::parallel_for(IndexRange(element.count), 16 * 1024, [&](const IndexRange rows) {
+    for (const BinaryColumn &column : columns) {
+      if (header.type == PlyFormatType::BINARY_BE) {
+        decode_column<true>(data, element.stride, column, rows);
+      }
+      else {
+        decode_column<false>(data, element.stride, column, rows);
+      }
+    }
+  });
+}
+
+static Array<int> property_offsets(const PlyElement &element)
+{
+  Array<int> offsets(element.properties.size());
+  int offset = 0;
+  for (const int64_t i : element.properties.index_range()) {
+    offsets[i] = offset;
+    offset += data_type_size[element.properties[i].type];
+  }
+  return offsets;
+}
+
 static const char *load_vertex_element(PlyReadBuffer &file,
                                        const PlyHeader &header,
                                        const PlyElement &element,
@@ -291,6 +413,52 @@ static const char *load_vertex_element(PlyReadBuffer &file,
     color_norm.w = data_type_normalizer[element.properties[alpha_index].type];
   }
 
+  if (const uint8_t *rows = map_binary_element(file, header, element)) {
+    const Array<int> offsets = property_offsets(element);
+    Vector<BinaryColumn> columns;
+    auto add_column = [&](const int prop_index, float *dst, const int dst_stride, float divisor) {
+      columns.append(
+          {offsets[prop_index], element.properties[prop_index].type, divisor, dst, dst_stride});
+    };
+    data->vertices.resize(element.count);
+    float *vertices = reinterpret_cast<float *>(data->vertices.data());
+    for (const int axis : IndexRange(3)) {
+      add_column(vertex_index[axis], vertices + axis, 3, 1.0f);
+    }
+    if (has_color) {
+      data->vertex_colors.resize(element.count, float4(0.0f, 0.0f, 0.0f, 1.0f));
+      float *colors = reinterpret_cast<float *>(data->vertex_colors.data());
+      for (const int channel : IndexRange(3)) {
+        add_column(color_index[channel], colors + channel, 4, color_norm[channel]);
+      }
+      if (has_alpha) {
+        add_column(alpha_index, colors + 3, 4, color_norm.w);
+      }
+    }
+    if (has_normal) {
+      data->vertex_normals.resize(element.count);
+      float *normals = reinterpret_cast<float *>(data->vertex_normals.data());
+      for (const int axis : IndexRange(3)) {
+        add_column(normal_index[axis], normals + axis, 3, 1.0f);
+      }
+    }
+    if (has_uv) {
+      data->uv_coordinates.resize(element.count);
+      float *uvs = reinterpret_cast<float *>(data->uv_coordinates.data());
+      for (const int axis : IndexRange(2)) {
+        add_column(uv_index[axis], uvs + axis, 2, 1.0f);
+      }
+    }
+    for (const int64_t ci : custom_attr_indices.index_range()) {
+      add_column(custom_attr_indices[ci], data->vertex_custom_attr[ci].data.data(), 1, 1.0f);
+    }
+    decode_binary_columns(rows, header, element, columns);
+    if (file.mapped_io_error()) {
+      return "Could not read row of binary property";
+    }
+    return nullptr;
+  }
+
   Vector<float> value_vec(element.properties.size());
   Vector<uint8_t> scratch;
   if (header.type != PlyFormatType::ASCII) {
@@ -594,6 +762,28 @@ static const char *load_edge_element(PlyReadBuffer &file,
     return "Edge element does not contain vertex1 and vertex2 properties";
   }
 
+  if (const uint8_t *rows = map_binary_element(file, header, element)) {
+    const Array<int> offsets = property_offsets(element);
+    Array<float2> values(element.count);
+    float *dst = reinterpret_cast<float *>(values.data());
+    const PlyDataTypes type1 = element.properties[prop_vertex1].type;
+    const PlyDataTypes type2 = element.properties[prop_vertex2].type;
+    const std::array<BinaryColumn, 2> columns = {
+        BinaryColumn{offsets[prop_vertex1], type1, 1.0f, dst, 2},
+        BinaryColumn{offsets[prop_vertex2], type2, 1.0f, dst + 1, 2}};
+    decode_binary_columns(rows, header, element, columns);
+    if (file.mapped_io_error()) {
+      return "Could not read row of binary property";
+    }
+    data->edges.resize(element.count);
+    threading::parallel_for(values.index_range(), 64 * 1024, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        data->edges[i] = std::make_pair(int(values[i].x), int(values[i].y));
+      }
+    });
+    return nullptr;
+  }
+
   data->edges.reserve(element.count);
 
   Vector<float> value_vec(element.properties.size());
@@ -624,6 +814,10 @@ static const char *skip_element(PlyReadBuffer &file,
                                 const PlyHeader &header,
                                 const PlyElement &element)
 {
+  if (map_binary_element(file, header, element)) {
+    /* Fixed size rows are skipped all at once. */
+    return nullptr;
+  }
   if (header.type == PlyFormatType::ASCII) {
     for (int i = 0; i < element.count; i++) {
       Span<char> line = file.read_line();
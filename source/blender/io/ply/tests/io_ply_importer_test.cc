@@ -4,8 +4,12 @@
 
 #include "testing/testing.h"
 
+#include "BLI_endian_switch.h"
+#include "BLI_fileops.h"
 #include "BLI_path_utils.hh"
 
+#include "BKE_appdir.hh"
+
 #include "CLG_log.h"
 
 #include "ply_import.hh"
@@ -18,7 +22,8 @@ namespace blender::io::ply {
 
 /* Extensive tests for PLY importing are in `io_ply_import_test.py`.
  * The tests here are only for testing PLY reader buffer refill behavior,
- * by using a very small buffer size on purpose. */
+ * by using a very small buffer size on purpose, and for comparing memory
+ * mapped binary reading against ASCII reading. */
 
 TEST(ply_import, BufferRefillTest)
 {
@@ -64,6 +69,167 @@ TEST(ply_import, BufferRefillTest)
   EXPECT_EQ_SPAN<std::pair<int, int>>(Span(exp_edges, 12), data_b->edges);
 }
 
+template<typename T> static void write_binary_value(FILE *file, T value, bool big_endian)
+{
+  if (big_endian) {
+    if constexpr (sizeof(T) == 2) {
+      BLI_endian_switch_uint16(reinterpret_cast<uint16_t *>(&value));
+    }
+    else if constexpr (sizeof(T) == 4) {
+      BLI_endian_switch_uint32(reinterpret_cast<uint32_t *>(&value));
+    }
+    else if constexpr (sizeof(T) == 8) {
+      BLI_endian_switch_uint64(reinterpret_cast<uint64_t *>(&value));
+    }
+  }
+  fwrite(&value, sizeof(T), 1, file);
+}
+
+/**
+ * Write a point cloud like file with a quad strip, using most property types, in the given
+ * format. All values are exactly representable in ASCII, so that all formats give the same data.
+ */
+static void write_synthetic_ply(const char *filepath, const PlyFormatType type, const int count)
+{
+  FILE *file = BLI_fopen(filepath, "wb");
+  ASSERT_NE(file, nullptr);
+  const char *format = type == PlyFormatType::ASCII     ? "ascii" :
+                       type == PlyFormatType::BINARY_BE ? "binary_big_endian" :
+                                                          "binary_little_endian";
+  fprintf(file, "ply\nformat %s 1.0\n", format);
+  fprintf(file,
+          "element vertex %d\n"
+          "property float x\nproperty float y\nproperty float z\n"
+          "property double nx\nproperty double ny\nproperty double nz\n"
+          "property uchar red\nproperty uchar green\nproperty uchar blue\n"
+          "property ushort alpha\nproperty float s\nproperty float t\n"
+          "property short quality\nproperty int segment\n",
+          count);
+  fprintf(file, "element material 2\nproperty float shininess\nproperty uchar index\n");
+  fprintf(file, "element face %d\nproperty list uchar int vertex_indices\n", count / 2 - 1);
+  fprintf(file, "element edge 2\nproperty int vertex1\nproperty int vertex2\n");
+  fprintf(file, "end_header\n");
+
+  const bool is_ascii = type == PlyFormatType::ASCII;
+  const bool big_endian = type == PlyFormatType::BINARY_BE;
+  for (int i = 0; i < count; i++) {
+    const float3 position(i * 0.25f, (i % 13) * -1.5f, (i % 7) * 0.125f);
+    const double3 normal(0.0, (i % 2) ? 0.5 : -0.5, 0.75);
+    const uchar3 color(i % 256, (i * 7) % 256, 255 - i % 256);
+    const ushort alpha = (i * 31) % 65536;
+    const float2 uv((i % 100) * 0.01f, 0.5f);
+    const short quality = (i % 200) - 100;
+    const int segment = i / 16;
+    if (is_ascii) {
+      fprintf(file,
+              "%.9g %.9g %.9g %.17g %.17g %.17g %d %d %d %d %.9g %.9g %d %d\n",
+              position.x,
+              position.y,
+              position.z,
+              normal.x,
+              normal.y,
+              normal.z,
+              color.x,
+              color.y,
+              color.z,
+              alpha,
+              uv.x,
+              uv.y,
+              quality,
+              segment);
+      continue;
+    }
+    for (const int axis : IndexRange(3)) {
+      write_binary_value(file, position[axis], big_endian);
+    }
+    for (const int axis : IndexRange(3)) {
+      write_binary_value(file, normal[axis], big_endian);
+    }
+    for (const int channel : IndexRange(3)) {
+      write_binary_value(file, color[channel], big_endian);
+    }
+    write_binary_value(file, alpha, big_endian);
+    write_binary_value(file, uv.x, big_endian);
+    write_binary_value(file, uv.y, big_endian);
+    write_binary_value(file, quality, big_endian);
+    write_binary_value(file, segment, big_endian);
+  }
+  for (const int i : IndexRange(2)) {
+    if (is_ascii) {
+      fprintf(file, "%d %d\n", i * 10, i);
+    }
+    else {
+      write_binary_value(file, float(i * 10), big_endian);
+      write_binary_value(file, uchar(i), big_endian);
+    }
+  }
+  for (const int i : IndexRange(count / 2 - 1)) {
+    const int quad[4] = {i * 2, i * 2 + 1, i * 2 + 3, i * 2 + 2};
+    if (is_ascii) {
+      fprintf(file, "4 %d %d %d %d\n", quad[0], quad[1], quad[2], quad[3]);
+      continue;
+    }
+    write_binary_value(file, uchar(4), big_endian);
+    for (const int vertex : quad) {
+      write_binary_value(file, vertex, big_endian);
+    }
+  }
+  for (const int i : IndexRange(2)) {
+    if (is_ascii) {
+      fprintf(file, "%d %d\n", i, count - 1 - i);
+    }
+    else {
+      write_binary_value(file, i, big_endian);
+      write_binary_value(file, count - 1 - i, big_endian);
+    }
+  }
+  fclose(file);
+}
+
+static std::unique_ptr<PlyData> import_synthetic_ply(const PlyFormatType type, const int count)
+{
+  BKE_tempdir_init(nullptr);
+  const std::string ply_path = std::string(BKE_tempdir_base()) + "synthetic.ply";
+  write_synthetic_ply(ply_path.c_str(), type, count);
+
+  PlyReadBuffer file(ply_path.c_str());
+  PlyHeader header;
+  const char *header_err = read_header(file, header);
+  EXPECT_EQ(header_err, nullptr);
+  std::unique_ptr<PlyData> data = import_ply_data(file, header);
+  BLI_delete(ply_path.c_str(), false, false);
+  return data;
+}
+
+TEST(ply_import, BinaryMatchesASCII)
+{
+  /* Enough vertices to decode binary columns in several threads. */
+  constexpr int count = 100000;
+  std::unique_ptr<PlyData> ascii = import_synthetic_ply(PlyFormatType::ASCII, count);
+  ASSERT_TRUE(ascii->error.empty());
+  EXPECT_EQ(ascii->vertices.size(), count);
+  EXPECT_EQ(ascii->face_sizes.size(), count / 2 - 1);
+  EXPECT_EQ(ascii->edges.size(), 2);
+  ASSERT_EQ(ascii->vertex_custom_attr.size(), 2);
+
+  for (const PlyFormatType type : {PlyFormatType::BINARY_LE, PlyFormatType::BINARY_BE}) {
+    std::unique_ptr<PlyData> binary = import_synthetic_ply(type, count);
+    ASSERT_TRUE(binary->error.empty());
+    EXPECT_EQ_SPAN<float3>(ascii->vertices, binary->vertices);
+    EXPECT_EQ_SPAN<float3>(ascii->vertex_normals, binary->vertex_normals);
+    EXPECT_EQ_SPAN<float4>(ascii->vertex_colors, binary->vertex_colors);
+    EXPECT_EQ_SPAN<float2>(ascii->uv_coordinates, binary->uv_coordinates);
+    ASSERT_EQ(ascii->vertex_custom_attr.size(), binary->vertex_custom_attr.size());
+    for (const int i : ascii->vertex_custom_attr.index_range()) {
+      EXPECT_EQ(ascii->vertex_custom_attr[i].name, binary->vertex_custom_attr[i].name);
+      EXPECT_EQ_SPAN<float>(ascii->vertex_custom_attr[i].data, binary->vertex_custom_attr[i].data);
+    }
+    EXPECT_EQ_SPAN<uint32_t>(ascii->face_sizes, binary->face_sizes);
+    EXPECT_EQ_SPAN<uint32_t>(ascii->face_vertices, binary->face_vertices);
+    EXPECT_EQ_SPAN<std::pair<int, int>>(ascii->edges, binary->edges);
+  }
+}
+
 //@TODO: now we put vertex color attribute first, maybe put position first?
 //@TODO: test with vertex element having list properties
 //@TODO: test with edges starting with non-vertex index properties
@@ -137,8 +137,9 @@ void export_frame(Depsgraph *depsgraph,
     /* Write triangles. */
     const Span<float3> positions = mesh->vert_positions();
     const Span<int> corner_verts = mesh->corner_verts();
-    for (const int3 &tri : mesh->corner_tris()) {
-      PackedTriangle data{};
+    const Span<int3> corner_tris = mesh->corner_tris();
+    writer->write_triangles(corner_tris.size(), [&](const int64_t tri_i, PackedTriangle &data) {
+      const int3 &tri = corner_tris[tri_i];
       for (int i = 0; i < 3; i++) {
         /* Reverse face order for mirrored objects. */
         int idx = mirrored ? 2 - i : i;
@@ -148,8 +149,7 @@ void export_frame(Depsgraph *depsgraph,
         data.vertices[i] = pos;
       }
       data.normal = math::normal_tri(data.vertices[0], data.vertices[1], data.vertices[2]);
-      writer->write_triangle(data);
-    }
+    });
   }
   DEG_OBJECT_ITER_END;
 }
@@ -6,6 +6,7 @@
  * \ingroup stl
  */
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <stdexcept>
@@ -17,8 +18,11 @@
 #include "stl_data.hh"
 #include "stl_export_writer.hh"
 
+#include "BLI_array.hh"
 #include "BLI_fileops.h"
 
+#include "IO_chunked_write.hh"
+
 namespace blender::io::stl {
 
 FileWriter::FileWriter(const char *filepath, bool ascii) : tris_num_(0), ascii_(ascii)
@@ -56,35 +60,71 @@ FileWriter::~FileWriter()
   fclose(file_);
 }
 
-void FileWriter::write_triangle(const PackedTriangle &data)
+/* Split up large meshes into multi-threaded jobs; each job writes this amount of triangles. */
+static constexpr int64_t chunk_size = 8192;
+/* Size of a triangle written in ASCII format with typical number lengths. */
+static constexpr int64_t ascii_triangle_bytes = 256;
+
+static void format_triangle(fmt::memory_buffer &buf, const PackedTriangle &data, const bool ascii)
 {
-  tris_num_++;
-  if (ascii_) {
-    fmt::print(file_,
-               "facet normal {} {} {}\n"
-               " outer loop\n"
-               "  vertex {} {} {}\n"
-               "  vertex {} {} {}\n"
-               "  vertex {} {} {}\n"
-               " endloop\n"
-               "endfacet\n",
+  if (ascii) {
+    fmt::format_to(fmt::appender(buf),
+                   "facet normal {} {} {}\n"
+                   " outer loop\n"
+                   "  vertex {} {} {}\n"
+                   "  vertex {} {} {}\n"
+                   "  vertex {} {} {}\n"
+                   " endloop\n"
+                   "endfacet\n",
 
-               data.normal.x,
-               data.normal.y,
-               data.normal.z,
-               data.vertices[0].x,
-               data.vertices[0].y,
-               data.vertices[0].z,
-               data.vertices[1].x,
-               data.vertices[1].y,
-               data.vertices[1].z,
-               data.vertices[2].x,
-               data.vertices[2].y,
-               data.vertices[2].z);
+                   data.normal.x,
+                   data.normal.y,
+                   data.normal.z,
+                   data.vertices[0].x,
+                   data.vertices[0].y,
+                   data.vertices[0].z,
+                   data.vertices[1].x,
+                   data.vertices[1].y,
+                   data.vertices[1].z,
+                   data.vertices[2].x,
+                   data.vertices[2].y,
+                   data.vertices[2].z);
   }
   else {
-    fwrite(&data, sizeof(data), 1, file_);
+    const char *bytes = reinterpret_cast<const char *>(&data);
+    buf.append(bytes, bytes + sizeof(data));
+  }
+}
+
+void FileWriter::write_triangles(
+    const int64_t tris_num,
+    const FunctionRef<void(int64_t index, PackedTriangle &r_data)> get_triangle)
+{
+  const int64_t chunks_num = (tris_num + chunk_size - 1) / chunk_size;
+  if (chunks_num == 0) {
+    return;
   }
+  const int64_t chunk_bytes = chunk_size * (ascii_ ? ascii_triangle_bytes : BINARY_STRIDE);
+  const int slots_num = int(std::min<int64_t>(
+      chunked_write_slots_num(chunked_write_default_memory_budget, chunk_bytes), chunks_num));
+  Array<fmt::memory_buffer> buffers(slots_num);
+  parallel_chunked_write(
+      chunks_num,
+      slots_num,
+      [&](const int64_t chunk, const int slot) {
+        const int64_t start = chunk * chunk_size;
+        const int64_t end = std::min(start + chunk_size, tris_num);
+        for (int64_t i = start; i < end; i++) {
+          PackedTriangle data{};
+          get_triangle(i, data);
+          format_triangle(buffers[slot], data, ascii_);
+        }
+      },
+      [&](const int slot) {
+        fwrite(buffers[slot].data(), 1, buffers[slot].size(), file_);
+        buffers[slot].clear();
+      });
+  tris_num_ += tris_num;
 }
 
 }  // namespace blender::io::stl
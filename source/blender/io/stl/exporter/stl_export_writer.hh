@@ -11,6 +11,8 @@
 #include <cstdint>
 #include <cstdio>
 
+#include "BLI_function_ref.hh"
+
 namespace blender::io::stl {
 
 struct PackedTriangle;
@@ -19,7 +21,12 @@ class FileWriter {
  public:
   FileWriter(const char *filepath, bool ascii);
   ~FileWriter();
-  void write_triangle(const PackedTriangle &data);
+  /**
+   * Write `tris_num` triangles, filled by `get_triangle` for every index. Chunks of triangles are
+   * formatted in parallel, see #parallel_chunked_write.
+   */
+  void write_triangles(int64_t tris_num,
+                       FunctionRef<void(int64_t index, PackedTriangle &r_data)> get_triangle);
 
  private:
   FILE *file_;
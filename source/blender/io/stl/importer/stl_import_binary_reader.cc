@@ -6,12 +6,14 @@
  * \ingroup stl
  */
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 
 #include "BKE_mesh.hh"
 
 #include "BLI_array.hh"
+#include "BLI_task.hh"
 
 #include "DNA_mesh_types.h"
 
@@ -24,7 +26,8 @@ namespace blender::io::stl {
 
 Mesh *read_stl_binary(FILE *file, const bool use_custom_normals)
 {
-  const int chunk_size = 1024;
+  /* Large enough for the deduplication of a chunk to be split between many threads. */
+  const int64_t chunk_size = 256 * 1024;
   uint32_t num_tris = 0;
   fseek(file, BINARY_HEADER_SIZE, SEEK_SET);
   if (fread(&num_tris, sizeof(uint32_t), 1, file) != 1) {
@@ -36,13 +39,21 @@ Mesh *read_stl_binary(FILE *file, const bool use_custom_normals)
     return BKE_mesh_new_nomain(0, 0, 0, 0);
   }
 
-  Array<PackedTriangle> tris_buf(chunk_size);
+  Array<PackedTriangle> tris_buf(std::min<int64_t>(chunk_size, num_tris));
+  Array<PackedTriangle> next_tris_buf(tris_buf.size());
   STLMeshHelper stl_mesh(num_tris, use_custom_normals);
-  size_t num_read_tris;
-  while ((num_read_tris = fread(tris_buf.data(), sizeof(PackedTriangle), chunk_size, file))) {
-    for (size_t i = 0; i < num_read_tris; i++) {
-      stl_mesh.add_triangle(tris_buf[i]);
-    }
+  size_t num_read_tris = fread(tris_buf.data(), sizeof(PackedTriangle), tris_buf.size(), file);
+  while (num_read_tris > 0) {
+    /* Read the next chunk while the current one is being added. */
+    size_t num_next_tris = 0;
+    threading::parallel_invoke(
+        [&]() {
+          num_next_tris = fread(
+              next_tris_buf.data(), sizeof(PackedTriangle), next_tris_buf.size(), file);
+        },
+        [&]() { stl_mesh.add_triangles(tris_buf.as_span().take_front(num_read_tris)); });
+    std::swap(tris_buf, next_tris_buf);
+    num_read_tris = num_next_tris;
   }
 
   return stl_mesh.to_mesh();
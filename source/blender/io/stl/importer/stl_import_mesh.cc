@@ -9,7 +9,9 @@
 #include "BKE_mesh.hh"
 
 #include "BLI_array_utils.hh"
+#include "BLI_hash.hh"
 #include "BLI_span.hh"
+#include "BLI_task.hh"
 
 #include "DNA_mesh_types.h"
 
@@ -22,31 +24,57 @@ static CLG_LogRef LOG = {"io.stl"};
 namespace blender::io::stl {
 
 STLMeshHelper::STLMeshHelper(int tris_num, bool use_custom_normals)
-    : use_custom_normals_(use_custom_normals)
+    : vert_shards_(shards_num), tri_shards_(shards_num), use_custom_normals_(use_custom_normals)
 {
   degenerate_tris_num_ = 0;
   duplicate_tris_num_ = 0;
   tris_.reserve(tris_num);
   /* Upper bound (all vertices are unique). */
   verts_.reserve(tris_num * 3);
+  for (VertexShard &shard : vert_shards_) {
+    shard.positions.reserve(tris_num * 3 / shards_num);
+  }
+  for (Set<Triangle> &shard : tri_shards_) {
+    shard.reserve(tris_num / shards_num);
+  }
   if (use_custom_normals) {
     loop_normals_.reserve(tris_num * 3);
   }
 }
 
+int STLMeshHelper::shard_index(const uint64_t hash)
+{
+  /* Use the high bits of a multiplicative hash, the low bits are used by the shard tables. */
+  return int((hash * 0x9E3779B97F4A7C15ull) >> (64 - shard_bits));
+}
+
+int STLMeshHelper::add_vertex(const float3 &position)
+{
+  VertexShard &shard = vert_shards_[shard_index(get_default_hash(position))];
+  const int shard_size = shard.positions.size();
+  const int index = shard.positions.index_of_or_add(position);
+  if (index == shard_size) {
+    shard.vert_indices.append(verts_.size());
+    verts_.append(position);
+  }
+  return shard.vert_indices[index];
+}
+
 bool STLMeshHelper::add_triangle(const PackedTriangle &data)
 {
-  int v1_id = verts_.index_of_or_add(data.vertices[0]);
-  int v2_id = verts_.index_of_or_add(data.vertices[1]);
-  int v3_id = verts_.index_of_or_add(data.vertices[2]);
+  int v1_id = add_vertex(data.vertices[0]);
+  int v2_id = add_vertex(data.vertices[1]);
+  int v3_id = add_vertex(data.vertices[2]);
   if ((v1_id == v2_id) || (v1_id == v3_id) || (v2_id == v3_id)) {
     degenerate_tris_num_++;
     return false;
   }
-  if (!tris_.add({v1_id, v2_id, v3_id})) {
+  const Triangle tri{v1_id, v2_id, v3_id};
+  if (!tri_shards_[shard_index(tri.hash())].add(tri)) {
     duplicate_tris_num_++;
     return false;
   }
+  tris_.append(tri);
 
   if (use_custom_normals_) {
     loop_normals_.append_n_times(data.normal, 3);
@@ -54,6 +82,124 @@ bool STLMeshHelper::add_triangle(const PackedTriangle &data)
   return true;
 }
 
+/**
+ * Group the element indices by their shard, in ascending order within every group, so that the
+ * task filling a shard only has to visit its own elements.
+ * \return Offsets of the groups in \a r_indices.
+ */
+static Array<int64_t> group_by_shard(const Span<uint8_t> shards,
+                                     const int groups_num,
+                                     Array<int64_t> &r_indices)
+{
+  Array<int64_t> offsets(groups_num + 1, 0);
+  for (const uint8_t shard : shards) {
+    offsets[shard + 1]++;
+  }
+  for (const int group : IndexRange(groups_num)) {
+    offsets[group + 1] += offsets[group];
+  }
+  r_indices.reinitialize(shards.size());
+  Array<int64_t> group_sizes(groups_num, 0);
+  for (const int64_t i : shards.index_range()) {
+    const uint8_t shard = shards[i];
+    r_indices[offsets[shard] + group_sizes[shard]++] = i;
+  }
+  return offsets;
+}
+
+void STLMeshHelper::add_triangles(const Span<PackedTriangle> tris)
+{
+  const int64_t corners_num = tris.size() * 3;
+  const auto corner_position = [&](const int64_t corner) -> const float3 & {
+    return tris[corner / 3].vertices[corner % 3];
+  };
+
+  /* Every shard is filled by a single task, in the order of the corners. That gives the same
+   * shard contents as adding the triangles one by one. */
+  Array<uint8_t> corner_shards(corners_num);
+  threading::parallel_for(IndexRange(corners_num), 4096, [&](const IndexRange range) {
+    for (const int64_t corner : range) {
+      corner_shards[corner] = shard_index(get_default_hash(corner_position(corner)));
+    }
+  });
+  Array<int64_t> corners_by_shard;
+  const Array<int64_t> corner_offsets = group_by_shard(
+      corner_shards, shards_num, corners_by_shard);
+  Array<int> corner_shard_indices(corners_num);
+  Array<bool> corner_is_first(corners_num);
+  threading::parallel_for(IndexRange(shards_num), 1, [&](const IndexRange range) {
+    for (const int shard_i : range) {
+      VectorSet<float3> &positions = vert_shards_[shard_i].positions;
+      const IndexRange shard_corners = IndexRange::from_begin_end(corner_offsets[shard_i],
+                                                                  corner_offsets[shard_i + 1]);
+      for (const int64_t corner : corners_by_shard.as_span().slice(shard_corners)) {
+        const int shard_size = positions.size();
+        const int index = positions.index_of_or_add(corner_position(corner));
+        corner_shard_indices[corner] = index;
+        corner_is_first[corner] = index == shard_size;
+      }
+    }
+  });
+
+  /* Number the new vertices in order of their first occurrence. New positions in a shard are
+   * visited in the same order as they were added to it. */
+  for (const int64_t corner : IndexRange(corners_num)) {
+    if (corner_is_first[corner]) {
+      vert_shards_[corner_shards[corner]].vert_indices.append(verts_.size());
+      verts_.append(corner_position(corner));
+    }
+  }
+  const auto corner_vert = [&](const int64_t corner) {
+    const VertexShard &shard = vert_shards_[corner_shards[corner]];
+    return shard.vert_indices[corner_shard_indices[corner]];
+  };
+  Array<Triangle> new_tris(tris.size());
+  threading::parallel_for(tris.index_range(), 4096, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      new_tris[i] = {corner_vert(i * 3), corner_vert(i * 3 + 1), corner_vert(i * 3 + 2)};
+    }
+  });
+
+  /* Deduplicate the triangles the same way, degenerate triangles are not added to any shard. */
+  const uint8_t degenerate_shard = shards_num;
+  Array<uint8_t> tri_shards(tris.size());
+  threading::parallel_for(tris.index_range(), 4096, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      const Triangle &tri = new_tris[i];
+      const bool is_degenerate = (tri.v1 == tri.v2) || (tri.v1 == tri.v3) || (tri.v2 == tri.v3);
+      tri_shards[i] = is_degenerate ? degenerate_shard : shard_index(tri.hash());
+    }
+  });
+  Array<int64_t> tris_by_shard;
+  const Array<int64_t> tri_offsets = group_by_shard(tri_shards, shards_num + 1, tris_by_shard);
+  Array<bool> tri_is_added(tris.size());
+  threading::parallel_for(IndexRange(shards_num), 1, [&](const IndexRange range) {
+    for (const int shard_i : range) {
+      Set<Triangle> &shard = tri_shards_[shard_i];
+      const IndexRange shard_tris = IndexRange::from_begin_end(tri_offsets[shard_i],
+                                                               tri_offsets[shard_i + 1]);
+      for (const int64_t i : tris_by_shard.as_span().slice(shard_tris)) {
+        tri_is_added[i] = shard.add(new_tris[i]);
+      }
+    }
+  });
+
+  for (const int64_t i : tris.index_range()) {
+    if (tri_shards[i] == degenerate_shard) {
+      degenerate_tris_num_++;
+      continue;
+    }
+    if (!tri_is_added[i]) {
+      duplicate_tris_num_++;
+      continue;
+    }
+    tris_.append(new_tris[i]);
+    if (use_custom_normals_) {
+      loop_normals_.append_n_times(tris[i].normal, 3);
+    }
+  }
+}
+
 Mesh *STLMeshHelper::to_mesh()
 {
   if (degenerate_tris_num_ > 0) {
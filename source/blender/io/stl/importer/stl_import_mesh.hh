@@ -10,7 +10,10 @@
 
 #include <cstdint>
 
+#include "BLI_array.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_set.hh"
+#include "BLI_span.hh"
 #include "BLI_vector.hh"
 #include "BLI_vector_set.hh"
 #include "stl_data.hh"
@@ -49,13 +52,30 @@ class Triangle {
 
 class STLMeshHelper {
  private:
-  VectorSet<float3> verts_;
-  VectorSet<Triangle> tris_;
+  /* Vertices and triangles are deduplicated in shards chosen by their hash, so that the shards
+   * can be filled independently by #add_triangles. */
+  static constexpr int shard_bits = 6;
+  static constexpr int shards_num = 1 << shard_bits;
+
+  struct VertexShard {
+    VectorSet<float3> positions;
+    /* Index in #verts_ of every position in the shard. */
+    Vector<int> vert_indices;
+  };
+
+  Array<VertexShard> vert_shards_;
+  Array<Set<Triangle>> tri_shards_;
+  /* Unique vertices and triangles in order of their first occurrence in the file. */
+  Vector<float3> verts_;
+  Vector<Triangle> tris_;
   Vector<float3> loop_normals_;
   int degenerate_tris_num_;
   int duplicate_tris_num_;
   const bool use_custom_normals_;
 
+  static int shard_index(uint64_t hash);
+  int add_vertex(const float3 &position);
+
  public:
   STLMeshHelper(int tris_num, bool use_custom_normals);
 
@@ -64,6 +84,11 @@ class STLMeshHelper {
    */
   bool add_triangle(const PackedTriangle &data);
 
+  /* Same as calling #add_triangle for all triangles in order, but multi-threaded.
+   * The resulting mesh does not depend on how the triangles are split into batches.
+   */
+  void add_triangles(Span<PackedTriangle> tris);
+
   Mesh *to_mesh();
 };
 
@@ -0,0 +1,97 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BKE_appdir.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+
+#include "BLI_fileops.h"
+#include "BLI_path_utils.hh"
+#include "BLI_rand.hh"
+
+#include "CLG_log.h"
+
+#include "DNA_mesh_types.h"
+
+#include "stl_data.hh"
+#include "stl_import_binary_reader.hh"
+#include "stl_import_mesh.hh"
+
+namespace blender::io::stl {
+
+class STLImportTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+    BKE_tempdir_init(nullptr);
+  }
+
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+};
+
+/* Triangles with many shared vertices, degenerate and duplicate triangles. */
+static Vector<PackedTriangle> create_test_triangles(const int tris_num)
+{
+  RandomNumberGenerator rng(7);
+  Vector<PackedTriangle> tris;
+  for (const int i : IndexRange(tris_num)) {
+    PackedTriangle tri{};
+    tri.normal = float3(0.0f, 0.0f, 1.0f);
+    for (float3 &position : tri.vertices) {
+      /* Draw from a small grid of positions so that most vertices are shared. */
+      position = float3(rng.get_int32(200), rng.get_int32(200), (i % 5 == 0) ? 0 : i % 3);
+    }
+    tris.append(tri);
+    if (i % 100 == 0) {
+      std::swap(tri.vertices[0], tri.vertices[2]);
+      tris.append(tri);
+    }
+  }
+  return tris;
+}
+
+TEST_F(STLImportTest, BinaryMatchesSerial)
+{
+  const Vector<PackedTriangle> tris = create_test_triangles(300000);
+
+  const std::string filepath = std::string(BKE_tempdir_base()) + SEP_STR + "stl_import_test.stl";
+  FILE *file = BLI_fopen(filepath.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  const char header[BINARY_HEADER_SIZE] = {};
+  const uint32_t tris_num = tris.size();
+  fwrite(header, 1, sizeof(header), file);
+  fwrite(&tris_num, sizeof(tris_num), 1, file);
+  fwrite(tris.data(), sizeof(PackedTriangle), tris.size(), file);
+  fclose(file);
+
+  file = BLI_fopen(filepath.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  Mesh *mesh = read_stl_binary(file, false);
+  fclose(file);
+  BLI_delete(filepath.c_str(), false, false);
+  ASSERT_NE(mesh, nullptr);
+
+  STLMeshHelper serial_helper(tris.size(), false);
+  for (const PackedTriangle &tri : tris) {
+    serial_helper.add_triangle(tri);
+  }
+  Mesh *expected = serial_helper.to_mesh();
+
+  EXPECT_EQ(mesh->faces_num, expected->faces_num);
+  EXPECT_EQ_SPAN<float3>(mesh->vert_positions(), expected->vert_positions());
+  EXPECT_EQ_SPAN<int>(mesh->corner_verts(), expected->corner_verts());
+
+  BKE_id_free(nullptr, mesh);
+  BKE_id_free(nullptr, expected);
+}
+
+}  // namespace blender::io::stl
@@ -24,7 +24,9 @@
 #include "BLI_math_matrix.h"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
+#include "BLI_task.hh"
 #include "BLI_timeit.hh"
+#include "BLI_vector.hh"
 
 #include "BLT_translation.hh"
 
@@ -53,6 +55,8 @@
 
 #include <fmt/core.h>
 
+#include <utility>
+
 namespace blender::io::usd {
 
 static CacheArchiveHandle *handle_from_stage_reader(USDStageReader *reader)
@@ -109,6 +113,8 @@ struct ImportJobData {
   bool import_ok;
   bool is_background_job;
   timeit::TimePoint start_time;
+  /* Duration of the main steps of the import, printed with the total duration. */
+  Vector<std::pair<const char *, timeit::Nanoseconds>> step_durations;
 
   CacheFile *cache_file;
 };
@@ -119,6 +125,22 @@ static void report_job_duration(const ImportJobData *data)
   fmt::print("USD import of '{}' took ", data->filepath);
   timeit::print_duration(duration);
   fmt::print("\n");
+  for (const auto &[name, step_duration] : data->step_durations) {
+    fmt::print("  {}: ", name);
+    timeit::print_duration(step_duration);
+    fmt::print("\n");
+  }
+}
+
+/* Record the duration of an import step that started at the given time, and restart the time for
+ * the next step. */
+static void record_step_duration(ImportJobData *data,
+                                 const char *name,
+                                 timeit::TimePoint &r_step_start_time)
+{
+  const timeit::TimePoint now = timeit::Clock::now();
+  data->step_durations.append({name, now - r_step_start_time});
+  r_step_start_time = now;
 }
 
 static void import_startjob(void *customdata, wmJobWorkerStatus *worker_status)
@@ -131,6 +153,7 @@ static void import_startjob(void *customdata, wmJobWorkerStatus *worker_status)
   data->was_canceled = false;
   data->archive = nullptr;
   data->start_time = timeit::Clock::now();
+  data->step_durations.clear();
   data->cache_file = nullptr;
 
   data->params.worker_status = worker_status;
@@ -174,6 +197,7 @@ static void import_startjob(void *customdata, wmJobWorkerStatus *worker_status)
     }
   }
 
+  timeit::TimePoint step_start_time = timeit::Clock::now();
   pxr::UsdStageRefPtr stage = pop_mask.IsEmpty() ?
                                   pxr::UsdStage::Open(data->filepath) :
                                   pxr::UsdStage::OpenMasked(data->filepath, pop_mask);
@@ -188,6 +212,8 @@ static void import_startjob(void *customdata, wmJobWorkerStatus *worker_status)
     return;
   }
 
+  record_step_duration(data, "Open stage", step_start_time);
+
   double scene_scale = data->params.scale;
   if (data->params.apply_unit_conversion_scale) {
     scene_scale *= pxr::UsdGeomGetStageMetersPerUnit(stage);
@@ -257,6 +283,7 @@ static void import_startjob(void *customdata, wmJobWorkerStatus *worker_status)
   archive->sort_readers();
   *data->do_update = true;
   *data->progress = 0.25f;
+  record_step_duration(data, "Collect readers", step_start_time);
 
   /* Create blender objects. */
   for (USDPrimReader *reader : archive->readers()) {
@@ -266,6 +293,27 @@ static void import_startjob(void *customdata, wmJobWorkerStatus *worker_status)
       *data->progress = 0.25f + 0.25f * (i / size);
     }
   }
+  record_step_duration(data, "Create objects", step_start_time);
+
+  /* Read the data that does not need #Main, such as mesh geometry, for all readers in parallel. */
+  const Span<USDPrimReader *> readers = archive->readers();
+  threading::parallel_for(readers.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t reader_index : range) {
+      if (G.is_break) {
+        return;
+      }
+      readers[reader_index]->prepare_object_data(0.0);
+    }
+  });
+  record_step_duration(data, "Read geometry", step_start_time);
+
+  if (G.is_break) {
+    data->was_canceled = true;
+    return;
+  }
+
+  *data->do_update = true;
+  *data->progress = 0.75f;
 
   /* Setup parenthood and read actual object data. */
   i = 0;
@@ -281,7 +329,7 @@ static void import_startjob(void *customdata, wmJobWorkerStatus *worker_status)
       ob->parent = parent->object();
     }
 
-    *data->progress = 0.5f + 0.5f * (++i / size);
+    *data->progress = 0.75f + 0.25f * (++i / size);
     *data->do_update = true;
 
     if (G.is_break) {
@@ -289,6 +337,7 @@ static void import_startjob(void *customdata, wmJobWorkerStatus *worker_status)
       return;
     }
   }
+  record_step_duration(data, "Read object data", step_start_time);
 
   if (data->params.import_skeletons) {
     archive->process_armature_modifiers();
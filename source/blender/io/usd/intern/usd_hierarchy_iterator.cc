@@ -476,6 +476,11 @@ void USDHierarchyIterator::add_to_prim_map(const pxr::SdfPath &usd_path, const I
   }
 }
 
+USDMeshPrototypes &USDHierarchyIterator::mesh_prototypes()
+{
+  return mesh_prototypes_;
+}
+
 USDExporterContext USDHierarchyIterator::create_point_instancer_context(
     const HierarchyContext *context, const USDExporterContext &export_context) const
 {
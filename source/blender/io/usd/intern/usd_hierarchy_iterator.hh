@@ -6,6 +6,7 @@
 #include "IO_abstract_hierarchy_iterator.h"
 #include "usd.hh"
 #include "usd_exporter_context.hh"
+#include "usd_mesh_prototypes.hh"
 #include "usd_skel_convert.hh"
 
 #include <string>
@@ -47,6 +48,9 @@ class USDHierarchyIterator : public AbstractHierarchyIterator {
    *   (proto_path_1, proto_object_1), (proto_path_2, proto_object_2), ... ] */
   Map<pxr::SdfPath, Set<std::pair<pxr::SdfPath, Object *>>> prototype_paths_;
 
+  /* Meshes which have been written, to reference them from objects with the same mesh data. */
+  USDMeshPrototypes mesh_prototypes_;
+
  public:
   USDHierarchyIterator(Main *bmain,
                        Depsgraph *depsgraph,
@@ -68,6 +72,9 @@ class USDHierarchyIterator : public AbstractHierarchyIterator {
   /* Add an ID to the prim map for a given USD path. */
   void add_to_prim_map(const pxr::SdfPath &usd_path, const ID *id) const;
 
+  /* Get the meshes which have been written so far, see #USDMeshPrototypes. */
+  USDMeshPrototypes &mesh_prototypes();
+
  protected:
   bool mark_as_weak_export(const Object *object) const override;
   bool determine_point_instancers(const HierarchyContext *context);
@@ -0,0 +1,218 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "usd_mesh_prototypes.hh"
+
+#include "BKE_customdata.hh"
+#include "BKE_mesh_types.hh"
+
+#include "BLI_memory_utils.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_vector.hh"
+
+#include "DNA_customdata_types.h"
+#include "DNA_mesh_types.h"
+
+#include <optional>
+#include <type_traits>
+#include <xxhash.h>
+
+namespace blender::io::usd {
+
+namespace {
+
+/** One of the arrays which make up the data of a mesh. */
+struct MeshArray {
+  int type;
+  StringRefNull name;
+  const void *data;
+  int64_t size_in_bytes;
+  const ImplicitSharingInfo *sharing_info;
+};
+
+void mesh_arrays_from_custom_data(const CustomData &data,
+                                  const int elements_num,
+                                  Vector<MeshArray> &r_arrays)
+{
+  for (const CustomDataLayer &layer : Span(data.layers, data.totlayer)) {
+    const int64_t size_in_bytes = layer.data ? int64_t(CustomData_get_elem_size(&layer)) *
+                                                   elements_num :
+                                               0;
+    r_arrays.append({layer.type, layer.name, layer.data, size_in_bytes, layer.sharing_info});
+  }
+}
+
+Vector<MeshArray> mesh_arrays_get(const Mesh &mesh)
+{
+  Vector<MeshArray> arrays;
+  arrays.append({-1,
+                 "",
+                 mesh.face_offset_indices,
+                 mesh.faces_num == 0 ? 0 : int64_t(sizeof(int)) * (mesh.faces_num + 1),
+                 mesh.runtime->face_offsets_sharing_info});
+  mesh_arrays_from_custom_data(mesh.vert_data, mesh.verts_num, arrays);
+  mesh_arrays_from_custom_data(mesh.edge_data, mesh.edges_num, arrays);
+  mesh_arrays_from_custom_data(mesh.face_data, mesh.faces_num, arrays);
+  mesh_arrays_from_custom_data(mesh.corner_data, mesh.corners_num, arrays);
+  return arrays;
+}
+
+StringRefNull optional_name(const char *name)
+{
+  return name ? StringRefNull(name) : StringRefNull();
+}
+
+template<typename T> void hash_update(XXH3_state_t *state, const T &value)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  XXH3_128bits_update(state, &value, sizeof(T));
+}
+
+void hash_update_string(XXH3_state_t *state, const StringRef str)
+{
+  hash_update(state, str.size());
+  XXH3_128bits_update(state, str.data(), size_t(str.size()));
+}
+
+/** Hash everything that is written for a mesh prim, except for the data of its arrays. */
+void hash_update_metadata(XXH3_state_t *state,
+                          const Mesh &mesh,
+                          const Span<const Material *> materials,
+                          const ID *properties_owner)
+{
+  hash_update(state, mesh.verts_num);
+  hash_update(state, mesh.edges_num);
+  hash_update(state, mesh.faces_num);
+  hash_update(state, mesh.corners_num);
+  hash_update_string(state, mesh.default_uv_map_name());
+  hash_update_string(state, optional_name(mesh.active_color_attribute));
+  hash_update_string(state, optional_name(mesh.default_color_attribute));
+  hash_update(state, materials.size());
+  for (const Material *material : materials) {
+    hash_update(state, material);
+  }
+  hash_update(state, properties_owner);
+}
+
+/**
+ * Fingerprint of everything that is written for a mesh prim. 128 bit hashes are used so that
+ * meshes can be matched without keeping them around for a full comparison.
+ */
+MeshFingerprint mesh_fingerprint(const Mesh &mesh,
+                                 const Span<MeshArray> arrays,
+                                 const Span<const Material *> materials,
+                                 const ID *properties_owner)
+{
+  XXH3_state_t *state = XXH3_createState();
+  BLI_SCOPED_DEFER([&]() { XXH3_freeState(state); });
+  XXH3_128bits_reset(state);
+
+  hash_update_metadata(state, mesh, materials, properties_owner);
+  for (const MeshArray &array : arrays) {
+    hash_update(state, array.type);
+    hash_update_string(state, array.name);
+    hash_update(state, array.size_in_bytes);
+    if (array.size_in_bytes > 0) {
+      XXH3_128bits_update(state, array.data, size_t(array.size_in_bytes));
+    }
+  }
+
+  const XXH128_hash_t hash = XXH3_128bits_digest(state);
+  return {hash.low64, hash.high64};
+}
+
+/**
+ * Like #mesh_fingerprint, but using the #ImplicitSharingInfo and its version instead of the data
+ * of every array. Meshes with arrays that are not shared have no identity.
+ */
+std::optional<MeshFingerprint> mesh_identity(const Mesh &mesh,
+                                             const Span<MeshArray> arrays,
+                                             const Span<const Material *> materials,
+                                             const ID *properties_owner)
+{
+  for (const MeshArray &array : arrays) {
+    if (array.size_in_bytes > 0 && array.sharing_info == nullptr) {
+      return std::nullopt;
+    }
+  }
+
+  XXH3_state_t *state = XXH3_createState();
+  BLI_SCOPED_DEFER([&]() { XXH3_freeState(state); });
+  XXH3_128bits_reset(state);
+
+  hash_update_metadata(state, mesh, materials, properties_owner);
+  for (const MeshArray &array : arrays) {
+    hash_update(state, array.type);
+    hash_update_string(state, array.name);
+    hash_update(state, array.size_in_bytes);
+    hash_update(state, array.sharing_info);
+    hash_update(state, array.sharing_info ? array.sharing_info->version() : int64_t(0));
+  }
+
+  const XXH128_hash_t hash = XXH3_128bits_digest(state);
+  return MeshFingerprint{hash.low64, hash.high64};
+}
+
+}  // namespace
+
+pxr::SdfPath USDMeshPrototypes::lookup_or_add(const Mesh &mesh,
+                                              const Span<const Material *> materials,
+                                              const ID *properties_owner,
+                                              const pxr::SdfPath &path)
+{
+  const Vector<MeshArray> arrays = mesh_arrays_get(mesh);
+
+  const std::optional<MeshFingerprint> identity = mesh_identity(
+      mesh, arrays, materials, properties_owner);
+  /* Compare the sharing infos themselves, in case the fingerprints collide. */
+  const auto shared_arrays_match = [&](const Span<SharedArray> shared_arrays) {
+    if (arrays.size() != shared_arrays.size()) {
+      return false;
+    }
+    for (const int64_t i : arrays.index_range()) {
+      const ImplicitSharingInfo *sharing_info = shared_arrays[i].sharing_info.get();
+      if (sharing_info != arrays[i].sharing_info) {
+        return false;
+      }
+      if (sharing_info &&
+          (sharing_info->is_expired() || sharing_info->version() != shared_arrays[i].version))
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+  if (identity) {
+    if (const SharedArraysPrototype *prototype = prototypes_by_identity_.lookup_ptr(*identity)) {
+      if (shared_arrays_match(prototype->arrays)) {
+        return prototype->path;
+      }
+    }
+  }
+
+  const MeshFingerprint fingerprint = mesh_fingerprint(mesh, arrays, materials, properties_owner);
+  const pxr::SdfPath *prototype_path = prototype_paths_.lookup_ptr(fingerprint);
+
+  /* Find further meshes with the same arrays by their identity. */
+  if (identity) {
+    SharedArraysPrototype prototype;
+    for (const MeshArray &array : arrays) {
+      if (array.sharing_info) {
+        array.sharing_info->add_weak_user();
+      }
+      prototype.arrays.append({WeakImplicitSharingPtr(array.sharing_info),
+                               array.sharing_info ? array.sharing_info->version() : 0});
+    }
+    prototype.path = prototype_path ? *prototype_path : path;
+    prototypes_by_identity_.add_overwrite(*identity, std::move(prototype));
+  }
+
+  if (prototype_path) {
+    return *prototype_path;
+  }
+  prototype_paths_.add_new(fingerprint, path);
+  return {};
+}
+
+}  // namespace blender::io::usd
@@ -0,0 +1,82 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+#pragma once
+
+#include "BLI_implicit_sharing_ptr.hh"
+#include "BLI_map.hh"
+#include "BLI_span.hh"
+#include "BLI_struct_equality_utils.hh"
+#include "BLI_vector.hh"
+
+#include <pxr/usd/sdf/path.h>
+
+struct ID;
+struct Material;
+struct Mesh;
+
+namespace blender::io::usd {
+
+/** 128 bit hash of the data written for a mesh prim, see #USDMeshPrototypes. */
+struct MeshFingerprint {
+  uint64_t low;
+  uint64_t high;
+
+  uint64_t hash() const
+  {
+    return low;
+  }
+
+  BLI_STRUCT_EQUALITY_OPERATORS_2(MeshFingerprint, low, high)
+};
+
+/**
+ * Keeps track of the mesh prims that have been written, so that meshes with the same data can
+ * reference them instead of being written again. This is the case for linked duplicates without
+ * modifiers, and often for the output of geometry nodes.
+ *
+ * Only a fingerprint of the written meshes is kept, so that memory usage doesn't grow with the
+ * size of the exported scene.
+ *
+ * Meshes which share all their arrays with a written mesh, such as linked duplicates, are found by
+ * the identity of the arrays first, without hashing their data.
+ */
+class USDMeshPrototypes {
+ private:
+  struct SharedArray {
+    /**
+     * The weak user keeps the sharing info alive, so that its address is not reused by other
+     * arrays, even when the written mesh has been freed.
+     */
+    WeakImplicitSharingPtr sharing_info;
+    int64_t version;
+  };
+
+  struct SharedArraysPrototype {
+    /** The arrays of the written mesh, in the order they are hashed in. */
+    Vector<SharedArray> arrays;
+    pxr::SdfPath path;
+  };
+
+  /** Written meshes by a fingerprint of their #ImplicitSharingInfo pointers and versions. */
+  Map<MeshFingerprint, SharedArraysPrototype> prototypes_by_identity_;
+  /** Written meshes by a fingerprint of their data. */
+  Map<MeshFingerprint, pxr::SdfPath> prototype_paths_;
+
+ public:
+  /**
+   * Find the path of a mesh prim that was written with the same mesh data and materials.
+   * When there is none, the mesh is added as prototype that will be written to the given path,
+   * and an empty path is returned.
+   *
+   * \param properties_owner: The ID whose custom properties are written for the mesh, or null if
+   * there are none. Meshes with custom properties are only shared with the same ID, because the
+   * reference brings the properties of the prototype along.
+   */
+  pxr::SdfPath lookup_or_add(const Mesh &mesh,
+                             Span<const Material *> materials,
+                             const ID *properties_owner,
+                             const pxr::SdfPath &path);
+};
+
+}  // namespace blender::io::usd
@@ -18,6 +18,7 @@
 #include "BKE_attribute.hh"
 #include "BKE_customdata.hh"
 #include "BKE_geometry_set.hh"
+#include "BKE_lib_id.hh"
 #include "BKE_main.hh"
 #include "BKE_material.hh"
 #include "BKE_mesh.hh"
@@ -178,7 +179,15 @@ void USDMeshReader::create_object(Main *bmain)
   object_->data = mesh;
 }
 
-void USDMeshReader::read_object_data(Main *bmain, const pxr::UsdTimeCode time)
+USDMeshReader::~USDMeshReader()
+{
+  /* Only left when the import was canceled between preparing and reading the object data. */
+  if (prepared_mesh_) {
+    BKE_id_free(nullptr, prepared_mesh_);
+  }
+}
+
+void USDMeshReader::prepare_object_data(const pxr::UsdTimeCode time)
 {
   Mesh *mesh = (Mesh *)object_->data;
 
@@ -189,8 +198,23 @@ void USDMeshReader::read_object_data(Main *bmain, const pxr::UsdTimeCode time)
   Mesh *read_mesh = this->read_mesh(mesh, params, nullptr);
 
   is_initial_load_ = false;
+  is_prepared_ = true;
   if (read_mesh != mesh) {
-    BKE_mesh_nomain_to_mesh(read_mesh, mesh, object_);
+    prepared_mesh_ = read_mesh;
+  }
+}
+
+void USDMeshReader::read_object_data(Main *bmain, const pxr::UsdTimeCode time)
+{
+  Mesh *mesh = (Mesh *)object_->data;
+
+  if (!is_prepared_) {
+    this->prepare_object_data(time);
+  }
+  is_prepared_ = false;
+  if (prepared_mesh_) {
+    BKE_mesh_nomain_to_mesh(prepared_mesh_, mesh, object_);
+    prepared_mesh_ = nullptr;
   }
 
   readFaceSetsSample(bmain, mesh, time);
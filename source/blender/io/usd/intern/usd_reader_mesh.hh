@@ -39,6 +39,11 @@ class USDMeshReader : public USDGeomReader {
    * implemented.  Note this will break if faces or positions vary. */
   bool is_initial_load_ = false;
 
+  /* Set by #prepare_object_data(). The mesh is null when the data was read into the object's
+   * mesh directly, otherwise it is a mesh outside of #Main that replaces the object's mesh. */
+  bool is_prepared_ = false;
+  Mesh *prepared_mesh_ = nullptr;
+
  public:
   USDMeshReader(const pxr::UsdPrim &prim,
                 const USDImportParams &import_params,
@@ -46,6 +51,7 @@ class USDMeshReader : public USDGeomReader {
       : USDGeomReader(prim, import_params, settings), mesh_prim_(prim)
   {
   }
+  ~USDMeshReader() override;
 
   bool valid() const override
   {
@@ -53,6 +59,7 @@ class USDMeshReader : public USDGeomReader {
   }
 
   void create_object(Main *bmain) override;
+  void prepare_object_data(pxr::UsdTimeCode time) override;
   void read_object_data(Main *bmain, pxr::UsdTimeCode time) override;
 
   void read_geometry(bke::GeometrySet &geometry_set,
@@ -94,6 +94,12 @@ class USDPrimReader {
   virtual bool valid() const;
 
   virtual void create_object(Main *bmain) = 0;
+  /**
+   * Read the part of the object data that does not need #Main, such as the geometry of a mesh,
+   * ahead of #read_object_data(). This is called for many readers in parallel, so it must only
+   * modify data owned by this reader.
+   */
+  virtual void prepare_object_data(pxr::UsdTimeCode /*time*/) {};
   virtual void read_object_data(Main * /*bmain*/, pxr::UsdTimeCode /*time*/) {};
 
   Object *object() const;
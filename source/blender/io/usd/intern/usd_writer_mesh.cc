@@ -10,6 +10,7 @@
 #include "usd_skel_convert.hh"
 #include "usd_utils.hh"
 
+#include <pxr/usd/usd/references.h>
 #include <pxr/usd/usdGeom/mesh.h>
 #include <pxr/usd/usdGeom/primvarsAPI.h>
 #include <pxr/usd/usdShade/material.h>
@@ -36,6 +37,7 @@
 #include "bmesh_tools.hh"
 
 #include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_query.hh"
 
 #include "DNA_key_types.h"
 #include "DNA_material_types.h"
@@ -122,7 +124,26 @@ void USDGenericMeshWriter::do_write(HierarchyContext &context)
     const SubsurfModifierData *subsurfData = get_last_subdiv_modifier(
         usd_export_context_.export_params.evaluation_mode, object_eval);
 
-    write_mesh(context, mesh, subsurfData);
+    pxr::SdfPath prototype_path;
+    if (subsurfData == nullptr && can_reference_mesh_prototype(context)) {
+      /* Ensure data exists if currently in edit mode. */
+      BKE_mesh_wrapper_ensure_mdata(mesh);
+      Vector<const Material *> materials;
+      for (const int mat_num : IndexRange(object_eval->totcol)) {
+        materials.append(BKE_object_material_get(object_eval, mat_num + 1));
+      }
+      /* The custom properties of the prototype are referenced along with its mesh data. */
+      const ID *properties_owner = nullptr;
+      if (usd_export_context_.export_params.export_custom_properties && mesh->id.properties) {
+        properties_owner = DEG_get_original_id(static_cast<const ID *>(object_eval->data));
+      }
+      prototype_path = usd_export_context_.hierarchy_iterator->mesh_prototypes().lookup_or_add(
+          *mesh, materials, properties_owner, usd_export_context_.usd_path);
+    }
+
+    if (prototype_path.IsEmpty() || !write_mesh_reference(context, prototype_path)) {
+      write_mesh(context, mesh, subsurfData);
+    }
 
     auto prim = usd_export_context_.stage->GetPrimAtPath(usd_export_context_.usd_path);
     if (prim.IsValid() && object_eval) {
@@ -143,6 +164,47 @@ void USDGenericMeshWriter::do_write(HierarchyContext &context)
   }
 }
 
+bool USDGenericMeshWriter::can_reference_mesh_prototype(const HierarchyContext &context) const
+{
+  const USDExportParams &params = usd_export_context_.export_params;
+  /* Only meshes of a single frame are compared. Instanced objects and their prototypes are
+   * already handled by scene graph instancing. */
+  /* With merged transforms the mesh prim is the object's transform prim, so referencing it would
+   * bring along the transform and children of the prototype object as well. */
+  if (!params.use_instancing || params.export_animation || params.merge_parent_xform ||
+      usd_export_context_.hierarchy_iterator == nullptr || context.object == nullptr ||
+      context.is_instance() || context.is_prototype())
+  {
+    return false;
+  }
+  /* Which attributes are written depends on the armature modifier of the object,
+   * see #write_custom_data(). */
+  if (params.export_armatures &&
+      get_armature_modifier_obj(*context.object, usd_export_context_.depsgraph) != nullptr)
+  {
+    return false;
+  }
+  return true;
+}
+
+bool USDGenericMeshWriter::write_mesh_reference(HierarchyContext &context,
+                                                const pxr::SdfPath &prototype_path)
+{
+  pxr::UsdStageRefPtr stage = usd_export_context_.stage;
+  const pxr::SdfPath &usd_path = usd_export_context_.usd_path;
+
+  pxr::UsdGeomMesh usd_mesh = pxr::UsdGeomMesh::Define(stage, usd_path);
+  if (!usd_mesh.GetPrim().GetReferences().AddInternalReference(prototype_path)) {
+    CLOG_WARN(&LOG,
+              "Couldn't reference mesh %s from %s, writing the mesh data instead",
+              prototype_path.GetAsString().c_str(),
+              usd_path.GetAsString().c_str());
+    return false;
+  }
+  write_visibility(context, get_export_time_code(), usd_mesh);
+  return true;
+}
+
 void USDGenericMeshWriter::write_custom_data(const Object *obj,
                                              const Mesh *mesh,
                                              const pxr::UsdGeomMesh &usd_mesh)
@@ -883,6 +945,16 @@ void USDMeshWriter::do_write(HierarchyContext &context)
   }
 }
 
+bool USDMeshWriter::can_reference_mesh_prototype(const HierarchyContext &context) const
+{
+  /* Skinned meshes and blend shapes are written in their rest pose, with data that is not
+   * part of the compared mesh. */
+  if (write_skinned_mesh_ || write_blend_shapes_) {
+    return false;
+  }
+  return USDGenericMeshWriter::can_reference_mesh_prototype(context);
+}
+
 Mesh *USDMeshWriter::get_export_mesh(Object *object_eval, bool &r_needsfree)
 {
   if (write_blend_shapes_) {
@@ -34,8 +34,15 @@ class USDGenericMeshWriter : public USDAbstractWriter {
   virtual Mesh *get_export_mesh(Object *object_eval, bool &r_needsfree) = 0;
   virtual void free_export_mesh(Mesh *mesh);
 
+  /**
+   * Whether the mesh prim may reference a previously written mesh prim with the same data,
+   * instead of writing the mesh data again. See #USDMeshPrototypes.
+   */
+  virtual bool can_reference_mesh_prototype(const HierarchyContext &context) const;
+
  private:
   void write_mesh(HierarchyContext &context, Mesh *mesh, const SubsurfModifierData *subsurfData);
+  bool write_mesh_reference(HierarchyContext &context, const pxr::SdfPath &prototype_path);
   pxr::TfToken get_subdiv_scheme(const SubsurfModifierData *subsurfData);
   void write_subdiv(const pxr::TfToken &subdiv_scheme,
                     const pxr::UsdGeomMesh &usd_mesh,
@@ -68,6 +75,7 @@ class USDMeshWriter : public USDGenericMeshWriter {
   void do_write(HierarchyContext &context) override;
 
   Mesh *get_export_mesh(Object *object_eval, bool &r_needsfree) override;
+  bool can_reference_mesh_prototype(const HierarchyContext &context) const override;
 
   /**
    * Determine whether we should write skinned mesh or blend shape data
@@ -14,7 +14,6 @@
 #include "BKE_mesh.hh"
 
 #include "BLI_color.hh"
-#include "BLI_enumerable_thread_specific.hh"
 #include "BLI_fileops.h"
 #include "BLI_math_matrix.h"
 #include "BLI_math_matrix.hh"
@@ -22,7 +21,6 @@
 #include "BLI_math_vector.h"
 #include "BLI_path_utils.hh"
 #include "BLI_string.h"
-#include "BLI_task.hh"
 
 #include "IO_path_util.hh"
 
@@ -228,60 +226,11 @@ void OBJWriter::write_object_name(FormatHandler &fh, const OBJMesh &obj_mesh_dat
   fh.write_obj_object(object_name);
 }
 
-/* Split up large meshes into multi-threaded jobs; each job processes
- * this amount of items. */
-static const int chunk_size = 32768;
-static int calc_chunk_count(int count)
-{
-  return (count + chunk_size - 1) / chunk_size;
-}
-
-/* Write /tot_count/ items to OBJ file output. Each item is written
- * by a /function/ that should be independent from other items.
- * If the amount of items is large enough (> chunk_size), then writing
- * will be done in parallel, into temporary FormatHandler buffers that
- * will be written into the final /fh/ buffer at the end.
- */
-template<typename Function>
-void obj_parallel_chunked_output(FormatHandler &fh, int tot_count, const Function &function)
-{
-  if (tot_count <= 0) {
-    return;
-  }
-  /* If we have just one chunk, process it directly into the output
-   * buffer - avoids all the job scheduling and temporary vector allocation
-   * overhead. */
-  const int chunk_count = calc_chunk_count(tot_count);
-  if (chunk_count == 1) {
-    for (int i = 0; i < tot_count; i++) {
-      function(fh, i);
-    }
-    return;
-  }
-  /* Give each chunk its own temporary output buffer, and process them in parallel. */
-  Array<FormatHandler> buffers(chunk_count);
-  threading::parallel_for(IndexRange(chunk_count), 1, [&](IndexRange range) {
-    for (const int r : range) {
-      int i_start = r * chunk_size;
-      int i_end = std::min(i_start + chunk_size, tot_count);
-      auto &buf = buffers[r];
-      for (int i = i_start; i < i_end; i++) {
-        function(buf, i);
-      }
-    }
-  });
-  /* Emit all temporary output buffers into the destination buffer. */
-  for (auto &buf : buffers) {
-    fh.append_from(buf);
-  }
-}
-
 void OBJWriter::write_vertex_coords(FormatHandler &fh,
                                     const OBJMesh &obj_mesh_data,
-                                    bool write_colors) const
+                                    bool write_colors,
+                                    const IndexRange range) const
 {
-  const int tot_count = obj_mesh_data.tot_vertices();
-
   const Mesh *mesh = obj_mesh_data.get_mesh();
   const StringRef name = mesh->active_color_attribute;
 
@@ -293,40 +242,36 @@ void OBJWriter::write_vertex_coords(FormatHandler &fh,
     const VArray<ColorGeometry4f> attribute = *attributes.lookup_or_default<ColorGeometry4f>(
         name, bke::AttrDomain::Point, {0.0f, 0.0f, 0.0f, 0.0f});
 
-    BLI_assert(tot_count == attribute.size());
-    obj_parallel_chunked_output(fh, tot_count, [&](FormatHandler &buf, int i) {
+    BLI_assert(obj_mesh_data.tot_vertices() == attribute.size());
+    for (const int i : range) {
       const float3 vertex = math::transform_point(transform, positions[i]);
       ColorGeometry4f linear = attribute.get(i);
       float srgb[3];
       linearrgb_to_srgb_v3_v3(srgb, linear);
-      buf.write_obj_vertex_color(vertex[0], vertex[1], vertex[2], srgb[0], srgb[1], srgb[2]);
-    });
+      fh.write_obj_vertex_color(vertex[0], vertex[1], vertex[2], srgb[0], srgb[1], srgb[2]);
+    }
   }
   else {
-    obj_parallel_chunked_output(fh, tot_count, [&](FormatHandler &buf, int i) {
+    for (const int i : range) {
       const float3 vertex = math::transform_point(transform, positions[i]);
-      buf.write_obj_vertex(vertex[0], vertex[1], vertex[2]);
-    });
+      fh.write_obj_vertex(vertex[0], vertex[1], vertex[2]);
+    }
   }
 }
 
-void OBJWriter::write_uv_coords(FormatHandler &fh, OBJMesh &r_obj_mesh_data) const
+void OBJWriter::write_uv_coords(FormatHandler &fh,
+                                OBJMesh &r_obj_mesh_data,
+                                const IndexRange range) const
 {
   const Span<float2> uv_coords = r_obj_mesh_data.get_uv_coords();
-  obj_parallel_chunked_output(fh, uv_coords.size(), [&](FormatHandler &buf, int i) {
-    const float2 &uv_vertex = uv_coords[i];
-    buf.write_obj_uv(uv_vertex[0], uv_vertex[1]);
-  });
+  fh.write_obj_uvs(uv_coords.slice(range));
 }
 
-void OBJWriter::write_normals(FormatHandler &fh, OBJMesh &obj_mesh_data)
+void OBJWriter::write_normals(FormatHandler &fh, OBJMesh &obj_mesh_data, const IndexRange range)
 {
   /* Poly normals should be calculated earlier via store_normal_coords_and_indices. */
   const Span<float3> normal_coords = obj_mesh_data.get_normal_coords();
-  obj_parallel_chunked_output(fh, normal_coords.size(), [&](FormatHandler &buf, int i) {
-    const float3 &normal = normal_coords[i];
-    buf.write_obj_normal(normal[0], normal[1], normal[2]);
-  });
+  fh.write_obj_normals(normal_coords.slice(range));
 }
 
 OBJWriter::func_vert_uv_normal_indices OBJWriter::get_face_element_writer(
@@ -363,19 +308,19 @@ static int get_smooth_group(const OBJMesh &mesh, const OBJExportParams &params,
 void OBJWriter::write_face_elements(FormatHandler &fh,
                                     const IndexOffsets &offsets,
                                     const OBJMesh &obj_mesh_data,
-                                    FunctionRef<const char *(int)> matname_fn)
+                                    FunctionRef<const char *(int)> matname_fn,
+                                    const IndexRange range)
 {
   const func_vert_uv_normal_indices face_element_writer = get_face_element_writer(
       obj_mesh_data.tot_uv_vertices());
 
-  const int tot_faces = obj_mesh_data.tot_faces();
   const int tot_deform_groups = obj_mesh_data.tot_deform_groups();
-  threading::EnumerableThreadSpecific<Vector<float>> group_weights;
+  Vector<float> group_weights;
   const bke::AttributeAccessor attributes = obj_mesh_data.get_mesh()->attributes();
   const VArray<int> material_indices = *attributes.lookup_or_default<int>(
       "material_index", bke::AttrDomain::Face, 0);
 
-  obj_parallel_chunked_output(fh, tot_faces, [&](FormatHandler &buf, int idx) {
+  for (const int idx : range) {
     /* Polygon order for writing into the file is not necessarily the same
      * as order in the mesh; it will be sorted by material indices. Remap current
      * and previous indices here according to the order. */
@@ -391,21 +336,20 @@ void OBJWriter::write_face_elements(FormatHandler &fh,
       const int prev_group = get_smooth_group(obj_mesh_data, export_params_, prev_i);
       const int group = get_smooth_group(obj_mesh_data, export_params_, i);
       if (group != prev_group) {
-        buf.write_obj_smooth(group);
+        fh.write_obj_smooth(group);
       }
     }
 
     /* Write vertex group if different from previous. */
     if (export_params_.export_vertex_groups) {
-      Vector<float> &local_weights = group_weights.local();
-      local_weights.resize(tot_deform_groups);
+      group_weights.resize(tot_deform_groups);
       const int16_t prev_group = idx == 0 ? NEGATIVE_INIT :
                                             obj_mesh_data.get_face_deform_group_index(
-                                                prev_i, local_weights);
-      const int16_t group = obj_mesh_data.get_face_deform_group_index(i, local_weights);
+                                                prev_i, group_weights);
+      const int16_t group = obj_mesh_data.get_face_deform_group_index(i, group_weights);
       if (group != prev_group) {
-        buf.write_obj_group(group == NOT_FOUND ? DEFORM_GROUP_DISABLED :
-                                                 obj_mesh_data.get_face_deform_group_name(group));
+        fh.write_obj_group(group == NOT_FOUND ? DEFORM_GROUP_DISABLED :
+                                                obj_mesh_data.get_face_deform_group_name(group));
       }
     }
 
@@ -418,7 +362,7 @@ void OBJWriter::write_face_elements(FormatHandler &fh,
       if (mat != prev_mat) {
         if (mat == NOT_FOUND) {
           if (export_params_.export_materials) {
-            buf.write_obj_usemtl(MATERIAL_GROUP_DISABLED);
+            fh.write_obj_usemtl(MATERIAL_GROUP_DISABLED);
           }
         }
         else {
@@ -429,23 +373,23 @@ void OBJWriter::write_face_elements(FormatHandler &fh,
           if (export_params_.export_material_groups) {
             std::string object_name = obj_mesh_data.get_object_name();
             spaces_to_underscores(object_name);
-            buf.write_obj_group(object_name + "_" + mat_name);
+            fh.write_obj_group(object_name + "_" + mat_name);
           }
           if (export_params_.export_materials) {
-            buf.write_obj_usemtl(mat_name);
+            fh.write_obj_usemtl(mat_name);
           }
         }
       }
     }
 
     /* Write face elements. */
-    (this->*face_element_writer)(buf,
+    (this->*face_element_writer)(fh,
                                  offsets,
                                  face_vertex_indices,
                                  face_uv_indices,
                                  face_normal_indices,
                                  obj_mesh_data.is_mirrored_transform());
-  });
+  }
 }
 
 void OBJWriter::write_edges_indices(FormatHandler &fh,
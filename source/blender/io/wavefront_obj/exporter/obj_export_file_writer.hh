@@ -60,32 +60,35 @@ class OBJWriter : NonMovable, NonCopyable {
    */
   void write_mtllib_name(StringRefNull mtl_filepath) const;
   /**
-   * Write vertex coordinates for all vertices as "v x y z" or "v x y z r g b".
+   * Write vertex coordinates for vertices in the range as "v x y z" or "v x y z r g b".
    */
   void write_vertex_coords(FormatHandler &fh,
                            const OBJMesh &obj_mesh_data,
-                           bool write_colors) const;
+                           bool write_colors,
+                           IndexRange range) const;
   /**
-   * Write UV vertex coordinates for all vertices as `vt u v`.
+   * Write UV vertex coordinates for UV vertices in the range as `vt u v`.
    * \note UV indices are stored here, but written with faces later.
    */
-  void write_uv_coords(FormatHandler &fh, OBJMesh &obj_mesh_data) const;
+  void write_uv_coords(FormatHandler &fh, OBJMesh &obj_mesh_data, IndexRange range) const;
   /**
    * Write corner normals for smooth-shaded faces, and face normals otherwise, as "vn x y z".
    * \note Normal indices ares stored here, but written with faces later.
    */
-  void write_normals(FormatHandler &fh, OBJMesh &obj_mesh_data);
+  void write_normals(FormatHandler &fh, OBJMesh &obj_mesh_data, IndexRange range);
   /**
    * Write face elements with at least vertex indices, and conditionally with UV vertex
    * indices and face normal indices. Also write groups: smooth, vertex, material.
    * The matname_fn turns a 0-indexed material slot number in an Object into the
-   * name used in the `.obj` file.
+   * name used in the `.obj` file. The range is in the order of writing, see
+   * #OBJMesh::remap_face_index.
    * \note UV indices were stored while writing UV vertices.
    */
   void write_face_elements(FormatHandler &fh,
                            const IndexOffsets &offsets,
                            const OBJMesh &obj_mesh_data,
-                           FunctionRef<const char *(int)> matname_fn);
+                           FunctionRef<const char *(int)> matname_fn,
+                           IndexRange range);
   /**
    * Write loose edges of a mesh as "l v1 v2".
    */
@@ -8,12 +8,18 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdio>
+#include <initializer_list>
 
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_string_ref.hh"
 #include "BLI_utility_mixins.hh"
 #include "BLI_vector.hh"
 
+#include "IO_number_format.hh"
+
 /* SEP macro from BLI path utils clashes with SEP symbol in fmt headers. */
 #undef SEP
 #include <fmt/format.h>
@@ -68,19 +74,34 @@ class FormatHandler : NonCopyable, NonMovable {
 
   void write_obj_vertex(float x, float y, float z)
   {
-    write_impl("v {:.6f} {:.6f} {:.6f}\n", x, y, z);
+    write_direct(2 + 3 * (format_number_max_len + 1), [&](char *p) {
+      *p++ = 'v';
+      p = write_fixed_values(p, {x, y, z}, 6);
+      *p++ = '\n';
+      return p;
+    });
   }
   void write_obj_vertex_color(float x, float y, float z, float r, float g, float b)
   {
-    write_impl("v {:.6f} {:.6f} {:.6f} {:.4f} {:.4f} {:.4f}\n", x, y, z, r, g, b);
+    write_direct(2 + 6 * (format_number_max_len + 1), [&](char *p) {
+      *p++ = 'v';
+      p = write_fixed_values(p, {x, y, z}, 6);
+      p = write_fixed_values(p, {r, g, b}, 4);
+      *p++ = '\n';
+      return p;
+    });
   }
-  void write_obj_uv(float x, float y)
+  void write_obj_uvs(Span<float2> uvs)
   {
-    write_impl("vt {:.6f} {:.6f}\n", x, y);
+    write_lines(uvs, [&](char *p, Span<float2> lines_uvs) {
+      return format_fixed_lines(p, "vt", lines_uvs, 6);
+    });
   }
-  void write_obj_normal(float x, float y, float z)
+  void write_obj_normals(Span<float3> normals)
   {
-    write_impl("vn {:.4f} {:.4f} {:.4f}\n", x, y, z);
+    write_lines(normals, [&](char *p, Span<float3> lines_normals) {
+      return format_fixed_lines(p, "vn", lines_normals, 4);
+    });
   }
   void write_obj_face_begin()
   {
@@ -92,19 +113,40 @@ class FormatHandler : NonCopyable, NonMovable {
   }
   void write_obj_face_v_uv_normal(int v, int uv, int n)
   {
-    write_impl(" {}/{}/{}", v, uv, n);
+    write_direct(4 + 3 * format_number_max_len, [&](char *p) {
+      *p++ = ' ';
+      p = format_int(p, v);
+      *p++ = '/';
+      p = format_int(p, uv);
+      *p++ = '/';
+      return format_int(p, n);
+    });
   }
   void write_obj_face_v_normal(int v, int n)
   {
-    write_impl(" {}//{}", v, n);
+    write_direct(4 + 2 * format_number_max_len, [&](char *p) {
+      *p++ = ' ';
+      p = format_int(p, v);
+      *p++ = '/';
+      *p++ = '/';
+      return format_int(p, n);
+    });
   }
   void write_obj_face_v_uv(int v, int uv)
   {
-    write_impl(" {}/{}", v, uv);
+    write_direct(2 + 2 * format_number_max_len, [&](char *p) {
+      *p++ = ' ';
+      p = format_int(p, v);
+      *p++ = '/';
+      return format_int(p, uv);
+    });
   }
   void write_obj_face_v(int v)
   {
-    write_impl(" {}", v);
+    write_direct(1 + format_number_max_len, [&](char *p) {
+      *p++ = ' ';
+      return format_int(p, v);
+    });
   }
   void write_obj_usemtl(StringRef s)
   {
@@ -128,7 +170,15 @@ class FormatHandler : NonCopyable, NonMovable {
   }
   void write_obj_edge(int a, int b)
   {
-    write_impl("l {} {}\n", a, b);
+    write_direct(4 + 2 * format_number_max_len, [&](char *p) {
+      *p++ = 'l';
+      *p++ = ' ';
+      p = format_int(p, a);
+      *p++ = ' ';
+      p = format_int(p, b);
+      *p++ = '\n';
+      return p;
+    });
   }
   void write_obj_cstype()
   {
@@ -205,6 +255,43 @@ class FormatHandler : NonCopyable, NonMovable {
     }
   }
 
+  /* Write at most `max_len` characters with `fn`, which formats them into the given memory and
+   * returns their end. Used with the number formatting of #IO_number_format.hh, which is much
+   * faster than `fmt` for the fixed precisions of OBJ files. */
+  template<typename Fn> void write_direct(int64_t max_len, const Fn &fn)
+  {
+    ensure_space(max_len);
+    VectorChar &bb = blocks_.last();
+    char *end = fn(bb.end());
+    bb.increase_size_by_unchecked(end - bb.end());
+  }
+
+  /* Write a line for every item with #write_direct, a limited number of lines at a time. The space
+   * reserved for the worst case line length is kept to a small part of the block size, otherwise
+   * new blocks would be started while much of the previous block is still unused. */
+  template<typename T, typename Fn> void write_lines(Span<T> items, const Fn &fn)
+  {
+    constexpr int64_t max_line_len = 3 + T::type_length * (format_number_max_len + 1);
+    const int64_t lines_num = std::max<int64_t>(1, buffer_chunk_size_ / 16 / max_line_len);
+    for (int64_t start = 0; start < items.size(); start += lines_num) {
+      const Span<T> lines_items = items.slice(start, std::min(lines_num, items.size() - start));
+      write_direct(lines_items.size() * max_line_len,
+                   [&](char *p) { return fn(p, lines_items); });
+    }
+  }
+
+  /* Write the values, each preceded by a space, in fixed-point notation. */
+  static char *write_fixed_values(char *p,
+                                  const std::initializer_list<float> values,
+                                  const int precision)
+  {
+    for (const float value : values) {
+      *p++ = ' ';
+      p = format_fixed(p, value, precision);
+    }
+    return p;
+  }
+
   template<typename... T> void write_impl(fmt::format_string<T...> fmt, T &&...args)
   {
     /* Format into a local buffer. */
@@ -23,6 +23,8 @@
 #include "BLI_task.hh"
 #include "BLI_vector.hh"
 
+#include "IO_chunked_write.hh"
+
 #include "DEG_depsgraph_query.hh"
 
 #include "DNA_collection_types.h"
@@ -158,16 +160,35 @@ filter_supported_objects(Depsgraph *depsgraph, const OBJExportParams &export_par
   return {std::move(r_exportable_meshes), std::move(r_exportable_nurbs)};
 }
 
+/* Split up large meshes into multi-threaded jobs; each job writes this amount of items. */
+static const int chunk_size = 32768;
+/* Rough size of a formatted chunk, used to fit the chunk buffers into the memory budget. */
+static const int64_t chunk_bytes = int64_t(chunk_size) * 40;
+
+/* Part of the output of an object, which is formatted independently from the other parts. */
+struct ObjectChunk {
+  enum class Type : int8_t { Name, Vertices, Normals, UVs, Faces, Edges };
+  int object;
+  Type type;
+  IndexRange range;
+};
+
+static void append_object_chunks(Vector<ObjectChunk> &r_chunks,
+                                 const int object,
+                                 const ObjectChunk::Type type,
+                                 const int items_num)
+{
+  for (int start = 0; start < items_num; start += chunk_size) {
+    r_chunks.append({object, type, IndexRange(start, std::min(chunk_size, items_num - start))});
+  }
+}
+
 static void write_mesh_objects(const Span<std::unique_ptr<OBJMesh>> exportable_as_mesh,
                                OBJWriter &obj_writer,
                                MTLWriter *mtl_writer,
                                const OBJExportParams &export_params)
 {
-  /* Parallelization is over meshes/objects, which means
-   * we have to have the output text buffer for each object,
-   * and write them all into the file at the end. */
   size_t count = exportable_as_mesh.size();
-  Array<FormatHandler> buffers(count);
 
   /* Serial: gather material indices, ensure normals & edges. */
   Vector<Vector<int>> mtlindices;
@@ -184,7 +205,8 @@ static void write_mesh_objects(const Span<std::unique_ptr<OBJMesh>> exportable_a
     }
   }
 
-  /* Parallel over meshes: store normal coords & indices, uv coords and indices. */
+  /* Parallel over meshes: store normal coords & indices, uv coords and indices,
+   * smooth groups and face order. */
   threading::parallel_for(IndexRange(count), 1, [&](IndexRange range) {
     for (const int i : range) {
       OBJMesh &obj = *exportable_as_mesh[i];
@@ -194,68 +216,102 @@ static void write_mesh_objects(const Span<std::unique_ptr<OBJMesh>> exportable_a
       if (export_params.export_uv) {
         obj.store_uv_coords_and_indices();
       }
+      if (obj.tot_faces() > 0) {
+        if (export_params.export_smooth_groups) {
+          obj.calc_smooth_groups(export_params.smooth_groups_bitflags);
+        }
+        if (export_params.export_materials) {
+          obj.calc_face_order();
+        }
+      }
     }
   });
 
   /* Serial: calculate index offsets; these are sequentially added
-   * over all meshes, and requite normal/uv indices to be calculated. */
+   * over all meshes, and requite normal/uv indices to be calculated.
+   * Also split the output of all meshes into chunks. */
   Vector<IndexOffsets> index_offsets;
   index_offsets.reserve(count);
   IndexOffsets offsets{0, 0, 0};
-  for (const auto &obj_mesh : exportable_as_mesh) {
-    OBJMesh &obj = *obj_mesh;
+  Vector<ObjectChunk> chunks;
+  for (const int i : IndexRange(count)) {
+    OBJMesh &obj = *exportable_as_mesh[i];
     index_offsets.append(offsets);
     offsets.vertex_offset += obj.tot_vertices();
     offsets.uv_vertex_offset += obj.tot_uv_vertices();
     offsets.normal_offset += obj.get_normal_coords().size();
-  }
-
-  /* Parallel over meshes: main result writing. */
-  threading::parallel_for(IndexRange(count), 1, [&](IndexRange range) {
-    for (const int i : range) {
-      OBJMesh &obj = *exportable_as_mesh[i];
-      auto &fh = buffers[i];
-
-      obj_writer.write_object_name(fh, obj);
-      obj_writer.write_vertex_coords(fh, obj, export_params.export_colors);
 
-      if (obj.tot_faces() > 0) {
-        if (export_params.export_smooth_groups) {
-          obj.calc_smooth_groups(export_params.smooth_groups_bitflags);
-        }
-        if (export_params.export_materials) {
-          obj.calc_face_order();
-        }
-        if (export_params.export_normals) {
-          obj_writer.write_normals(fh, obj);
-        }
-        if (export_params.export_uv) {
-          obj_writer.write_uv_coords(fh, obj);
-        }
-        /* This function takes a 0-indexed slot index for the obj_mesh object and
-         * returns the material name that we are using in the `.obj` file for it. */
-        const auto *obj_mtlindices = mtlindices.is_empty() ? nullptr : &mtlindices[i];
-        auto matname_fn = [&](int s) -> const char * {
-          if (!obj_mtlindices || s < 0 || s >= obj_mtlindices->size()) {
-            return nullptr;
-          }
-          return mtl_writer->mtlmaterial_name((*obj_mtlindices)[s]);
-        };
-        obj_writer.write_face_elements(fh, index_offsets[i], obj, matname_fn);
+    chunks.append({i, ObjectChunk::Type::Name, {}});
+    append_object_chunks(chunks, i, ObjectChunk::Type::Vertices, obj.tot_vertices());
+    if (obj.tot_faces() > 0) {
+      if (export_params.export_normals) {
+        const int normals_num = obj.get_normal_coords().size();
+        append_object_chunks(chunks, i, ObjectChunk::Type::Normals, normals_num);
       }
-      obj_writer.write_edges_indices(fh, index_offsets[i], obj);
-
-      /* Nothing will need this object's data after this point, release
-       * various arrays here. */
-      obj.clear();
+      if (export_params.export_uv) {
+        const int uvs_num = obj.get_uv_coords().size();
+        append_object_chunks(chunks, i, ObjectChunk::Type::UVs, uvs_num);
+      }
+      append_object_chunks(chunks, i, ObjectChunk::Type::Faces, obj.tot_faces());
     }
-  });
+    chunks.append({i, ObjectChunk::Type::Edges, {}});
+  }
 
-  /* Write all the object text buffers into the output file. */
+  /* Parallel over chunks: main result writing. Only a limited number of formatted chunks is kept
+   * in memory, they are written into the file in order while later chunks are formatted. */
+  const int slots_num = chunked_write_slots_num(chunked_write_default_memory_budget, chunk_bytes);
+  Array<FormatHandler> buffers(slots_num);
+  Array<int64_t> buffer_chunks(slots_num);
   FILE *f = obj_writer.get_outfile();
-  for (auto &b : buffers) {
-    b.write_to_file(f);
-  }
+  parallel_chunked_write(
+      chunks.size(),
+      slots_num,
+      [&](const int64_t chunk_index, const int slot) {
+        const ObjectChunk &chunk = chunks[chunk_index];
+        const int i = chunk.object;
+        OBJMesh &obj = *exportable_as_mesh[i];
+        FormatHandler &fh = buffers[slot];
+        buffer_chunks[slot] = chunk_index;
+        switch (chunk.type) {
+          case ObjectChunk::Type::Name:
+            obj_writer.write_object_name(fh, obj);
+            break;
+          case ObjectChunk::Type::Vertices:
+            obj_writer.write_vertex_coords(fh, obj, export_params.export_colors, chunk.range);
+            break;
+          case ObjectChunk::Type::Normals:
+            obj_writer.write_normals(fh, obj, chunk.range);
+            break;
+          case ObjectChunk::Type::UVs:
+            obj_writer.write_uv_coords(fh, obj, chunk.range);
+            break;
+          case ObjectChunk::Type::Faces: {
+            /* This function takes a 0-indexed slot index for the obj_mesh object and
+             * returns the material name that we are using in the `.obj` file for it. */
+            const auto *obj_mtlindices = mtlindices.is_empty() ? nullptr : &mtlindices[i];
+            auto matname_fn = [&](int s) -> const char * {
+              if (!obj_mtlindices || s < 0 || s >= obj_mtlindices->size()) {
+                return nullptr;
+              }
+              return mtl_writer->mtlmaterial_name((*obj_mtlindices)[s]);
+            };
+            obj_writer.write_face_elements(fh, index_offsets[i], obj, matname_fn, chunk.range);
+            break;
+          }
+          case ObjectChunk::Type::Edges:
+            obj_writer.write_edges_indices(fh, index_offsets[i], obj);
+            break;
+        }
+      },
+      [&](const int slot) {
+        buffers[slot].write_to_file(f);
+        /* Nothing will need this object's data after its last chunk is written
+         * (all chunks before it have been formatted), release various arrays here. */
+        const ObjectChunk &chunk = chunks[buffer_chunks[slot]];
+        if (chunk.type == ObjectChunk::Type::Edges) {
+          exportable_as_mesh[chunk.object]->clear();
+        }
+      });
 }
 
 /**
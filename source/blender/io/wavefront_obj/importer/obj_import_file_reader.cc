@@ -15,6 +15,8 @@
 #include "BLI_math_vector_types.hh"
 #include "BLI_string.h"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
+#include "BLI_threads.h"
 #include "BLI_vector.hh"
 
 #include "IO_string_utils.hh"
@@ -32,6 +34,9 @@ namespace blender::io::obj {
 
 using std::string;
 
+/* Number of parallel parsing chunks read from the file at once. */
+static constexpr size_t parallel_chunks_per_read = 64;
+
 /**
  * Based on the properties of the given Geometry instance, create a new Geometry instance
  * or return the previous one.
@@ -206,25 +211,19 @@ static void geom_add_polyline(Geometry *geom,
   }
 }
 
-static void geom_add_polygon(Geometry *geom,
-                             const char *p,
-                             const char *end,
-                             const GlobalVertices &global_vertices,
-                             const int material_index,
-                             const int group_index,
-                             const bool shaded_smooth)
+/**
+ * Parse the corners of a face and append them to r_face_corners. The indices are transformed to
+ * non-negative and zero-based, and bounds-checked using the numbers of elements that have been
+ * read before. Vertex indices of corners that failed the check are set to -1.
+ * Returns whether the face is valid.
+ */
+static bool parse_face_corners(const char *p,
+                               const char *end,
+                               const int64_t vertices_num,
+                               const int64_t uv_vertices_num,
+                               const int64_t vert_normals_num,
+                               Vector<FaceCorner> &r_face_corners)
 {
-  FaceElem curr_face;
-  curr_face.shaded_smooth = shaded_smooth;
-  curr_face.material_index = material_index;
-  if (group_index >= 0) {
-    curr_face.vertex_group_index = group_index;
-    geom->has_vertex_groups_ = true;
-  }
-
-  const int orig_corners_size = geom->face_corners_.size();
-  curr_face.start_index_ = orig_corners_size;
-
   bool face_valid = true;
   p = drop_whitespace(p, end);
   while (p < end && face_valid) {
@@ -254,53 +253,94 @@ static void geom_add_polygon(Geometry *geom,
       }
     }
     /* Always keep stored indices non-negative and zero-based. */
-    corner.vert_index += corner.vert_index < 0 ? global_vertices.vertices.size() : -1;
-    if (corner.vert_index < 0 || corner.vert_index >= global_vertices.vertices.size()) {
+    corner.vert_index += corner.vert_index < 0 ? vertices_num : -1;
+    if (corner.vert_index < 0 || corner.vert_index >= vertices_num) {
       CLOG_WARN(&LOG,
                 "Invalid vertex index %i (valid range [0, %zu)), ignoring face",
                 corner.vert_index,
-                size_t(global_vertices.vertices.size()));
+                size_t(vertices_num));
+      corner.vert_index = -1;
       face_valid = false;
     }
-    else {
-      geom->track_vertex_index(corner.vert_index);
-    }
     /* Ignore UV index, if the geometry does not have any UVs (#103212). */
-    if (got_uv && !global_vertices.uv_vertices.is_empty()) {
-      corner.uv_vert_index += corner.uv_vert_index < 0 ? global_vertices.uv_vertices.size() : -1;
-      if (corner.uv_vert_index < 0 || corner.uv_vert_index >= global_vertices.uv_vertices.size()) {
+    if (got_uv && uv_vertices_num != 0) {
+      corner.uv_vert_index += corner.uv_vert_index < 0 ? uv_vertices_num : -1;
+      if (corner.uv_vert_index < 0 || corner.uv_vert_index >= uv_vertices_num) {
         CLOG_WARN(&LOG,
                   "Invalid UV index %i (valid range [0, %zu)), ignoring face",
                   corner.uv_vert_index,
-                  size_t(global_vertices.uv_vertices.size()));
+                  size_t(uv_vertices_num));
         face_valid = false;
       }
     }
     /* Ignore corner normal index, if the geometry does not have any normals.
      * Some obj files out there do have face definitions that refer to normal indices,
      * without any normals being present (#98782). */
-    if (got_normal && !global_vertices.vert_normals.is_empty()) {
-      corner.vertex_normal_index += corner.vertex_normal_index < 0 ?
-                                        global_vertices.vert_normals.size() :
-                                        -1;
-      if (corner.vertex_normal_index < 0 ||
-          corner.vertex_normal_index >= global_vertices.vert_normals.size())
-      {
+    if (got_normal && vert_normals_num != 0) {
+      corner.vertex_normal_index += corner.vertex_normal_index < 0 ? vert_normals_num : -1;
+      if (corner.vertex_normal_index < 0 || corner.vertex_normal_index >= vert_normals_num) {
         CLOG_WARN(&LOG,
                   "Invalid normal index %i (valid range [0, %zu)), ignoring face",
                   corner.vertex_normal_index,
-                  size_t(global_vertices.vert_normals.size()));
+                  size_t(vert_normals_num));
         face_valid = false;
       }
     }
-    geom->face_corners_.append(corner);
-    curr_face.corner_count_++;
+    r_face_corners.append(corner);
 
     /* Some files contain extra stuff per face (e.g. 4 indices); skip any remainder (#103441). */
     p = drop_non_whitespace(p, end);
     /* Skip whitespace to get to the next face corner. */
     p = drop_whitespace(p, end);
   }
+  return face_valid;
+}
+
+static FaceElem face_elem_from_state(Geometry *geom,
+                                     const int material_index,
+                                     const int group_index,
+                                     const bool shaded_smooth)
+{
+  FaceElem curr_face;
+  curr_face.shaded_smooth = shaded_smooth;
+  curr_face.material_index = material_index;
+  if (group_index >= 0) {
+    curr_face.vertex_group_index = group_index;
+    geom->has_vertex_groups_ = true;
+  }
+  curr_face.start_index_ = geom->face_corners_.size();
+  return curr_face;
+}
+
+/* Vertices used by the corners are tracked even when the face is invalid,
+ * so that they are still imported as loose vertices. */
+static void geom_track_face_vertices(Geometry *geom, const Span<FaceCorner> corners)
+{
+  for (const FaceCorner &corner : corners) {
+    if (corner.vert_index >= 0) {
+      geom->track_vertex_index(corner.vert_index);
+    }
+  }
+}
+
+static void geom_add_polygon(Geometry *geom,
+                             const char *p,
+                             const char *end,
+                             const GlobalVertices &global_vertices,
+                             const int material_index,
+                             const int group_index,
+                             const bool shaded_smooth)
+{
+  FaceElem curr_face = face_elem_from_state(geom, material_index, group_index, shaded_smooth);
+  const int orig_corners_size = geom->face_corners_.size();
+  const bool face_valid = parse_face_corners(p,
+                                             end,
+                                             global_vertices.vertices.size(),
+                                             global_vertices.uv_vertices.size(),
+                                             global_vertices.vert_normals.size(),
+                                             geom->face_corners_);
+  curr_face.corner_count_ = geom->face_corners_.size() - orig_corners_size;
+  geom_track_face_vertices(geom, geom->face_corners_.as_span().drop_front(orig_corners_size));
 
   if (face_valid) {
     geom->face_elements_.append(curr_face);
@@ -313,6 +353,31 @@ static void geom_add_polygon(Geometry *geom,
   }
 }
 
+/**
+ * Add a face parsed by #parse_face_corners into a separate array, see
+ * #OBJParser::parse_string_buffer_parallel.
+ */
+static void geom_add_parsed_polygon(Geometry *geom,
+                                    const Span<FaceCorner> corners,
+                                    const bool face_valid,
+                                    const int material_index,
+                                    const int group_index,
+                                    const bool shaded_smooth)
+{
+  FaceElem curr_face = face_elem_from_state(geom, material_index, group_index, shaded_smooth);
+  curr_face.corner_count_ = corners.size();
+  geom_track_face_vertices(geom, corners);
+
+  if (face_valid) {
+    geom->face_corners_.extend(corners);
+    geom->face_elements_.append(curr_face);
+    geom->total_corner_ += curr_face.corner_count_;
+  }
+  else {
+    geom->has_invalid_faces_ = true;
+  }
+}
+
 static Geometry *geom_set_curve_type(Geometry *geom,
                                      const char *p,
                                      const char *end,
@@ -425,8 +490,12 @@ static void geom_new_object(const char *p,
       r_curr_geom, GEOM_MESH, StringRef(p, end).trim(), r_all_geometries);
 }
 
-OBJParser::OBJParser(const OBJImportParams &import_params, size_t read_buffer_size)
-    : import_params_(import_params), read_buffer_size_(read_buffer_size)
+OBJParser::OBJParser(const OBJImportParams &import_params,
+                     size_t read_buffer_size,
+                     size_t parallel_chunk_size)
+    : import_params_(import_params),
+      read_buffer_size_(read_buffer_size),
+      parallel_chunk_size_(parallel_chunk_size)
 {
   obj_file_ = BLI_fopen(import_params_.filepath, "rb");
   if (!obj_file_) {
@@ -615,6 +684,241 @@ size_t OBJParser::parse_string_buffer(StringRef &buffer_str,
   return read_lines_num;
 }
 
+/** Number of lines and vertex elements in a chunk, or before it. */
+struct ChunkElementsNum {
+  int64_t lines = 0;
+  int64_t vertices = 0;
+  int64_t uv_vertices = 0;
+  int64_t vert_normals = 0;
+};
+
+struct ChunkFace {
+  int start;
+  int corners_num;
+  bool is_valid;
+};
+
+/**
+ * A run of faces, or a line that is handled by #OBJParser::parse_string_buffer once the state of
+ * the parser at that point of the file is known.
+ */
+struct ChunkItem {
+  /* Empty for runs of faces. */
+  StringRef line;
+  IndexRange faces;
+  /* Number of vertex positions in the chunk before this item. */
+  int64_t vertices_num;
+};
+
+struct ParsedChunk {
+  GlobalVertices vertices;
+  Vector<FaceCorner> face_corners;
+  Vector<ChunkFace> faces;
+  Vector<ChunkItem> items;
+};
+
+static ChunkElementsNum count_chunk_elements(StringRef chunk)
+{
+  ChunkElementsNum num;
+  while (!chunk.is_empty()) {
+    const StringRef line = read_next_line(chunk);
+    const char *p = line.begin(), *end = line.end();
+    p = drop_whitespace(p, end);
+    ++num.lines;
+    if (p == end || *p != 'v') {
+      continue;
+    }
+    if (parse_keyword(p, end, "v")) {
+      ++num.vertices;
+    }
+    else if (parse_keyword(p, end, "vn")) {
+      ++num.vert_normals;
+    }
+    else if (parse_keyword(p, end, "vt")) {
+      ++num.uv_vertices;
+    }
+  }
+  return num;
+}
+
+/**
+ * Parse vertex elements and faces of the chunk. The face indices are resolved using the numbers
+ * of elements before the chunk, everything else is deferred to #OBJParser::parse_string_buffer.
+ */
+static void parse_chunk(StringRef chunk, const ChunkElementsNum &offset, ParsedChunk &r_chunk)
+{
+  GlobalVertices &vertices = r_chunk.vertices;
+  while (!chunk.is_empty()) {
+    const StringRef line = read_next_line(chunk);
+    const char *p = line.begin(), *end = line.end();
+    p = drop_whitespace(p, end);
+    if (p == end) {
+      continue;
+    }
+    if (*p == 'v') {
+      if (parse_keyword(p, end, "v")) {
+        geom_add_vertex(p, end, vertices);
+      }
+      else if (parse_keyword(p, end, "vn")) {
+        geom_add_vertex_normal(p, end, vertices);
+      }
+      else if (parse_keyword(p, end, "vt")) {
+        geom_add_uv_vertex(p, end, vertices);
+      }
+    }
+    else if (parse_keyword(p, end, "f")) {
+      const int start = r_chunk.face_corners.size();
+      const bool is_valid = parse_face_corners(p,
+                                               end,
+                                               offset.vertices + vertices.vertices.size(),
+                                               offset.uv_vertices + vertices.uv_vertices.size(),
+                                               offset.vert_normals + vertices.vert_normals.size(),
+                                               r_chunk.face_corners);
+      if (r_chunk.items.is_empty() || r_chunk.items.last().faces.is_empty()) {
+        r_chunk.items.append({{}, IndexRange(r_chunk.faces.size(), 0), vertices.vertices.size()});
+      }
+      ChunkItem &run = r_chunk.items.last();
+      run.faces = IndexRange(run.faces.start(), run.faces.size() + 1);
+      r_chunk.faces.append({start, int(r_chunk.face_corners.size()) - start, is_valid});
+    }
+    else if (*p == '#' && !parse_keyword(p, end, "#MRGB")) {
+      /* Comments, nothing to do. */
+    }
+    else {
+      r_chunk.items.append({line, {}, vertices.vertices.size()});
+    }
+  }
+}
+
+/**
+ * Append vertex positions of a parsed chunk, with their colors and weights. Any pending #MRGB
+ * block is flushed first, like #geom_add_vertex does.
+ */
+static void append_chunk_vertices(GlobalVertices &r_global_vertices,
+                                  const GlobalVertices &chunk_vertices,
+                                  const IndexRange range)
+{
+  if (range.is_empty()) {
+    return;
+  }
+  r_global_vertices.flush_mrgb_block();
+  const int64_t offset = r_global_vertices.vertices.size() - range.start();
+  r_global_vertices.vertices.extend(chunk_vertices.vertices.as_span().slice(range));
+  if (!chunk_vertices.vertex_colors.is_empty()) {
+    for (const int64_t i : range) {
+      if (chunk_vertices.has_vertex_color(i)) {
+        r_global_vertices.set_vertex_color(offset + i, chunk_vertices.vertex_colors[i]);
+      }
+    }
+  }
+  for (const int64_t i : range.take_front(
+           std::max<int64_t>(chunk_vertices.vertex_weights.size() - range.start(), 0)))
+  {
+    r_global_vertices.set_vertex_weight(offset + i, chunk_vertices.vertex_weights[i]);
+  }
+}
+
+size_t OBJParser::parse_string_buffer_parallel(StringRef buffer_str,
+                                               Vector<std::unique_ptr<Geometry>> &r_all_geometries,
+                                               GlobalVertices &r_global_vertices,
+                                               Geometry *&curr_geom,
+                                               bool &state_shaded_smooth,
+                                               string &state_group_name,
+                                               int &state_group_index,
+                                               string &state_material_name,
+                                               int &state_material_index)
+{
+  /* Split the buffer into chunks ending at a line boundary. */
+  Vector<StringRef> chunks;
+  while (!buffer_str.is_empty()) {
+    const int64_t newline = buffer_str.find(
+        '\n', std::min<int64_t>(parallel_chunk_size_, buffer_str.size()) - 1);
+    const int64_t chunk_size = newline == StringRef::not_found ? buffer_str.size() : newline + 1;
+    chunks.append(buffer_str.substr(0, chunk_size));
+    buffer_str = buffer_str.drop_prefix(chunk_size);
+  }
+
+  /* First pass: count the elements of each chunk, and turn the counts into the numbers of
+   * elements before each chunk. */
+  Array<ChunkElementsNum> chunk_offsets(chunks.size());
+  threading::parallel_for(chunks.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      chunk_offsets[i] = count_chunk_elements(chunks[i]);
+    }
+  });
+  ChunkElementsNum offset;
+  offset.vertices = r_global_vertices.vertices.size();
+  offset.uv_vertices = r_global_vertices.uv_vertices.size();
+  offset.vert_normals = r_global_vertices.vert_normals.size();
+  for (ChunkElementsNum &num : chunk_offsets) {
+    const ChunkElementsNum chunk_num = num;
+    num = offset;
+    offset.lines += chunk_num.lines;
+    offset.vertices += chunk_num.vertices;
+    offset.uv_vertices += chunk_num.uv_vertices;
+    offset.vert_normals += chunk_num.vert_normals;
+  }
+
+  /* Second pass: parse the chunks. */
+  Array<ParsedChunk> parsed_chunks(chunks.size());
+  threading::parallel_for(chunks.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      parse_chunk(chunks[i], chunk_offsets[i], parsed_chunks[i]);
+    }
+  });
+
+  /* Stitch the chunks together in file order, applying the deferred lines. */
+  for (ParsedChunk &chunk : parsed_chunks) {
+    /* Deferred lines only depend on the number of vertex positions read so far. */
+    r_global_vertices.uv_vertices.extend(chunk.vertices.uv_vertices);
+    r_global_vertices.vert_normals.extend(chunk.vertices.vert_normals);
+
+    int64_t vertices_added = 0;
+    for (const ChunkItem &item : chunk.items) {
+      if (!item.faces.is_empty()) {
+        /* If we don't have a material index assigned yet, get one.
+         * It means "usemtl" state came from the previous object. */
+        if (state_material_index == -1 && !state_material_name.empty() &&
+            curr_geom->material_indices_.is_empty())
+        {
+          curr_geom->material_indices_.add_new(state_material_name, 0);
+          curr_geom->material_order_.append(state_material_name);
+          state_material_index = 0;
+        }
+        for (const ChunkFace &face : chunk.faces.as_span().slice(item.faces)) {
+          geom_add_parsed_polygon(curr_geom,
+                                  chunk.face_corners.as_span().slice(face.start, face.corners_num),
+                                  face.is_valid,
+                                  state_material_index,
+                                  state_group_index,
+                                  state_shaded_smooth);
+        }
+        continue;
+      }
+      append_chunk_vertices(r_global_vertices,
+                            chunk.vertices,
+                            IndexRange::from_begin_end(vertices_added, item.vertices_num));
+      vertices_added = item.vertices_num;
+
+      StringRef line = item.line;
+      parse_string_buffer(line,
+                          r_all_geometries,
+                          r_global_vertices,
+                          curr_geom,
+                          state_shaded_smooth,
+                          state_group_name,
+                          state_group_index,
+                          state_material_name,
+                          state_material_index);
+    }
+    append_chunk_vertices(
+        r_global_vertices,
+        chunk.vertices,
+        IndexRange::from_begin_end(vertices_added, chunk.vertices.vertices.size()));
+  }
+  return offset.lines;
+}
+
 void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
                       GlobalVertices &r_global_vertices)
 {
@@ -637,15 +941,24 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
   string state_material_name;
   int state_material_index = -1;
 
+  /* Large files are parsed in parallel. Read many chunks at once to keep all threads busy,
+   * while still bounding the memory usage for huge files. */
+  size_t read_size = read_buffer_size_;
+  const bool use_parallel = parallel_chunk_size_ > 0 && BLI_system_thread_count() > 1 &&
+                            BLI_file_size(import_params_.filepath) > parallel_chunk_size_;
+  if (use_parallel) {
+    read_size = std::max(read_buffer_size_, parallel_chunk_size_ * parallel_chunks_per_read);
+  }
+
   /* Read the input file in chunks. We need up to twice the possible chunk size,
    * to possibly store remainder of the previous input line that got broken mid-chunk. */
-  Array<char> buffer(read_buffer_size_ * 2);
+  Array<char> buffer(read_size * 2);
 
   size_t buffer_offset = 0;
   size_t line_number = 0;
   while (true) {
     /* Read a chunk of input from the file. */
-    size_t bytes_read = fread(buffer.data() + buffer_offset, 1, read_buffer_size_, obj_file_);
+    size_t bytes_read = fread(buffer.data() + buffer_offset, 1, read_size, obj_file_);
     if (bytes_read == 0 && buffer_offset == 0) {
       break; /* No more data to read. */
     }
@@ -656,7 +969,7 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
                              buffer.data() + buffer_offset + bytes_read);
 
     /* Ensure buffer ends in a newline. */
-    if (bytes_read < read_buffer_size_) {
+    if (bytes_read < read_size) {
       if (bytes_read == 0 || buffer[buffer_offset + bytes_read - 1] != '\n') {
         buffer[buffer_offset + bytes_read] = '\n';
         bytes_read++;
@@ -681,7 +994,7 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
       CLOG_ERROR(&LOG,
                  "OBJ file contains a line #%zu that is too long (max. length %zu)",
                  line_number,
-                 read_buffer_size_);
+                 read_size);
       break;
     }
     ++last_nl;
@@ -689,7 +1002,8 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
     /* Parse the buffer (until last newline) that we have so far,
      * line by line. */
     StringRef buffer_str{buffer.data(), int64_t(last_nl)};
-    line_number += OBJParser::parse_string_buffer(buffer_str,
+    if (use_parallel) {
+      line_number += parse_string_buffer_parallel(buffer_str,
                                                   r_all_geometries,
                                                   r_global_vertices,
                                                   curr_geom,
@@ -698,6 +1012,18 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
                                                   state_group_index,
                                                   state_material_name,
                                                   state_material_index);
+    }
+    else {
+      line_number += parse_string_buffer(buffer_str,
+                                         r_all_geometries,
+                                         r_global_vertices,
+                                         curr_geom,
+                                         state_shaded_smooth,
+                                         state_group_name,
+                                         state_group_index,
+                                         state_material_name,
+                                         state_material_index);
+    }
 
     /* We might have a line that was cut in the middle by the previous buffer;
      * copy it over for next chunk reading. */
@@ -27,12 +27,18 @@ class OBJParser {
   FILE *obj_file_;
   Vector<std::string> mtl_libraries_;
   size_t read_buffer_size_;
+  size_t parallel_chunk_size_;
 
  public:
   /**
    * Open OBJ file at the path given in import parameters.
+   *
+   * Files larger than \a parallel_chunk_size are split into chunks of about that size at line
+   * boundaries, which are parsed concurrently. Zero disables multi-threaded parsing.
    */
-  OBJParser(const OBJImportParams &import_params, size_t read_buffer_size);
+  OBJParser(const OBJImportParams &import_params,
+            size_t read_buffer_size,
+            size_t parallel_chunk_size = 1024 * 1024);
   ~OBJParser();
 
   /**
@@ -58,6 +64,21 @@ class OBJParser {
                              int &state_group_index,
                              std::string &state_material_name,
                              int &state_material_index);
+  /**
+   * Same as #parse_string_buffer, but splits the buffer into chunks which are parsed in two
+   * parallel passes. The first one counts the vertex elements in every chunk, so that the second
+   * one can resolve face indices into per-chunk buffers. Lines which change the parser state are
+   * deferred and applied in file order while the chunks are stitched together.
+   */
+  size_t parse_string_buffer_parallel(StringRef buffer_str,
+                                      Vector<std::unique_ptr<Geometry>> &r_all_geometries,
+                                      GlobalVertices &r_global_vertices,
+                                      Geometry *&curr_geom,
+                                      bool &state_shaded_smooth,
+                                      std::string &state_group_name,
+                                      int &state_group_index,
+                                      std::string &state_material_name,
+                                      int &state_material_index);
 };
 
 class MTLParser {
@@ -236,6 +236,35 @@ parm u 0.000000
   ASSERT_EQ(got_string, expected);
 }
 
+TEST(obj_exporter_writer, format_handler_numbers)
+{
+  FormatHandler h(16);
+  h.write_obj_vertex(1.0f, -0.5f, 1234.56789f);
+  h.write_obj_vertex_color(0.0f, -0.0f, 1e-7f, 0.25f, 1.0f, 0.33333f);
+  const float2 uvs[] = {{0.5f, 0.125f}, {1.0f, 0.0f}};
+  h.write_obj_uvs(Span<float2>(uvs, 2));
+  const float3 normals[] = {{0.0f, 0.0f, -1.0f}, {0.70711f, 0.70711f, 0.0f}};
+  h.write_obj_normals(Span<float3>(normals, 2));
+  h.write_obj_face_begin();
+  h.write_obj_face_v_uv_normal(1, 2, 3);
+  h.write_obj_face_v_normal(10, 20);
+  h.write_obj_face_v_uv(-1, -2);
+  h.write_obj_face_v(123456);
+  h.write_obj_face_end();
+  h.write_obj_edge(7, 2147483647);
+
+  const char *expected = R"(v 1.000000 -0.500000 1234.567871
+v 0.000000 -0.000000 0.000000 0.2500 1.0000 0.3333
+vt 0.500000 0.125000
+vt 1.000000 0.000000
+vn 0.0000 0.0000 -1.0000
+vn 0.7071 0.7071 0.0000
+f 1/2/3 10//20 -1/-2 123456
+l 7 2147483647
+)";
+  ASSERT_EQ(h.get_as_string(), expected);
+}
+
 /* Return true if string #a and string #b are equal after their first newline. */
 static bool strings_equal_after_first_lines(const std::string &a, const std::string &b)
 {
@@ -6,7 +6,11 @@
 
 #include "testing/testing.h"
 
+#include "BLI_fileops.h"
 #include "BLI_string.h"
+#include "BLI_timeit.hh"
+
+#include "BKE_appdir.hh"
 
 #include "CLG_log.h"
 
@@ -16,7 +20,8 @@ namespace blender::io::obj {
 
 /* Extensive tests for OBJ importing are in `io_obj_import_test.py`.
  * The tests here are only for testing OBJ reader buffer refill behavior,
- * by using a very small buffer size on purpose. */
+ * by using a very small buffer size on purpose, and for comparing the
+ * multi-threaded parser against the single-threaded one. */
 
 TEST(obj_import, BufferRefillTest)
 {
@@ -45,4 +50,161 @@ TEST(obj_import, BufferRefillTest)
   CLG_exit();
 }
 
+/**
+ * Write an OBJ file with \a objects_num grid objects, using everything that carries parser state
+ * from one line to the next: objects, groups, materials, smooth groups, relative indices, vertex
+ * colors and weights, polylines and invalid faces.
+ */
+static void write_synthetic_obj(const char *filepath, const int objects_num, const int grid_size)
+{
+  FILE *file = BLI_fopen(filepath, "wb");
+  ASSERT_NE(file, nullptr);
+  fprintf(file, "# Synthetic OBJ file\nmtllib synthetic.mtl\n");
+  int vertices_num = 0;
+  for (int object = 0; object < objects_num; object++) {
+    const bool use_relative_indices = object % 2 == 1;
+    fprintf(file, "o Object_%d\n", object);
+    const int first_vertex = vertices_num + 1;
+    for (int y = 0; y <= grid_size; y++) {
+      for (int x = 0; x <= grid_size; x++) {
+        fprintf(file, "v %d.25 %d.5 %d.125", x, y, object);
+        if (object % 3 == 1) {
+          fprintf(file, " %.3f %.3f 0.5", float(x) / grid_size, float(y) / grid_size);
+        }
+        else if (object % 5 == 2 && x == y) {
+          fprintf(file, " 0.75");
+        }
+        fprintf(file, "\n");
+        fprintf(file, "vt %.4f %.4f\nvn 0 0 1\n", float(x) / grid_size, float(y) / grid_size);
+        vertices_num++;
+      }
+    }
+    if (object % 7 == 3) {
+      fprintf(file, "#MRGB ff102030ff405060\n");
+    }
+    fprintf(file, "usemtl Material_%d\ns %s\n", object % 3, object % 2 ? "off" : "1");
+    for (int y = 0; y < grid_size; y++) {
+      fprintf(file, "g Row_%d\n", y % 4);
+      for (int x = 0; x < grid_size; x++) {
+        const int corners[4] = {first_vertex + y * (grid_size + 1) + x,
+                                first_vertex + y * (grid_size + 1) + x + 1,
+                                first_vertex + (y + 1) * (grid_size + 1) + x + 1,
+                                first_vertex + (y + 1) * (grid_size + 1) + x};
+        fprintf(file, "f");
+        for (const int corner : corners) {
+          const int index = use_relative_indices ? corner - vertices_num - 1 : corner;
+          fprintf(file, " %d/%d/%d", index, index, index);
+        }
+        fprintf(file, "\n");
+      }
+    }
+    fprintf(file, "l %d %d\n", first_vertex, first_vertex + grid_size);
+    if (object % 10 == 5) {
+      fprintf(file, "f 1 2 %d\n", vertices_num + 10);
+    }
+  }
+  fclose(file);
+}
+
+static void expect_equal_geometries(const Geometry &a, const Geometry &b)
+{
+  EXPECT_EQ(a.geom_type_, b.geom_type_);
+  EXPECT_EQ(a.geometry_name_, b.geometry_name_);
+  EXPECT_EQ_SPAN<std::string>(a.group_order_, b.group_order_);
+  EXPECT_EQ_SPAN<std::string>(a.material_order_, b.material_order_);
+  EXPECT_EQ(a.vertex_index_min_, b.vertex_index_min_);
+  EXPECT_EQ(a.vertex_index_max_, b.vertex_index_max_);
+  EXPECT_EQ(a.vertices_.size(), b.vertices_.size());
+  for (const int vertex : a.vertices_) {
+    EXPECT_TRUE(b.vertices_.contains(vertex));
+  }
+  EXPECT_EQ_SPAN<int2>(a.edges_, b.edges_);
+  ASSERT_EQ(a.face_corners_.size(), b.face_corners_.size());
+  for (const int i : a.face_corners_.index_range()) {
+    EXPECT_EQ(a.face_corners_[i].vert_index, b.face_corners_[i].vert_index);
+    EXPECT_EQ(a.face_corners_[i].uv_vert_index, b.face_corners_[i].uv_vert_index);
+    EXPECT_EQ(a.face_corners_[i].vertex_normal_index, b.face_corners_[i].vertex_normal_index);
+  }
+  ASSERT_EQ(a.face_elements_.size(), b.face_elements_.size());
+  for (const int i : a.face_elements_.index_range()) {
+    EXPECT_EQ(a.face_elements_[i].vertex_group_index, b.face_elements_[i].vertex_group_index);
+    EXPECT_EQ(a.face_elements_[i].material_index, b.face_elements_[i].material_index);
+    EXPECT_EQ(a.face_elements_[i].shaded_smooth, b.face_elements_[i].shaded_smooth);
+    EXPECT_EQ(a.face_elements_[i].start_index_, b.face_elements_[i].start_index_);
+    EXPECT_EQ(a.face_elements_[i].corner_count_, b.face_elements_[i].corner_count_);
+  }
+  EXPECT_EQ(a.has_invalid_faces_, b.has_invalid_faces_);
+  EXPECT_EQ(a.has_vertex_groups_, b.has_vertex_groups_);
+  EXPECT_EQ(a.total_corner_, b.total_corner_);
+}
+
+TEST(obj_import, ParallelParseTest)
+{
+  CLG_init();
+  BKE_tempdir_init(nullptr);
+
+  OBJImportParams params;
+  const std::string obj_path = std::string(BKE_tempdir_base()) + "parallel_parse.obj";
+  STRNCPY(params.filepath, obj_path.c_str());
+  write_synthetic_obj(params.filepath, 40, 24);
+
+  Vector<std::unique_ptr<Geometry>> serial_geometries;
+  GlobalVertices serial_vertices;
+  OBJParser serial_parser{params, 64 * 1024, 0};
+  serial_parser.parse(serial_geometries, serial_vertices);
+
+  /* Use a small chunk size, so that the file is split into many chunks and read buffers. */
+  Vector<std::unique_ptr<Geometry>> parallel_geometries;
+  GlobalVertices parallel_vertices;
+  OBJParser parallel_parser{params, 64 * 1024, 1000};
+  parallel_parser.parse(parallel_geometries, parallel_vertices);
+
+  EXPECT_EQ(40, serial_geometries.size());
+  EXPECT_EQ(40 * 25 * 25, serial_vertices.vertices.size());
+  EXPECT_FALSE(serial_vertices.vertex_colors.is_empty());
+  EXPECT_FALSE(serial_vertices.vertex_weights.is_empty());
+  EXPECT_EQ_SPAN<std::string>(serial_parser.mtl_libraries(), parallel_parser.mtl_libraries());
+
+  EXPECT_EQ_SPAN<float3>(serial_vertices.vertices, parallel_vertices.vertices);
+  EXPECT_EQ_SPAN<float2>(serial_vertices.uv_vertices, parallel_vertices.uv_vertices);
+  EXPECT_EQ_SPAN<float3>(serial_vertices.vert_normals, parallel_vertices.vert_normals);
+  EXPECT_EQ_SPAN<float3>(serial_vertices.vertex_colors, parallel_vertices.vertex_colors);
+  EXPECT_EQ_SPAN<float>(serial_vertices.vertex_weights, parallel_vertices.vertex_weights);
+  ASSERT_EQ(serial_geometries.size(), parallel_geometries.size());
+  for (const int i : serial_geometries.index_range()) {
+    expect_equal_geometries(*serial_geometries[i], *parallel_geometries[i]);
+  }
+
+  BLI_delete(params.filepath, false, false);
+  CLG_exit();
+}
+
+#if 0
+/* Compare single- and multi-threaded parsing of a synthetic file of several gigabytes. */
+TEST(obj_import, ParallelParseBenchmark)
+{
+  CLG_init();
+  BKE_tempdir_init(nullptr);
+
+  OBJImportParams params;
+  const std::string obj_path = std::string(BKE_tempdir_base()) + "parallel_parse_benchmark.obj";
+  STRNCPY(params.filepath, obj_path.c_str());
+  write_synthetic_obj(params.filepath, 200, 1000);
+  std::cout << "File size: " << BLI_file_size(params.filepath) / (1024 * 1024) << " MiB\n";
+
+  for (const size_t parallel_chunk_size : {size_t(0), size_t(1024 * 1024)}) {
+    Vector<std::unique_ptr<Geometry>> all_geometries;
+    GlobalVertices global_vertices;
+    OBJParser obj_parser{params, 256 * 1024, parallel_chunk_size};
+    {
+      SCOPED_TIMER(parallel_chunk_size ? "Parse multi-threaded" : "Parse single-threaded");
+      obj_parser.parse(all_geometries, global_vertices);
+    }
+  }
+
+  BLI_delete(params.filepath, false, false);
+  CLG_exit();
+}
+#endif
+
 }  // namespace blender::io::obj
@@ -145,6 +145,8 @@ const char *DNA_struct_get_compareflags(const struct SDNA *oldsdna, const struct
  * \param old_blocks: Array of struct data.
  * \param alloc_name: String to pass to the allocation calls for reconstructed data.
  * \return An allocated reconstructed struct.
+ *
+ * \note \a reconstruct_info is not modified, so this can be called from multiple threads.
  */
 void *DNA_struct_reconstruct(const struct DNA_ReconstructInfo *reconstruct_info,
                              int old_struct_index,
@@ -234,6 +234,9 @@ typedef struct UserDef_Experimental {
   char write_legacy_blend_file_format;
   char no_data_block_packing;
   char use_paint_debug;
+  char use_blend_file_mmap;
+  char use_autosave_journal;
+  char use_depsgraph_critical_path_scheduling;
   char SANITIZE_AFTER_HERE;
   /* The following options are automatically sanitized (set to 0)
    * when the release cycle is not alpha. */
@@ -242,7 +245,7 @@ typedef struct UserDef_Experimental {
   char use_sculpt_texture_paint;
   char use_shader_node_previews;
   char use_geometry_nodes_lists;
-  char _pad[5];
+  char _pad[2];
 } UserDef_Experimental;
 
 #define USER_EXPERIMENTAL_TEST(userdef, member) (((userdef)->experimental).member)
@@ -7539,6 +7539,30 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
   RNA_def_property_flag(prop, PROP_CONTEXT_UPDATE);
   RNA_def_property_update(prop, 0, "rna_experimental_no_data_block_packing_update");
 
+  prop = RNA_def_property(srna, "use_blend_file_mmap", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_ui_text(
+      prop,
+      "Memory-Mapped Blend File Reading",
+      "Share large arrays (like mesh attributes and packed files) of uncompressed blend-files "
+      "with the file on disk instead of copying them into memory when loading. The file must "
+      "not be truncated or modified in place while the data is in use. Not supported on "
+      "Windows");
+
+  prop = RNA_def_property(srna, "use_autosave_journal", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_ui_text(
+      prop,
+      "Incremental Auto Save",
+      "Auto-save only the data-blocks that changed since the previous auto-save, appending them "
+      "to a journal file next to the regular auto-save file in the background. Recover Auto Save "
+      "restores the blend-file from the journal");
+
+  prop = RNA_def_property(srna, "use_depsgraph_critical_path_scheduling", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_ui_text(
+      prop,
+      "Critical Path Scheduling",
+      "Evaluate dependency graph operations which have the longest chain of operations depending "
+      "on them first, based on the timing of the previous evaluation");
+
   prop = RNA_def_property(srna, "use_all_linked_data_direct", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_ui_text(
       prop,
@@ -133,22 +133,25 @@ static void raycast_to_mesh(const IndexMask &mask,
     return;
   }
 
-  mask.foreach_index([&](const int i) {
-    const float ray_length = ray_lengths[i];
-    const float3 ray_origin = ray_origins[i];
-    const float3 ray_direction = ray_directions[i];
-
-    BVHTreeRayHit hit;
-    hit.index = -1;
-    hit.dist = ray_length;
-    if (BLI_bvhtree_ray_cast(tree_data.tree,
-                             ray_origin,
-                             ray_direction,
+  const VArraySpan<float3> origins_span(ray_origins);
+  const VArraySpan<float3> directions_span(ray_directions);
+  Array<BVHTreeRayHit> hits(mask.min_array_size());
+  mask.foreach_index(GrainSize(4096), [&](const int i) {
+    hits[i].index = -1;
+    hits[i].dist = ray_lengths[i];
+  });
+  BLI_bvhtree_ray_cast_batch(*tree_data.tree,
+                             mask,
+                             origins_span,
+                             directions_span,
                              0.0f,
-                             &hit,
+                             hits,
                              tree_data.raycast_callback,
-                             &tree_data) != -1)
-    {
+                             &tree_data);
+
+  mask.foreach_index(GrainSize(4096), [&](const int i) {
+    const BVHTreeRayHit &hit = hits[i];
+    if (hit.index != -1) {
       if (!r_hit.is_empty()) {
         r_hit[i] = hit.index >= 0;
       }
@@ -180,7 +183,7 @@ static void raycast_to_mesh(const IndexMask &mask,
         r_hit_normals[i] = float3(0.0f, 0.0f, 0.0f);
       }
       if (!r_hit_distances.is_empty()) {
-        r_hit_distances[i] = ray_length;
+        r_hit_distances[i] = ray_lengths[i];
       }
     }
   });
@@ -226,6 +229,14 @@ class RaycastFunction : public mf::MultiFunction {
                     params.uninitialized_single_output_if_required<float3>(5, "Hit Normal"),
                     params.uninitialized_single_output_if_required<float>(6, "Distance"));
   }
+
+  ExecutionHints get_execution_hints() const override
+  {
+    ExecutionHints hints;
+    /* The results of the batched BVH queries are stored in an array indexed by the mask. */
+    hints.allocates_array = true;
+    return hints;
+  }
 };
 
 static void node_geo_exec(GeoNodeExecParams params)
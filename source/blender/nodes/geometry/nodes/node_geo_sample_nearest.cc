@@ -31,21 +31,24 @@ void get_closest_in_bvhtree(bke::BVHTreeFromMesh &tree_data,
   BLI_assert(positions.size() >= r_distances_sq.size());
   BLI_assert(positions.size() >= r_positions.size());
 
-  mask.foreach_index([&](const int i) {
-    BVHTreeNearest nearest;
-    nearest.index = -1;
-    nearest.dist_sq = FLT_MAX;
-    const float3 position = positions[i];
-    BLI_bvhtree_find_nearest(
-        tree_data.tree, position, &nearest, tree_data.nearest_callback, &tree_data);
+  const VArraySpan<float3> positions_span(positions);
+  Array<BVHTreeNearest> nearest(mask.min_array_size());
+  mask.foreach_index(GrainSize(4096), [&](const int i) {
+    nearest[i].index = -1;
+    nearest[i].dist_sq = FLT_MAX;
+  });
+  BLI_bvhtree_find_nearest_batch(
+      *tree_data.tree, mask, positions_span, nearest, tree_data.nearest_callback, &tree_data);
+
+  mask.foreach_index(GrainSize(4096), [&](const int i) {
     if (!r_indices.is_empty()) {
-      r_indices[i] = nearest.index;
+      r_indices[i] = nearest[i].index;
     }
     if (!r_distances_sq.is_empty()) {
-      r_distances_sq[i] = nearest.dist_sq;
+      r_distances_sq[i] = nearest[i].dist_sq;
     }
     if (!r_positions.is_empty()) {
-      r_positions[i] = nearest.co;
+      r_positions[i] = nearest[i].co;
     }
   });
 }
@@ -87,19 +90,23 @@ static void get_closest_pointcloud_points(const bke::BVHTreeFromPointCloud &tree
     return;
   }
 
-  mask.foreach_index([&](const int i) {
-    BVHTreeNearest nearest;
-    nearest.index = -1;
-    nearest.dist_sq = FLT_MAX;
-    const float3 position = positions[i];
-    BLI_bvhtree_find_nearest(tree_data.tree,
-                             position,
-                             &nearest,
-                             tree_data.nearest_callback,
-                             &const_cast<bke::BVHTreeFromPointCloud &>(tree_data));
-    r_indices[i] = nearest.index;
+  const VArraySpan<float3> positions_span(positions);
+  Array<BVHTreeNearest> nearest(mask.min_array_size());
+  mask.foreach_index(GrainSize(4096), [&](const int i) {
+    nearest[i].index = -1;
+    nearest[i].dist_sq = FLT_MAX;
+  });
+  BLI_bvhtree_find_nearest_batch(*tree_data.tree,
+                                 mask,
+                                 positions_span,
+                                 nearest,
+                                 tree_data.nearest_callback,
+                                 &const_cast<bke::BVHTreeFromPointCloud &>(tree_data));
+
+  mask.foreach_index(GrainSize(4096), [&](const int i) {
+    r_indices[i] = nearest[i].index;
     if (!r_distances_sq.is_empty()) {
-      r_distances_sq[i] = nearest.dist_sq;
+      r_distances_sq[i] = nearest[i].dist_sq;
     }
   });
 }
@@ -298,6 +305,14 @@ class SampleNearestFunction : public mf::MultiFunction {
         break;
     }
   }
+
+  ExecutionHints get_execution_hints() const override
+  {
+    ExecutionHints hints;
+    /* The results of the batched BVH queries are stored in an array indexed by the mask. */
+    hints.allocates_array = true;
+    return hints;
+  }
 };
 
 static void node_geo_exec(GeoNodeExecParams params)
@@ -148,39 +148,59 @@ class SampleNearestSurfaceFunction : public mf::MultiFunction {
     MutableSpan<bool> is_valid_span = params.uninitialized_single_output_if_required<bool>(
         4, "Is Valid");
 
-    mask.foreach_index([&](const int i) {
-      const float3 position = positions[i];
-      const int sample_id = sample_ids[i];
-      const int group_index = group_indices_.index_of_try(sample_id);
-      if (group_index == -1) {
-        triangle_index[i] = -1;
-        sample_position[i] = float3(0, 0, 0);
-        if (!is_valid_span.is_empty()) {
-          is_valid_span[i] = false;
-        }
-        return;
+    /* Sort the samples by their group, so that the samples of every group can be processed in
+     * one batch. Samples without group are put into the last mask. */
+    const int groups_num = bvh_trees_.size();
+    IndexMaskMemory memory;
+    Array<IndexMask> group_masks(groups_num + 1);
+    IndexMask::from_groups<int>(
+        mask,
+        memory,
+        [&](const int i) {
+          const int group_index = group_indices_.index_of_try(sample_ids[i]);
+          return group_index == -1 ? groups_num : group_index;
+        },
+        group_masks);
+
+    const VArraySpan<float3> positions_span(positions);
+    Array<BVHTreeNearest> nearest(mask.min_array_size());
+    mask.foreach_index(GrainSize(4096), [&](const int i) {
+      nearest[i].index = -1;
+      nearest[i].dist_sq = FLT_MAX;
+    });
+    for (const int group_index : IndexRange(groups_num)) {
+      if (group_masks[group_index].is_empty()) {
+        continue;
       }
       const bke::BVHTreeFromMesh &bvh = bvh_trees_[group_index];
-      BVHTreeNearest nearest;
-      nearest.dist_sq = FLT_MAX;
-      nearest.index = -1;
-      BLI_bvhtree_find_nearest(bvh.tree,
-                               position,
-                               &nearest,
-                               bvh.nearest_callback,
-                               const_cast<bke::BVHTreeFromMesh *>(&bvh));
-      triangle_index[i] = nearest.index;
-      sample_position[i] = nearest.co;
-      if (!is_valid_span.is_empty()) {
-        is_valid_span[i] = true;
-      }
+      BLI_bvhtree_find_nearest_batch(*bvh.tree,
+                                     group_masks[group_index],
+                                     positions_span,
+                                     nearest,
+                                     bvh.nearest_callback,
+                                     const_cast<bke::BVHTreeFromMesh *>(&bvh));
+    }
+
+    const IndexMask valid_mask = IndexMask::from_difference(mask, group_masks.last(), memory);
+    valid_mask.foreach_index(GrainSize(4096), [&](const int i) {
+      triangle_index[i] = nearest[i].index;
+      sample_position[i] = nearest[i].co;
     });
+    index_mask::masked_fill(triangle_index, -1, group_masks.last());
+    index_mask::masked_fill(sample_position, float3(0, 0, 0), group_masks.last());
+    if (!is_valid_span.is_empty()) {
+      index_mask::masked_fill(is_valid_span, true, valid_mask);
+      index_mask::masked_fill(is_valid_span, false, group_masks.last());
+    }
   }
 
   ExecutionHints get_execution_hints() const override
   {
     ExecutionHints hints;
-    hints.min_grain_size = 512;
+    /* The batched BVH queries are multi-threaded themselves and sort large enough batches
+     * spatially, so the default grain size is kept. The results are stored in an array indexed by
+     * the mask. */
+    hints.allocates_array = true;
     return hints;
   }
 };
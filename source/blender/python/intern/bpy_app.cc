@@ -37,6 +37,7 @@
 #include "bpy_app_icons.hh"
 #include "bpy_app_timers.hh"
 
+#include "BLI_task_statistics.hh"
 #include "BLI_utildefines.h"
 
 #include "BKE_appdir.hh"
@@ -545,6 +546,37 @@ static int bpy_app_binary_path_set(PyObject * /*self*/, PyObject *value, void *
   return 0;
 }
 
+PyDoc_STRVAR(
+    /* Wrap. */
+    bpy_app_use_task_statistics_doc,
+    "Boolean, record statistics about multi-threaded tasks, "
+    "see :func:`bpy.app.task_statistics` "
+    "(only available when Blender is built with ``WITH_TASK_STATISTICS``).\n"
+    "\n"
+    ":type: bool\n");
+static PyObject *bpy_app_use_task_statistics_get(PyObject * /*self*/, void * /*closure*/)
+{
+  return PyBool_FromLong(blender::threading::statistics::is_enabled());
+}
+
+static int bpy_app_use_task_statistics_set(PyObject * /*self*/,
+                                           PyObject *value,
+                                           void * /*closure*/)
+{
+  const int param = PyObject_IsTrue(value);
+  if (param == -1) {
+    PyErr_SetString(PyExc_TypeError, "bpy.app.use_task_statistics can only be True/False");
+    return -1;
+  }
+  if (param && !blender::threading::statistics::is_available()) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "bpy.app.use_task_statistics requires building with WITH_TASK_STATISTICS");
+    return -1;
+  }
+  blender::threading::statistics::set_enabled(param);
+  return 0;
+}
+
 static PyGetSetDef bpy_app_getsets[] = {
     {"debug", bpy_app_debug_get, bpy_app_debug_set, bpy_app_debug_doc, (void *)G_DEBUG},
     {"debug_freestyle",
@@ -674,6 +706,12 @@ static PyGetSetDef bpy_app_getsets[] = {
      bpy_app_binary_path_doc,
      nullptr},
 
+    {"use_task_statistics",
+     bpy_app_use_task_statistics_get,
+     bpy_app_use_task_statistics_set,
+     bpy_app_use_task_statistics_doc,
+     nullptr},
+
     {nullptr, nullptr, nullptr, nullptr, nullptr},
 };
 
@@ -781,6 +819,74 @@ static PyObject *bpy_app_memory_usage_undo(PyObject * /*self*/, PyObject * /*arg
   return PyLong_FromSize_t(total_memory);
 }
 
+PyDoc_STRVAR(
+    /* Wrap. */
+    bpy_app_task_statistics_doc,
+    ".. staticmethod:: task_statistics(*, reset=False)\n"
+    "\n"
+    "   Get the statistics recorded for every call site of multi-threaded tasks while\n"
+    "   :attr:`bpy.app.use_task_statistics` is enabled, sorted by decreasing wall time.\n"
+    "\n"
+    "   :arg reset: Remove the recorded statistics after getting them.\n"
+    "   :type reset: bool\n"
+    "   :return: One dictionary per call site, with the keys ``call_site``, ``type``, ``calls``,\n"
+    "      ``tasks``, ``elements``, ``grain_size_min``, ``grain_size_max``, ``nested_calls``,\n"
+    "      ``peak_concurrency``, ``wall_time``, ``busy_time`` and ``idle_time``,\n"
+    "      where times are in seconds.\n"
+    "   :rtype: list[dict[str, Any]]\n");
+static PyObject *bpy_app_task_statistics(PyObject * /*self*/, PyObject *args, PyObject *kwds)
+{
+  using namespace blender::threading;
+  bool reset = false;
+  static const char *_keywords[] = {"reset", nullptr};
+  static _PyArg_Parser _parser = {
+      PY_ARG_PARSER_HEAD_COMPAT()
+      "|$" /* Optional keyword only arguments. */
+      "O&" /* `reset` */
+      ":task_statistics",
+      _keywords,
+      nullptr,
+  };
+  if (!_PyArg_ParseTupleAndKeywordsFast(args, kwds, &_parser, PyC_ParseBool, &reset)) {
+    return nullptr;
+  }
+
+  const blender::Vector<statistics::CallSiteStatistics> all_statistics = statistics::get_all();
+  if (reset) {
+    statistics::reset();
+  }
+
+  const auto seconds = [](const blender::timeit::Nanoseconds duration) {
+    return PyFloat_FromDouble(duration.count() / 1.0e9);
+  };
+  PyObject *result = PyList_New(all_statistics.size());
+  for (const int64_t i : all_statistics.index_range()) {
+    const statistics::CallSiteStatistics &call_site = all_statistics[i];
+    PyObject *item = PyDict_New();
+    const auto set_item = [&](const char *key, PyObject *value) {
+      PyDict_SetItemString(item, key, value);
+      Py_DECREF(value);
+    };
+    set_item("call_site", PyUnicode_FromString(call_site.name.c_str()));
+    set_item("type",
+             PyUnicode_FromString(call_site.type == statistics::CallSiteType::TaskPool ?
+                                      "TASK_POOL" :
+                                      "PARALLEL_FOR"));
+    set_item("calls", PyLong_FromLongLong(call_site.calls));
+    set_item("tasks", PyLong_FromLongLong(call_site.tasks));
+    set_item("elements", PyLong_FromLongLong(call_site.elements));
+    set_item("grain_size_min", PyLong_FromLongLong(call_site.grain_size_min));
+    set_item("grain_size_max", PyLong_FromLongLong(call_site.grain_size_max));
+    set_item("nested_calls", PyLong_FromLongLong(call_site.nested_calls));
+    set_item("peak_concurrency", PyLong_FromLong(call_site.peak_concurrency));
+    set_item("wall_time", seconds(call_site.wall_time));
+    set_item("busy_time", seconds(call_site.busy_time));
+    set_item("idle_time", seconds(call_site.idle_time));
+    PyList_SET_ITEM(result, i, item);
+  }
+  return result;
+}
+
 static PyMethodDef bpy_app_methods[] = {
     {"is_job_running",
      (PyCFunction)bpy_app_is_job_running,
@@ -794,6 +900,10 @@ static PyMethodDef bpy_app_methods[] = {
      (PyCFunction)bpy_app_memory_usage_undo,
      METH_NOARGS | METH_STATIC,
      bpy_app_memory_usage_undo_doc},
+    {"task_statistics",
+     (PyCFunction)bpy_app_task_statistics,
+     METH_VARARGS | METH_KEYWORDS | METH_STATIC,
+     bpy_app_task_statistics_doc},
     {nullptr, nullptr, 0, nullptr},
 };
 
@@ -28,6 +28,7 @@ void bpy_app_generic_callback(Main *main,
                               PointerRNA **pointers,
                               const int pointers_num,
                               void *arg);
+static bool bpy_app_generic_callback_is_used(void *arg);
 
 static PyTypeObject BlenderAppCbType;
 
@@ -304,6 +305,7 @@ PyObject *BPY_app_handlers_struct()
       funcstore->func = bpy_app_generic_callback;
       funcstore->alloc = 0;
       funcstore->arg = POINTER_FROM_INT(pos);
+      funcstore->is_used = bpy_app_generic_callback_is_used;
       BKE_callback_add(funcstore, eCbEvent(pos));
     }
   }
@@ -373,6 +375,12 @@ static PyObject *choose_arguments(PyObject *func, PyObject *args_all, PyObject *
   return args_all;
 }
 
+static bool bpy_app_generic_callback_is_used(void *arg)
+{
+  PyObject *cb_list = py_cb_array[POINTER_AS_INT(arg)];
+  return PyList_GET_SIZE(cb_list) > 0;
+}
+
 /* the actual callback - not necessarily called from py */
 void bpy_app_generic_callback(Main * /*main*/,
                               PointerRNA **pointers,
@@ -26,6 +26,8 @@
  * because 'near' is disabled through `BLI_windstuff.h`. */
 #  include "BLI_winstuff.h"
 #  include <shlobj.h>
+#else
+#  include <csignal> /* For #kill. */
 #endif
 
 #include <fmt/format.h>
@@ -47,6 +49,7 @@
 #include "BLI_time.h"
 #include "BLI_timer.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 #include BLI_SYSTEM_PID_H
 
 #include "BLO_core_blend_header.hh"
@@ -2284,6 +2287,244 @@ static void wm_autosave_location(char filepath[FILE_MAX])
   BLI_path_join(filepath, FILE_MAX, tempdir_base, filename);
 }
 
+/** Extension added to the auto-save file path for the incremental auto-save journal. */
+#define AUTOSAVE_JOURNAL_EXT ".journal"
+/**
+ * Extension added to the journal file path for the file storing the process ID of the session
+ * writing the journal, see #wm_autosave_journal_owner_is_running.
+ */
+#define AUTOSAVE_JOURNAL_OWNER_EXT ".pid"
+
+/** Journal of the incremental auto-save, see #BLO_journal_write. */
+static BlendFileJournal *wm_autosave_journal = nullptr;
+
+static void wm_autosave_journal_free()
+{
+  if (wm_autosave_journal) {
+    BLO_journal_free(wm_autosave_journal);
+    wm_autosave_journal = nullptr;
+  }
+}
+
+static void wm_autosave_journal_owner_write(const char *journal_filepath)
+{
+  char owner_filepath[FILE_MAX];
+  SNPRINTF(owner_filepath, "%s" AUTOSAVE_JOURNAL_OWNER_EXT, journal_filepath);
+  FILE *file = BLI_fopen(owner_filepath, "w");
+  if (file == nullptr) {
+    CLOG_ERROR(&LOG, "Failed to write auto-save journal owner \"%s\"", owner_filepath);
+    return;
+  }
+  fprintf(file, "%d\n", int(getpid()));
+  fclose(file);
+}
+
+/**
+ * True when the session that wrote the journal is still running, so the journal must not be
+ * touched. This may also be true for crashed sessions when their process ID has been reused,
+ * those journals are only restored once that process has exited as well.
+ */
+static bool wm_autosave_journal_owner_is_running(const char *journal_filepath)
+{
+  char owner_filepath[FILE_MAX];
+  SNPRINTF(owner_filepath, "%s" AUTOSAVE_JOURNAL_OWNER_EXT, journal_filepath);
+  FILE *file = BLI_fopen(owner_filepath, "r");
+  if (file == nullptr) {
+    return false;
+  }
+  int pid = 0;
+  const bool has_pid = fscanf(file, "%d", &pid) == 1 && pid > 0;
+  fclose(file);
+  if (!has_pid) {
+    return false;
+  }
+  if (pid == int(getpid())) {
+    return true;
+  }
+#ifdef WIN32
+  HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, DWORD(pid));
+  if (process == nullptr) {
+    return false;
+  }
+  const bool is_running = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+  CloseHandle(process);
+  return is_running;
+#else
+  /* The process exists when it can be signaled, even if only the permission is missing. */
+  return kill(pid_t(pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+static void wm_autosave_journal_write(Main *bmain, const char *filepath, const int fileflags)
+{
+  char journal_filepath[FILE_MAX];
+  SNPRINTF(journal_filepath, "%s" AUTOSAVE_JOURNAL_EXT, filepath);
+
+  /* The auto-save location depends on the file name. */
+  if (wm_autosave_journal && !STREQ(BLO_journal_filepath(wm_autosave_journal), journal_filepath))
+  {
+    wm_autosave_journal_free();
+  }
+  if (wm_autosave_journal == nullptr) {
+    /* Written before the journal, so a journal without owner was not written by a running
+     * session. */
+    wm_autosave_journal_owner_write(journal_filepath);
+    wm_autosave_journal = BLO_journal_new(journal_filepath);
+  }
+
+  switch (BLO_journal_write(wm_autosave_journal, bmain, fileflags)) {
+    case BlendFileJournalWriteResult::Queued:
+      break;
+    case BlendFileJournalWriteResult::Busy:
+      CLOG_WARN(&LOG, "Skipping auto-save, the previous one is still being written");
+      break;
+    case BlendFileJournalWriteResult::Error:
+      CLOG_ERROR(&LOG, "Failed to write auto-save journal \"%s\"", journal_filepath);
+      break;
+  }
+}
+
+/**
+ * Turn the journal of an incremental auto-save into a regular blend-file at \a filepath, if it is
+ * more recent than the file.
+ */
+static void wm_autosave_journal_restore(const char *filepath, ReportList *reports)
+{
+  char journal_filepath[FILE_MAX];
+  SNPRINTF(journal_filepath, "%s" AUTOSAVE_JOURNAL_EXT, filepath);
+  if (!BLI_exists(journal_filepath)) {
+    return;
+  }
+  if (BLI_exists(filepath) && !BLI_file_older(filepath, journal_filepath)) {
+    return;
+  }
+  if (wm_autosave_journal && STREQ(BLO_journal_filepath(wm_autosave_journal), journal_filepath)) {
+    /* Make sure a pending write is finished. */
+    wm_autosave_journal_free();
+  }
+  BLO_journal_restore(journal_filepath, filepath, reports);
+}
+
+/**
+ * Find the journals left behind by sessions that are not running anymore (e.g. after a crash) in
+ * the auto-save directory, which are more recent than their blend-file.
+ *
+ * \return The auto-save file paths the journals belong to.
+ */
+static blender::Vector<std::string> wm_autosave_journal_find_orphaned()
+{
+  blender::Vector<std::string> filepaths;
+  const char *tempdir_base = BKE_tempdir_base();
+  direntry *entries = nullptr;
+  const uint entries_num = BLI_filelist_dir_contents(tempdir_base, &entries);
+  for (uint i = 0; i < entries_num; i++) {
+    const direntry &entry = entries[i];
+    if (!S_ISREG(entry.s.st_mode) ||
+        !BLI_str_endswith(entry.relname, ".blend" AUTOSAVE_JOURNAL_EXT))
+    {
+      continue;
+    }
+    if (wm_autosave_journal &&
+        BLI_path_cmp(BLO_journal_filepath(wm_autosave_journal), entry.path) == 0)
+    {
+      /* The journal of this session is still in use. */
+      continue;
+    }
+    if (wm_autosave_journal_owner_is_running(entry.path)) {
+      continue;
+    }
+    char filepath[FILE_MAX];
+    STRNCPY(filepath, entry.path);
+    filepath[strlen(filepath) - strlen(AUTOSAVE_JOURNAL_EXT)] = '\0';
+    if (BLI_exists(filepath) && !BLI_file_older(filepath, entry.path)) {
+      continue;
+    }
+    filepaths.append(filepath);
+  }
+  BLI_filelist_free(entries, entries_num);
+  return filepaths;
+}
+
+struct AutoSaveJournalRestoreJob {
+  wmWindowManager *wm;
+  /** Auto-save file paths to restore from their journals. */
+  blender::Vector<std::string> filepaths;
+};
+
+static void wm_autosave_journal_restore_startjob(void *customdata,
+                                                 wmJobWorkerStatus *worker_status)
+{
+  AutoSaveJournalRestoreJob &job = *static_cast<AutoSaveJournalRestoreJob *>(customdata);
+  for (const int64_t i : job.filepaths.index_range()) {
+    if (worker_status->stop) {
+      break;
+    }
+    const std::string &filepath = job.filepaths[i];
+    const std::string journal_filepath = filepath + AUTOSAVE_JOURNAL_EXT;
+    BLO_journal_restore(journal_filepath.c_str(), filepath.c_str(), worker_status->reports);
+    worker_status->progress = float(i + 1) / float(job.filepaths.size());
+    worker_status->do_update = true;
+  }
+}
+
+static void wm_autosave_journal_restore_endjob(void *customdata)
+{
+  AutoSaveJournalRestoreJob &job = *static_cast<AutoSaveJournalRestoreJob *>(customdata);
+  /* Show the restored files in file browsers that are already showing the auto-save directory. */
+  LISTBASE_FOREACH (const wmWindow *, win, &job.wm->windows) {
+    const bScreen *screen = WM_window_get_active_screen(win);
+    LISTBASE_FOREACH (const ScrArea *, area, &screen->areabase) {
+      if (area->spacetype != SPACE_FILE) {
+        continue;
+      }
+      SpaceFile *sfile = static_cast<SpaceFile *>(area->spacedata.first);
+      const FileSelectParams *params = ED_fileselect_get_active_params(sfile);
+      if (sfile->browse_mode == FILE_BROWSE_MODE_FILES && params &&
+          BLI_path_cmp(params->dir, BKE_tempdir_base()) == 0)
+      {
+        ED_fileselect_clear(job.wm, sfile);
+      }
+    }
+  }
+  WM_main_add_notifier(NC_SPACE | ND_SPACE_FILE_LIST, nullptr);
+}
+
+static void wm_autosave_journal_restore_freejob(void *customdata)
+{
+  MEM_delete(static_cast<AutoSaveJournalRestoreJob *>(customdata));
+}
+
+/**
+ * Restore the journals left behind by other sessions in a job, so that they show up as regular
+ * blend-files when browsing for auto-saves.
+ */
+static void wm_autosave_journal_restore_orphaned_job_start(bContext *C)
+{
+  blender::Vector<std::string> filepaths = wm_autosave_journal_find_orphaned();
+  if (filepaths.is_empty()) {
+    return;
+  }
+  wmWindowManager *wm = CTX_wm_manager(C);
+  AutoSaveJournalRestoreJob *job = MEM_new<AutoSaveJournalRestoreJob>(__func__);
+  job->wm = wm;
+  job->filepaths = std::move(filepaths);
+
+  wmJob *wm_job = WM_jobs_get(wm,
+                              CTX_wm_window(C),
+                              wm,
+                              "Restoring auto-saves...",
+                              WM_JOB_PROGRESS,
+                              WM_JOB_TYPE_AUTOSAVE_RESTORE);
+  WM_jobs_customdata_set(wm_job, job, wm_autosave_journal_restore_freejob);
+  WM_jobs_timer(wm_job, 0.1, 0, 0);
+  WM_jobs_callbacks(wm_job,
+                    wm_autosave_journal_restore_startjob,
+                    nullptr,
+                    nullptr,
+                    wm_autosave_journal_restore_endjob);
+  WM_jobs_start(wm, wm_job);
+}
+
 static bool wm_autosave_write_try(Main *bmain, wmWindowManager *wm)
 {
   if (wm->file_saved) {
@@ -2325,9 +2566,15 @@ void WM_autosave_write(wmWindowManager *wm, Main *bmain)
    */
   const int fileflags = G.fileflags | G_FILE_RECOVER_WRITE | G_FILE_COMPRESS;
 
-  /* Error reporting into console. */
-  BlendFileWriteParams params{};
-  BLO_write_file(bmain, filepath, fileflags, &params, nullptr);
+  if (USER_EXPERIMENTAL_TEST(&U, use_autosave_journal)) {
+    /* Compression is done per chunk by the journal. */
+    wm_autosave_journal_write(bmain, filepath, fileflags & ~G_FILE_COMPRESS);
+  }
+  else {
+    /* Error reporting into console. */
+    BlendFileWriteParams params{};
+    BLO_write_file(bmain, filepath, fileflags, &params, nullptr);
+  }
 
   /* Restart auto-save timer. */
   wm_autosave_timer_end(wm);
@@ -2395,6 +2642,22 @@ void wm_autosave_delete()
 
   wm_autosave_location(filepath);
 
+  wm_autosave_journal_free();
+  char journal_filepath[FILE_MAX];
+  SNPRINTF(journal_filepath, "%s" AUTOSAVE_JOURNAL_EXT, filepath);
+  if (BLI_exists(journal_filepath)) {
+    /* Keep the latest state as regular file when it is moved to the quit file below. */
+    if ((U.uiflag & USER_GLOBALUNDO) == 0) {
+      wm_autosave_journal_restore(filepath, nullptr);
+    }
+    BLI_delete(journal_filepath, false, false);
+  }
+  char owner_filepath[FILE_MAX];
+  SNPRINTF(owner_filepath, "%s" AUTOSAVE_JOURNAL_OWNER_EXT, journal_filepath);
+  if (BLI_exists(owner_filepath)) {
+    BLI_delete(owner_filepath, false, false);
+  }
+
   if (BLI_exists(filepath)) {
     char filepath_quit[FILE_MAX];
     BLI_path_join(filepath_quit, sizeof(filepath_quit), BKE_tempdir_base(), BLENDER_QUIT_FILE);
@@ -3529,6 +3792,11 @@ static wmOperatorStatus wm_recover_auto_save_exec(bContext *C, wmOperator *op)
   const bool use_scripts_autoexec_check = wm_open_init_use_scripts(op, true);
   SET_FLAG_FROM_TEST(G.f, RNA_boolean_get(op->ptr, "use_scripts"), G_FLAG_SCRIPT_AUTOEXEC);
 
+  /* Incremental auto-saves are stored in a journal next to the file. Wait for the restore of
+   * orphaned journals, which may be writing the same file. */
+  WM_jobs_kill_type(CTX_wm_manager(C), CTX_wm_manager(C), WM_JOB_TYPE_AUTOSAVE_RESTORE);
+  wm_autosave_journal_restore(filepath, op->reports);
+
   G.fileflags |= G_FILE_RECOVER_READ;
 
   success = wm_file_read_opwrap(C, filepath, use_scripts_autoexec_check, op->reports);
@@ -3558,6 +3826,11 @@ static wmOperatorStatus wm_recover_auto_save_invoke(bContext *C,
   RNA_string_set(op->ptr, "filepath", filepath);
   const bool use_scripts_autoexec_check = wm_open_init_use_scripts(op, true);
   UNUSED_VARS(use_scripts_autoexec_check); /* The user can set this in the UI. */
+
+  /* Incremental auto-saves of crashed sessions only exist as journals, which the file browser
+   * can't show. */
+  wm_autosave_journal_restore_orphaned_job_start(C);
+
   WM_event_add_fileselect(C, op);
 
   return OPERATOR_RUNNING_MODAL;
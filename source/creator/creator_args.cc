@@ -28,6 +28,7 @@
 #  include "BLI_string.h"
 #  include "BLI_string_utf8.h"
 #  include "BLI_system.h"
+#  include "BLI_task_statistics.hh"
 #  include "BLI_threads.h"
 #  include "BLI_utildefines.h"
 #  ifndef NDEBUG
@@ -70,6 +71,7 @@
 #  endif
 
 #  include "DEG_depsgraph.hh"
+#  include "DEG_depsgraph_debug.hh"
 
 #  include "WM_types.hh"
 
@@ -757,6 +759,8 @@ static void print_help(bArgs *ba, bool all)
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-time");
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-pretty");
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-uid");
+  BLI_args_print_arg_doc(ba, "--debug-depsgraph-trace");
+  BLI_args_print_arg_doc(ba, "--debug-threads-stats");
   BLI_args_print_arg_doc(ba, "--debug-ghost");
   BLI_args_print_arg_doc(ba, "--debug-wintab");
   BLI_args_print_arg_doc(ba, "--debug-gpu");
@@ -1422,6 +1426,56 @@ static int arg_handle_debug_mode_generic_set(int /*argc*/, const char ** /*argv*
   return 0;
 }
 
+static void callback_debug_depsgraph_trace_atexit(void * /*user_data*/)
+{
+  DEG_debug_trace_end();
+}
+
+static const char arg_handle_debug_depsgraph_trace_set_doc[] =
+    "<filepath>\n"
+    "\tRecord the evaluation timeline of dependency graph operations,\n"
+    "\twritten to the file in the Chrome trace format (JSON) on exit.";
+static int arg_handle_debug_depsgraph_trace_set(int argc, const char **argv, void * /*data*/)
+{
+  const char *arg_id = "--debug-depsgraph-trace";
+  if (argc > 1) {
+    if (!DEG_debug_trace_is_enabled()) {
+      BKE_blender_atexit_register(callback_debug_depsgraph_trace_atexit, nullptr);
+    }
+    DEG_debug_trace_begin(argv[1]);
+    return 1;
+  }
+  fprintf(stderr, "\nError: '%s' no args given.\n", arg_id);
+  return 0;
+}
+
+static void callback_debug_threads_stats_atexit(void * /*user_data*/)
+{
+  blender::threading::statistics::print();
+}
+
+static const char arg_handle_debug_threads_stats_set_doc[] =
+    "\n\t"
+    "Record how multi-threaded tasks are split up and how long they take for every call site,\n"
+    "\tprinted on exit. Only available when built with WITH_TASK_STATISTICS.";
+static int arg_handle_debug_threads_stats_set(int /*argc*/,
+                                              const char ** /*argv*/,
+                                              void * /*data*/)
+{
+  namespace statistics = blender::threading::statistics;
+  if (!statistics::is_available()) {
+    fprintf(stderr,
+            "\nWarning: '--debug-threads-stats' has no effect, "
+            "built without WITH_TASK_STATISTICS.\n");
+    return 0;
+  }
+  if (!statistics::is_enabled()) {
+    BKE_blender_atexit_register(callback_debug_threads_stats_atexit, nullptr);
+    statistics::set_enabled(true);
+  }
+  return 0;
+}
+
 static const char arg_handle_debug_mode_io_doc[] =
     "\n\t"
     "Enable debug messages for I/O.";
@@ -3085,6 +3139,10 @@ void main_args_setup(bContext *C, bArgs *ba, bool all)
                "--debug-depsgraph-uid",
                CB_EX(arg_handle_debug_mode_generic_set, depsgraph_uid),
                (void *)G_DEBUG_DEPSGRAPH_UID);
+  BLI_args_add(
+      ba, nullptr, "--debug-depsgraph-trace", CB(arg_handle_debug_depsgraph_trace_set), nullptr);
+  BLI_args_add(
+      ba, nullptr, "--debug-threads-stats", CB(arg_handle_debug_threads_stats_set), nullptr);
   BLI_args_add(ba,
                nullptr,
                "--debug-gpu-force-workarounds",